@@ -0,0 +1,53 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "../integration/tadaptive.hpp"
+
+/*
+ * Adaptive Gauss-Kronrod integration of a costly oscillating integrand with a square-root kink, over the thread
+ * counts and in both scheduling modes. Prints the time, the work counters and how the intervals were spread over
+ * the workers.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+/** sqrt|x - 0.3| + sum_k sin(k*x)/k^2, 64 terms, so one call costs about as much as a small model evaluation */
+double integrand(const double x)
+{
+	double s = std::sqrt(std::abs(x - 0.3));
+	for (int k = 1; k <= 64; ++k)
+		s += std::sin(double(k) * x) / double(k * k);
+	return s;
+}
+
+int main()
+{
+	std::cout << std::setprecision(17);
+	for (unsigned int points : { 7u, 10u })
+		for (bool deterministic : { false, true })
+		{
+			std::cout << "G" << points << "K" << (2 * points + 1) << (deterministic ? ", deterministic" : ", free running") << "\n";
+			for (unsigned int threads : { 1u, 2u, 4u, 0u })
+			{
+				adaptive_options opts;
+				opts.points = points;
+				opts.threads = threads;
+				opts.deterministic = deterministic;
+				opts.abs_tolerance = 1e-12;
+				opts.rel_tolerance = 0.0;
+				bench_clock::time_point t0 = bench_clock::now();
+				const adaptive_result<double> r = integrate_adaptive(integrand, 0.0, 20.0, opts);
+				const double dt = std::chrono::duration<double>(bench_clock::now() - t0).count();
+				std::cout << std::setw(4) << r.threads.size() << " threads  " << r.value << std::setprecision(3) << "  error " << r.error
+					<< "  " << dt * 1e3 << " ms  " << r.evaluations << " calls  " << r.subdivisions << " splits  load";
+				for (const adaptive_thread_stats& s : r.threads)
+					std::cout << " " << s.intervals << "/" << s.steals;
+				std::cout << std::setprecision(17) << "\n";
+			}
+		}
+	std::cout << "(load: intervals evaluated / of which stolen, per worker)\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "../interpolation/tbarycentric.hpp"
+
+/*
+ * Barycentric interpolation of the Runge function 1/(1+25t^2) on Chebyshev points of the second kind in [-1,1], up to
+ * tens of thousands of nodes: the time to set up the weights with assign() and with add_node() one node at a time
+ * (in bit-reversed order), and the largest error of both interpolants on a fine grid. The raw weight products leave the range of double from
+ * about a thousand nodes on; the error has to keep falling to the level of rounding instead of turning into NaN.
+ * Then interpolate_lagrange() on nodes scaled to [-L,L] for L far from 1, where the raw weight or node products of 30
+ * nodes already over- or underflow: the relative error of the monomial interpolant of exp(t/L). Its coefficients
+ * scale like L^-k, so L is kept where they still fit into a double.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+double runge(const double t)
+{
+	return 1.0 / (1.0 + 25.0 * t * t);
+}
+
+std::vector<double> chebyshev_points(const std::size_t n, const double half_width)
+{
+	std::vector<double> x(n);
+	for (std::size_t j = 0; j < n; ++j)
+		x[j] = half_width * std::cos(3.141592653589793 * double(j) / double(n - 1));
+	return x;
+}
+
+/** largest |p(t) - runge(t)| on a grid of 10007 points, or NaN if any value is not finite */
+double grid_error(const barycentricd& p)
+{
+	const std::size_t m = 10007;
+	std::vector<double> ts(m), ys;
+	for (std::size_t k = 0; k < m; ++k)
+		ts[k] = -1.0 + 2.0 * double(k) / double(m - 1);
+	ys = p.evaluate(ts);
+	double err = 0.0;
+	for (std::size_t k = 0; k < m; ++k)
+	{
+		if (!std::isfinite(ys[k]))
+			return NAN;
+		err = std::max(err, std::abs(ys[k] - runge(ts[k])));
+	}
+	return err;
+}
+
+void runge_nodes(const std::size_t n)
+{
+	const std::vector<double> x = chebyshev_points(n, 1.0);
+	// add_node() takes the nodes in bit-reversed order of their indices, so that every intermediate set is spread out
+	std::size_t bits = 0;
+	while ((std::size_t(1) << bits) < n)
+		++bits;
+	std::vector<std::size_t> order;
+	for (std::size_t k = 0; k < (std::size_t(1) << bits); ++k)
+	{
+		std::size_t r = 0;
+		for (std::size_t b = 0; b < bits; ++b)
+			r |= ((k >> b) & 1) << (bits - 1 - b);
+		if (r < n)
+			order.push_back(r);
+	}
+	std::vector<double> y(n);
+	for (std::size_t j = 0; j < n; ++j)
+		y[j] = runge(x[j]);
+	bench_clock::time_point t0 = bench_clock::now();
+	barycentricd a(x, y);
+	const double ta = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e3;
+	t0 = bench_clock::now();
+	barycentricd b;
+	b.reserve(n);
+	for (std::size_t k = 0; k < order.size(); ++k)
+		b.add_node(x[order[k]], y[order[k]]);
+	const double tb = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e3;
+	std::cout << std::setw(8) << n << std::setw(14) << ta << std::setw(14) << grid_error(a) << std::setw(14) << tb << std::setw(14) << grid_error(b) << "\n";
+}
+
+void lagrange_scaled(const double half_width)
+{
+	const std::size_t n = 30;
+	const std::vector<double> x = chebyshev_points(n, half_width);
+	std::vector<double> y(n);
+	for (std::size_t j = 0; j < n; ++j)
+		y[j] = std::exp(x[j] / half_width);
+	Polynomial<double> p;
+	interpolate_lagrange(x.data(), y.data(), n, &p);
+	double err = 0.0;
+	for (std::size_t k = 0; k <= 1000; ++k)
+	{
+		const double t = half_width * (-1.0 + 2.0 * double(k) / 1000.0);
+		const double v = p(t);
+		err = (std::isfinite(v)) ? (std::max(err, std::abs(v - std::exp(t / half_width)) / std::exp(t / half_width))) : (NAN);
+		if (std::isnan(err))
+			break;
+	}
+	std::cout << std::setw(8) << half_width << std::setw(14) << err << "\n";
+}
+
+int main()
+{
+	std::cout << std::setprecision(3);
+	std::cout << "Runge function, Chebyshev points in [-1,1]\n";
+	std::cout << std::setw(8) << "nodes" << std::setw(14) << "assign ms" << std::setw(14) << "error" << std::setw(14) << "add_node ms" << std::setw(14) << "error" << "\n";
+	for (std::size_t n : { 100, 500, 1000, 2000, 5000, 20000 })
+		runge_nodes(n);
+	std::cout << "\ninterpolate_lagrange, 30 Chebyshev points in [-L,L], exp(t/L)\n";
+	std::cout << std::setw(8) << "L" << std::setw(14) << "rel. error" << "\n";
+	for (double L : { 1.0, 1e6, 1e12, 1e-6, 1e-9 })
+		lagrange_scaled(L);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,298 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <random>
+
+#include "../util/tpolynomial.hpp"
+#include "../util/tdoubledouble.hpp"
+#include "../util/tcomplex.hpp"
+#include "../roots/tmuller.hpp"
+
+/*
+ * Compensated Horner against plain Horner and Horner in DoubleDouble:
+ *  - (x-1)^DEGREE in expanded form (exact coefficients) at points in bands of distance from 1; the condition number
+ *    is ((1+|x|)/|1-x|)^DEGREE. Time per point of the batched kernels, the largest relative error against a
+ *    quad-double evaluation (capped at 1), and how close the a-posteriori bound comes to the actual error (largest
+ *    and median ratio; it must never be above 1).
+ *  - the same for the first derivative, and for complex points on a circle around 1.
+ *  - the bound of the compensated derivative on random polynomials: random coefficients at random points, and
+ *    products of (x - r) for clustered r at points among the roots, where p' is badly conditioned. The reference
+ *    runs both Horner chains in quad-double on the same coefficients.
+ *  - Muller's method on the Wilkinson polynomial, stopping at a fixed |f| < 1e-10 or at the compensated bound.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+const int DEGREE = 16;
+const unsigned int POINTS = 4096;
+
+template <typename _fn> double time_per_point(_fn&& fn, const unsigned int rounds)
+{
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		fn();
+	return std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / (double(rounds) * double(POINTS));
+}
+
+QuadDouble reference(const std::vector<double>& c, const double x)
+{
+	QuadDouble y(c.back());
+	for (std::size_t i = c.size() - 1; i-- > 0;)
+		y = y * x + c[i];
+	return y;
+}
+
+/** largest relative error, and the largest and median ratio of actual error to bound */
+void report(const std::string& name, const double t, const std::vector<double>& ys, const std::vector<QuadDouble>& ref, const std::vector<double>* bounds)
+{
+	double worst = 0.0;
+	std::vector<double> ratio;
+	unsigned int violations = 0;
+	for (std::size_t k = 0; k < ys.size(); ++k)
+	{
+		const double err = std::abs((QuadDouble(ys[k]) - ref[k])[0]);
+		worst = std::max(worst, std::min(1.0, err / std::abs(ref[k][0])));
+		if (bounds)
+		{
+			ratio.push_back(((*bounds)[k] > 0.0) ? (err / (*bounds)[k]) : ((err > 0.0) ? (1e300) : (0.0)));
+			violations += (err > (*bounds)[k]);
+		}
+	}
+	std::cout << std::setw(26) << name << std::setw(12) << t << std::setw(12) << worst;
+	if (bounds)
+	{
+		std::sort(ratio.begin(), ratio.end());
+		std::cout << std::setw(12) << ratio.back() << std::setw(12) << ratio[ratio.size() / 2] << std::setw(8) << violations;
+	}
+	std::cout << "\n";
+}
+
+/** POINTS points with lo <= |x - 1| <= hi, alternating on both sides */
+double band_point(const unsigned int k, const double lo, const double hi)
+{
+	const double d = lo + (hi - lo) * (double(k / 2) + 0.5) / double(POINTS / 2);
+	return (k % 2 == 0) ? (1.0 - d) : (1.0 + d);
+}
+
+void values(const Polynomial<double>& p, const std::vector<double>& coef, const double lo, const double hi)
+{
+	std::vector<double> xs(POINTS), ys(POINTS), bounds(POINTS);
+	std::vector<QuadDouble> ref(POINTS);
+	for (unsigned int k = 0; k < POINTS; ++k)
+	{
+		xs[k] = band_point(k, lo, hi);
+		ref[k] = reference(coef, xs[k]);
+	}
+	std::cout << "p(x) for " << lo << " <= |x - 1| <= " << hi << "\n";
+	double t = time_per_point([&]() { p.evaluate(xs.data(), ys.data(), POINTS); }, 2000);
+	report("Horner (vector)", t, ys, ref, nullptr);
+	t = time_per_point([&]() { polyeval::compensated_horner(coef.data(), coef.size(), xs.data(), ys.data(), POINTS, bounds.data()); }, 500);
+	report("compensated (scalar)", t, ys, ref, &bounds);
+#ifdef _FHP_POLYEVAL_SIMD_
+	t = time_per_point([&]() { polyeval::compensated_horner_simd(coef.data(), coef.size(), xs.data(), ys.data(), POINTS, bounds.data()); }, 500);
+	report("compensated (vector)", t, ys, ref, &bounds);
+	t = time_per_point([&]() { polyeval::compensated_horner_simd(coef.data(), coef.size(), xs.data(), ys.data(), POINTS); }, 500);
+	report("  without the bound", t, ys, ref, nullptr);
+#endif
+	{
+		std::vector<DoubleDouble> cdd(coef.begin(), coef.end()), ydd(POINTS);
+		t = time_per_point([&]()
+		{
+			for (unsigned int k = 0; k < POINTS; ++k)
+			{
+				DoubleDouble y(cdd.back());
+				for (std::size_t i = cdd.size() - 1; i-- > 0;)
+					y = y * xs[k] + cdd[i];
+				ydd[k] = y;
+			}
+		}, 100);
+		for (unsigned int k = 0; k < POINTS; ++k)
+			ys[k] = ydd[k].to_double();
+		report("DoubleDouble Horner", t, ys, ref, nullptr);
+	}
+}
+
+void derivatives(const Polynomial<double>& p, const std::vector<double>& coef, const double lo, const double hi)
+{
+	std::vector<double> dcoef;
+	for (std::size_t i = 1; i < coef.size(); ++i)
+		dcoef.push_back(double(i) * coef[i]);
+	std::vector<double> xs(POINTS), ys(POINTS), bounds(POINTS);
+	std::vector<QuadDouble> ref(POINTS);
+	for (unsigned int k = 0; k < POINTS; ++k)
+	{
+		xs[k] = band_point(k, lo, hi);
+		ref[k] = reference(dcoef, xs[k]);
+	}
+	std::cout << "p'(x) for " << lo << " <= |x - 1| <= " << hi << "\n";
+	double t = time_per_point([&]() { for (unsigned int k = 0; k < POINTS; ++k) ys[k] = p.derivativeAt(xs[k]); }, 500);
+	report("derivativeAt", t, ys, ref, nullptr);
+	t = time_per_point([&]() { for (unsigned int k = 0; k < POINTS; ++k) ys[k] = p.compensatedDerivativeAt(xs[k], &bounds[k]); }, 200);
+	report("compensatedDerivativeAt", t, ys, ref, &bounds);
+}
+
+/** p'(x) in quad-double: s = s*x + c and d = d*x + s */
+QuadDouble reference_derivative(const std::vector<double>& c, const double x)
+{
+	QuadDouble s(c.back()), d(0.0);
+	for (std::size_t i = c.size() - 1; i-- > 0;)
+	{
+		d = d * x + s;
+		s = s * x + c[i];
+	}
+	return d;
+}
+
+void random_derivatives(const bool clustered, const unsigned int trials)
+{
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	std::uniform_int_distribution<int> degree(2, 40);
+	std::vector<double> ratio;
+	unsigned int violations = 0;
+	for (unsigned int k = 0; k < trials; ++k)
+	{
+		const int n = degree(gen);
+		std::vector<double> coef(n + 1);
+		double x;
+		if (clustered)
+		{
+			// roots in [0.9, 1.1], the product expanded in double; x next to one of them
+			std::vector<double> roots(n);
+			for (double& r : roots)
+				r = 1.0 + 0.1 * dist(gen);
+			coef.assign(1, 1.0);
+			for (const double r : roots)
+			{
+				coef.push_back(0.0);
+				for (std::size_t i = coef.size() - 1; i > 0; --i)
+					coef[i] = coef[i - 1] - r * coef[i];
+				coef[0] = -r * coef[0];
+			}
+			x = roots[k % n] * (1.0 + 1e-6 * dist(gen));
+		}
+		else
+		{
+			for (double& c : coef)
+				c = dist(gen);
+			x = 2.0 * dist(gen);
+		}
+		double bound;
+		const double r = polyeval::compensated_horner_derivative(coef.data(), coef.size(), x, &bound);
+		const double err = std::abs((QuadDouble(r) - reference_derivative(coef, x))[0]);
+		ratio.push_back((bound > 0.0) ? (err / bound) : ((err > 0.0) ? (1e300) : (0.0)));
+		violations += (err > bound);
+	}
+	std::sort(ratio.begin(), ratio.end());
+	std::cout << std::setw(26) << ((clustered) ? ("clustered roots") : ("random coefficients")) << std::setw(12) << trials
+		<< std::setw(12) << ratio.back() << std::setw(12) << ratio[ratio.size() / 2] << std::setw(8) << violations << "\n";
+}
+
+void complex_values(const std::vector<double>& coef, const double radius)
+{
+	typedef std::complex<double> cplx;
+	Polynomial<cplx> p;
+	for (std::size_t i = 0; i < coef.size(); ++i)
+		p.set_coefficient(unsigned(i), cplx(coef[i]));
+	std::vector<cplx> xs(POINTS), ys(POINTS);
+	std::vector<double> bounds(POINTS);
+	std::vector<Complex<QuadDouble>> ref(POINTS);
+	for (unsigned int k = 0; k < POINTS; ++k)
+	{
+		const double a = 6.283185307179586 * (double(k) + 0.5) / double(POINTS);
+		xs[k] = cplx(1.0 + radius * std::cos(a), radius * std::sin(a));
+		const Complex<QuadDouble> x(QuadDouble(xs[k].real()), QuadDouble(xs[k].imag()));
+		Complex<QuadDouble> y(QuadDouble(coef.back()));
+		for (std::size_t i = coef.size() - 1; i-- > 0;)
+			y = y * x + Complex<QuadDouble>(QuadDouble(coef[i]));
+		ref[k] = y;
+	}
+	std::cout << "complex p(x) for |x - 1| = " << radius << "\n";
+	double t = time_per_point([&]() { for (unsigned int k = 0; k < POINTS; ++k) ys[k] = p(xs[k]); }, 200);
+	double worst = 0.0, ratio = 0.0;
+	for (unsigned int k = 0; k < POINTS; ++k)
+	{
+		const Complex<QuadDouble> d = Complex<QuadDouble>(QuadDouble(ys[k].real()), QuadDouble(ys[k].imag())) - ref[k];
+		worst = std::max(worst, std::min(1.0, std::hypot(d.real()[0], d.imag()[0]) / std::hypot(ref[k].real()[0], ref[k].imag()[0])));
+	}
+	std::cout << std::setw(26) << "Horner" << std::setw(12) << t << std::setw(12) << worst << "\n";
+	t = time_per_point([&]() { for (unsigned int k = 0; k < POINTS; ++k) ys[k] = p.compensatedAt(xs[k], &bounds[k]); }, 100);
+	worst = 0.0;
+	unsigned int violations = 0;
+	for (unsigned int k = 0; k < POINTS; ++k)
+	{
+		const Complex<QuadDouble> d = Complex<QuadDouble>(QuadDouble(ys[k].real()), QuadDouble(ys[k].imag())) - ref[k];
+		const double err = std::hypot(d.real()[0], d.imag()[0]);
+		worst = std::max(worst, std::min(1.0, err / std::hypot(ref[k].real()[0], ref[k].imag()[0])));
+		ratio = std::max(ratio, err / bounds[k]);
+		violations += (err > bounds[k]);
+	}
+	std::cout << std::setw(26) << "compensatedAt" << std::setw(12) << t << std::setw(12) << worst << std::setw(12) << ratio << std::setw(12) << "" << std::setw(8) << violations << "\n";
+}
+
+void muller_stop(const Polynomial<std::complex<double>>& w, const double root, const bool bounded)
+{
+	typedef std::complex<double> cplx;
+	muller_options opts;
+	opts.tolerance = (bounded) ? (0.0) : (1e-10);
+	muller_result<cplx> res;
+	const unsigned int rounds = 2000;
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+	{
+		if (bounded)
+			res = muller([&](const cplx& x, double* bound) { return w.compensatedAt(x, bound); }, cplx(root - 0.3), cplx(root + 0.2), cplx(root + 0.1), opts);
+		else
+			res = muller([&](const cplx& x) { return w(x); }, cplx(root - 0.3), cplx(root + 0.2), cplx(root + 0.1), opts);
+	}
+	const double t = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e6 / rounds;
+	std::cout << std::setw(26) << ((bounded) ? ("compensated bound") : ("|f| < 1e-10")) << std::setw(6) << root << std::setw(12) << t
+		<< std::setw(8) << res.iterations << std::setw(12) << std::abs(res.root - cplx(root)) << std::setw(12) << std::abs(res.residual)
+		<< std::setw(12) << res.residual_bound << "\n";
+}
+
+int main()
+{
+	// (x-1)^DEGREE: binomial coefficients with alternating signs
+	std::vector<double> coef(DEGREE + 1);
+	double b = 1.0;
+	for (int i = DEGREE; i >= 0; --i)
+	{
+		coef[i] = ((DEGREE - i) % 2 == 0) ? (b) : (-b);
+		b = b * double(i) / double(DEGREE - i + 1);
+	}
+	Polynomial<double> p;
+	for (int i = 0; i <= DEGREE; ++i)
+		p.set_coefficient(i, coef[i]);
+	std::cout << std::setprecision(3);
+	std::cout << "(x-1)^" << DEGREE << " expanded, " << POINTS << " points\n";
+	std::cout << std::setw(26) << "" << std::setw(12) << "ns / point" << std::setw(12) << "rel. error" << std::setw(12) << "err/bound" << std::setw(12) << "median" << std::setw(8) << "> bound" << "\n";
+	values(p, coef, 0.2, 0.5);
+	values(p, coef, 0.05, 0.2);
+	values(p, coef, 0.02, 0.05);
+	derivatives(p, coef, 0.05, 0.2);
+	complex_values(coef, 0.1);
+
+	std::cout << "\ncompensated p'(x) on random polynomials of degree 2 to 40\n";
+	std::cout << std::setw(26) << "" << std::setw(12) << "trials" << std::setw(12) << "err/bound" << std::setw(12) << "median" << std::setw(8) << "> bound" << "\n";
+	random_derivatives(false, 100000);
+	random_derivatives(true, 100000);
+
+	std::cout << "\nMuller on the Wilkinson polynomial (x-1)...(x-20), Complex<double>\n";
+	std::cout << std::setw(26) << "stop" << std::setw(6) << "root" << std::setw(12) << "us / root" << std::setw(8) << "iter." << std::setw(12) << "root error" << std::setw(12) << "|f|" << std::setw(12) << "bound" << "\n";
+	Polynomial<std::complex<double>> w{ std::complex<double>(1.0) };
+	for (int k = 1; k <= 20; ++k)
+		w = w * Polynomial<std::complex<double>>{ std::complex<double>(-k), std::complex<double>(1.0) };
+	for (double root : { 3.0, 8.0, 14.0 })
+	{
+		muller_stop(w, root, false);
+		muller_stop(w, root, true);
+	}
+	return EXIT_SUCCESS;
+}
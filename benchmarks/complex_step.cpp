@@ -0,0 +1,91 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+#include "../differentiation/tcomplexstep.hpp"
+
+/*
+ * Complex-step against central differences. Accuracy: the derivative of Squire and Trapp's test function
+ * e^x / sqrt(sin^3 x + cos^3 x) at x = 1.5 over a range of steps. Cost: gradients of a 16 dimensional function for a
+ * batch of points, one complex evaluation per component against two real ones, over the thread counts.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+template <typename _ty> _ty squire_trapp(const _ty& x)
+{
+	const _ty s = sin(x), c = cos(x);
+	return exp(x) / sqrt(s * s * s + c * c * c);
+}
+
+const unsigned int DIM = 16;
+
+/** a smooth objective: sum_i exp(x_i * x_{i+1}) * sin(i * x_i) + log(1 + x_i^2) */
+template <typename _ty> _ty objective(const Vector<DIM, _ty>& x)
+{
+	_ty s = _ty(0.0);
+	for (unsigned int i = 0; i < DIM; ++i)
+	{
+		const _ty xi = x.get(i), xn = x.get((i + 1) % DIM);
+		s += exp(xi * xn) * sin(xi * double(i + 1)) + log(xi * xi + 1.0);
+	}
+	return s;
+}
+
+int main()
+{
+	// f'(x) = f(x) * (1 - 3 s c (s - c) / (2 (s^3 + c^3))), in long double
+	const long double x0 = 1.5L, s = std::sin(x0), c = std::cos(x0);
+	const long double exact = std::exp(x0) / std::sqrt(s * s * s + c * c * c) * (1.0L - 3.0L * s * c * (s - c) / (2.0L * (s * s * s + c * c * c)));
+	auto f = [](const double x) { return squire_trapp(x); };
+	auto fc = [](const Complex<double>& z) { return squire_trapp(z); };
+	std::cout << std::setprecision(3);
+	std::cout << std::setw(10) << "step" << std::setw(16) << "central error" << std::setw(16) << "complex error" << "\n";
+	for (int e = 1; e <= 20; e += (e < 16) ? (1) : (4))
+	{
+		const double h = std::pow(10.0, -e);
+		const double central = (f(1.5 + h) - f(1.5 - h)) / (2.0 * h);
+		const double cstep = complex_step::derivative(fc, 1.5, static_cast<double*>(nullptr), h);
+		std::cout << std::setw(10) << h << std::setw(16) << std::abs(double(central - exact) / double(exact)) << std::setw(16) << std::abs(double(cstep - exact) / double(exact)) << "\n";
+	}
+	std::cout << std::setw(10) << "default" << std::setw(16) << "" << std::setw(16) << std::abs(double(complex_step::derivative(fc, 1.5) - exact) / double(exact)) << "\n\n";
+
+	const std::size_t points = 2000;
+	std::vector<Vector<DIM, double>> xs(points), gs(points), gc(points);
+	for (std::size_t k = 0; k < points; ++k)
+		for (unsigned int i = 0; i < DIM; ++i)
+			xs[k].set(i, std::sin(double(k * DIM + i)));
+	auto obj = [](const Vector<DIM, double>& x) { return objective(x); };
+	auto objc = [](const Vector<DIM, Complex<double>>& x) { return objective(x); };
+	std::cout << std::setw(8) << "threads" << std::setw(20) << "central [ns/grad]" << std::setw(20) << "complex [ns/grad]" << std::setw(14) << "max diff" << "\n";
+	for (unsigned int threads : { 1u, 2u, 0u })
+	{
+		bench_clock::time_point t0 = bench_clock::now();
+		parallel::for_each_index(points, threads, [&](const std::size_t k)
+		{
+			Vector<DIM, double> x(xs[k]);
+			for (unsigned int i = 0; i < DIM; ++i)
+			{
+				const double xi = x.get(i), h = 6e-6 * (1.0 + std::abs(xi));
+				x.set(i, xi + h);
+				const double up = obj(x);
+				x.set(i, xi - h);
+				const double down = obj(x);
+				x.set(i, xi);
+				gc[k].set(i, (up - down) / (2.0 * h));
+			}
+		}, 16);
+		const double tc = std::chrono::duration<double>(bench_clock::now() - t0).count() / points;
+		t0 = bench_clock::now();
+		complex_step::gradients(objc, xs.data(), gs.data(), points, threads);
+		const double ts = std::chrono::duration<double>(bench_clock::now() - t0).count() / points;
+		double diff = 0.0;
+		for (std::size_t k = 0; k < points; ++k)
+			diff = std::max(diff, (gs[k] - gc[k]).abs() / (1.0 + gs[k].abs()));
+		std::cout << std::setw(8) << parallel::resolve_threads(threads) << std::setw(20) << tc * 1e9 << std::setw(20) << ts * 1e9 << std::setw(14) << diff << "\n";
+	}
+	return EXIT_SUCCESS;
+}
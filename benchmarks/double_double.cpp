@@ -0,0 +1,211 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#ifdef WITH_GMP
+#  include <gmpxx.h>
+#endif
+
+#include "../util/tdoubledouble.hpp"
+#include "../util/tcomplex.hpp"
+#include "../util/tpolynomial.hpp"
+#include "../roots/tdeflation.hpp"
+
+/*
+ * DoubleDouble and QuadDouble against long double (x87 extended precision on x86) and software floating point:
+ * GCC's __float128 and, when built with -DWITH_GMP (link with -lgmpxx -lgmp), GMP's mpf_class at 106 and 212 bits.
+ *  - Horner's scheme on the expanded Wilkinson polynomial (x-1)(x-2)...(x-20) at 1000 points in [1, 20], each type
+ *    with its own rounding of the coefficients; the error is relative to a quad-double evaluation of the exact ones.
+ *  - all roots of the same polynomial by Muller's method with deflation, on Complex<_ty>.
+ *  - the cost of sqrt, exp, log, sin and atan2.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+const int DEGREE = 20;
+const unsigned int POINTS = 1000;
+
+/** the conversions from and to the reference type */
+template <typename _ty> inline _ty from_qd(const QuadDouble& x) { return _ty(x[0]) + _ty(x[1]) + _ty(x[2]) + _ty(x[3]); }
+template <> inline double from_qd<double>(const QuadDouble& x) { return x[0]; }
+template <> inline long double from_qd<long double>(const QuadDouble& x) { return x.to_long_double(); }
+template <> inline DoubleDouble from_qd<DoubleDouble>(const QuadDouble& x) { return DoubleDouble(x[0], x[1]); }
+template <> inline QuadDouble from_qd<QuadDouble>(const QuadDouble& x) { return x; }
+template <typename _ty> inline QuadDouble to_qd(const _ty& x) { return QuadDouble(x); }
+template <> inline QuadDouble to_qd<DoubleDouble>(const DoubleDouble& x) { return QuadDouble(x[0], x[1]); }
+#ifdef __SIZEOF_FLOAT128__
+template <> inline QuadDouble to_qd<__float128>(const __float128& x)
+{
+	const double hi = double(x), lo = double(x - __float128(hi));
+	return QuadDouble(hi, lo) + double(x - __float128(hi) - __float128(lo));
+}
+#endif
+#ifdef WITH_GMP
+template <> inline mpf_class from_qd<mpf_class>(const QuadDouble& x)
+{
+	mpf_class res(x[0], 256);
+	for (unsigned int i = 1; i < 4; ++i)
+		res += x[i];
+	return res;
+}
+template <> inline QuadDouble to_qd<mpf_class>(const mpf_class& x)
+{
+	QuadDouble res;
+	mpf_class rest(x, 256);
+	for (unsigned int i = 0; i < 4; ++i)
+	{
+		const double d = rest.get_d();
+		res += d;
+		rest -= d;
+	}
+	return res;
+}
+#endif
+
+template <typename _ty> inline _ty horner(const std::vector<_ty>& c, const _ty& x)
+{
+	_ty y = c.back();
+	for (std::size_t i = c.size() - 1; i-- > 0;)
+		y = y * x + c[i];
+	return y;
+}
+
+/** time per evaluation and largest relative error of Horner's scheme in _ty */
+template <typename _ty> void evaluate(const std::string& name, const std::vector<_ty>& cs, const std::vector<_ty>& ps, const std::vector<QuadDouble>& ref, const unsigned int rounds)
+{
+	std::vector<_ty> ys(ps.size());
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		for (std::size_t i = 0; i < ps.size(); ++i)
+			ys[i] = horner(cs, ps[i]);
+	const double t = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / (double(rounds) * double(ps.size()));
+	double worst = 0.0;
+	for (std::size_t i = 0; i < ps.size(); ++i)
+		worst = std::max(worst, std::abs(((to_qd(ys[i]) - ref[i]) / ref[i])[0]));
+	std::cout << std::setw(22) << name << std::setw(14) << t << std::setw(14) << worst << "\n";
+}
+
+template <typename _ty> void evaluate(const std::string& name, const std::vector<QuadDouble>& coef, const std::vector<QuadDouble>& xs, const std::vector<QuadDouble>& ref, const unsigned int rounds)
+{
+	std::vector<_ty> cs, ps;
+	for (const QuadDouble& c : coef)
+		cs.push_back(from_qd<_ty>(c));
+	for (const QuadDouble& x : xs)
+		ps.push_back(from_qd<_ty>(x));
+	evaluate(name, cs, ps, ref, rounds);
+}
+
+/** time per solve and largest root error of Muller's method with deflation on Complex<_ty> */
+template <typename _ty> void solve(const std::string& name, const std::vector<QuadDouble>& coef, const double step_tolerance, const unsigned int rounds)
+{
+	typedef Complex<_ty> cty;
+	Polynomial<cty> p;
+	for (int i = 0; i <= DEGREE; ++i)
+		p.set_coefficient(i, cty(from_qd<_ty>(coef[i])));
+	deflation_options opts;
+	opts.muller.step_tolerance = step_tolerance;
+	deflation_workspace<cty> ws;
+	std::vector<cty> roots;
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		find_roots_muller(p, roots, ws, opts);
+	const double t = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e6 / rounds;
+	std::sort(roots.begin(), roots.end(), [](const cty& a, const cty& b) { return a.real() < b.real(); });
+	double worst = 0.0;
+	for (std::size_t k = 0; k < roots.size(); ++k)
+	{
+		const QuadDouble re = to_qd(roots[k].real()) - double(k + 1), im = to_qd(roots[k].imag());
+		worst = std::max(worst, std::sqrt(re[0] * re[0] + im[0] * im[0]));
+	}
+	std::cout << std::setw(22) << name << std::setw(14) << t << std::setw(14) << worst << "\n";
+}
+
+template <typename _fn> double time_call(_fn&& fn, const unsigned int rounds)
+{
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		fn(r);
+	return std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / rounds;
+}
+
+/** ns per call of the elementary functions, found as the library finds them */
+template <typename _ty> void functions(const std::string& name, const unsigned int rounds)
+{
+	using std::sqrt;
+	using std::exp;
+	using std::log;
+	using std::sin;
+	using std::atan2;
+	_ty sink = _ty(0);
+	std::vector<_ty> xs;
+	for (unsigned int i = 0; i < 64; ++i)
+		xs.push_back(_ty(0.1 + 0.05 * double(i)) / _ty(3.0));
+	std::cout << std::setw(22) << name;
+	std::cout << std::setw(10) << time_call([&](unsigned int r) { sink += sqrt(xs[r & 63]); }, rounds);
+	std::cout << std::setw(10) << time_call([&](unsigned int r) { sink += exp(xs[r & 63]); }, rounds);
+	std::cout << std::setw(10) << time_call([&](unsigned int r) { sink += log(xs[r & 63]); }, rounds);
+	std::cout << std::setw(10) << time_call([&](unsigned int r) { sink += sin(xs[r & 63]); }, rounds);
+	std::cout << std::setw(10) << time_call([&](unsigned int r) { sink += atan2(xs[r & 63], xs[(r + 7) & 63]); }, rounds);
+	std::cout << "   (" << double(sink > _ty(0)) << ")\n";
+}
+
+int main()
+{
+	// exact coefficients: the products stay below 2^212
+	Polynomial<QuadDouble> w{ QuadDouble(1.0) };
+	for (int k = 1; k <= DEGREE; ++k)
+		w = w * Polynomial<QuadDouble>{ QuadDouble(double(-k)), QuadDouble(1.0) };
+	std::vector<QuadDouble> coef, xs, ref;
+	for (int i = 0; i <= DEGREE; ++i)
+		coef.push_back(w.get_coefficient(i));
+	for (unsigned int i = 0; i < POINTS; ++i)
+	{
+		xs.push_back(QuadDouble(1.0 + 19.0 * (double(i) + 0.5) / double(POINTS)));
+		QuadDouble y(1.0);
+		for (int k = 1; k <= DEGREE; ++k)
+			y *= xs.back() - double(k);
+		ref.push_back(y);
+	}
+	std::cout << std::setprecision(3);
+
+	std::cout << "Horner on the Wilkinson polynomial, degree " << DEGREE << "\n";
+	std::cout << std::setw(22) << "type" << std::setw(14) << "ns / eval" << std::setw(14) << "rel. error" << "\n";
+	evaluate<double>("double", coef, xs, ref, 2000);
+	evaluate<long double>("long double", coef, xs, ref, 2000);
+	evaluate<DoubleDouble>("DoubleDouble", coef, xs, ref, 500);
+	evaluate<QuadDouble>("QuadDouble", coef, xs, ref, 100);
+#ifdef __SIZEOF_FLOAT128__
+	evaluate<__float128>("__float128 (soft)", coef, xs, ref, 200);
+#endif
+#ifdef WITH_GMP
+	{
+		for (unsigned int bits : { 106u, 212u })
+		{
+			std::vector<mpf_class> cs, ps;
+			for (const QuadDouble& c : coef)
+				cs.push_back(mpf_class(from_qd<mpf_class>(c), bits));
+			for (const QuadDouble& x : xs)
+				ps.push_back(mpf_class(from_qd<mpf_class>(x), bits));
+			evaluate("mpf_class, " + std::to_string(bits) + " bits", cs, ps, ref, 50);
+		}
+	}
+#endif
+
+	std::cout << "\nMuller with deflation on the same polynomial\n";
+	std::cout << std::setw(22) << "type" << std::setw(14) << "us / solve" << std::setw(14) << "root error" << "\n";
+	solve<double>("Complex<double>", coef, 1e-14, 200);
+	solve<long double>("Complex<long double>", coef, 1e-17, 200);
+	solve<DoubleDouble>("Complex<DoubleDouble>", coef, 1e-28, 20);
+	solve<QuadDouble>("Complex<QuadDouble>", coef, 1e-60, 5);
+
+	std::cout << "\nns per call" << std::setw(13) << "sqrt" << std::setw(10) << "exp" << std::setw(10) << "log" << std::setw(10) << "sin" << std::setw(10) << "atan2" << "\n";
+	functions<double>("double", 1000000);
+	functions<long double>("long double", 1000000);
+	functions<DoubleDouble>("DoubleDouble", 100000);
+	functions<QuadDouble>("QuadDouble", 20000);
+	return EXIT_SUCCESS;
+}
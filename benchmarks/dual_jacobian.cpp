@@ -0,0 +1,125 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "../util/tdual.hpp"
+
+/*
+ * Jacobians of the 16 dimensional Broyden tridiagonal system with an exponential coupling,
+ *   F_i(x) = (3 - 2 x_i) x_i - x_{i-1} - 2 x_{i+1} + 1 + 0.1 exp(x_i x_{i+1}),
+ * by forward and central differences (dim+1 and 2 dim evaluations) against dual numbers with 1, 4, 8 and 16 tangent
+ * lanes (16, 4, 2 and 1 evaluations). The error is the largest deviation from the analytic Jacobian.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+const unsigned int DIM = 16;
+typedef Vector<DIM, double> vec;
+typedef Vector<DIM, vec> mat;
+
+template <typename _ty> Vector<DIM, _ty> broyden(const Vector<DIM, _ty>& x)
+{
+	Vector<DIM, _ty> f;
+	for (unsigned int i = 0; i < DIM; ++i)
+	{
+		const _ty xi = x.get(i);
+		const _ty prev = (i > 0) ? (x.get(i - 1)) : (_ty(0.0));
+		const _ty next = (i + 1 < DIM) ? (x.get(i + 1)) : (_ty(0.0));
+		f.set(i, (3.0 - 2.0 * xi) * xi - prev - 2.0 * next + 1.0 + 0.1 * exp(xi * next));
+	}
+	return f;
+}
+
+mat exact_jacobian(const vec& x)
+{
+	mat j;
+	for (unsigned int i = 0; i < DIM; ++i)
+	{
+		const double xi = x.get(i), next = (i + 1 < DIM) ? (x.get(i + 1)) : (0.0), e = 0.1 * std::exp(xi * next);
+		j[i][i] = 3.0 - 4.0 * xi + e * next;
+		if (i > 0)
+			j[i][i - 1] = -1.0;
+		if (i + 1 < DIM)
+			j[i][i + 1] = -2.0 + e * xi;
+	}
+	return j;
+}
+
+double max_error(mat& j, const mat& ref)
+{
+	double e = 0.0;
+	for (unsigned int i = 0; i < DIM; ++i)
+		for (unsigned int k = 0; k < DIM; ++k)
+			e = std::max(e, std::abs(j[i][k] - ref.get(i).get(k)));
+	return e;
+}
+
+template <typename _fn> double time_ns(_fn&& fn, const unsigned int rounds)
+{
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		fn(r);
+	return std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / rounds;
+}
+
+template <unsigned int N> void dual_row(const vec& x, const mat& ref, const unsigned int rounds, double& sink)
+{
+	mat j;
+	const double t = time_ns([&](unsigned int) { dual::jacobian<N>([](const Vector<DIM, Dual<double, N>>& u) { return broyden(u); }, x, j); sink += j[0][0]; }, rounds);
+	std::cout << std::setw(16) << ("dual, " + std::to_string(N) + " lanes") << std::setw(10) << (DIM + N - 1) / N << std::setw(14) << t << std::setw(14) << max_error(j, ref) << "\n";
+}
+
+int main()
+{
+	vec x;
+	for (unsigned int i = 0; i < DIM; ++i)
+		x.set(i, -0.5 + 0.05 * double(i));
+	const mat ref = exact_jacobian(x);
+	const unsigned int rounds = 20000;
+	double sink = 0.0;
+	std::cout << std::setprecision(3);
+	std::cout << std::setw(16) << "method" << std::setw(10) << "evals" << std::setw(14) << "time [ns]" << std::setw(14) << "max error" << "\n";
+
+	mat j;
+	double t = time_ns([&](unsigned int)
+	{
+		const vec f0 = broyden(x);
+		vec xp(x);
+		for (unsigned int k = 0; k < DIM; ++k)
+		{
+			const double h = 1.5e-8 * (1.0 + std::abs(x.get(k)));
+			xp.set(k, x.get(k) + h);
+			const vec f1 = broyden(xp);
+			xp.set(k, x.get(k));
+			for (unsigned int i = 0; i < DIM; ++i)
+				j[i][k] = (f1.get(i) - f0.get(i)) / h;
+		}
+		sink += j[0][0];
+	}, rounds);
+	std::cout << std::setw(16) << "forward diff" << std::setw(10) << DIM + 1 << std::setw(14) << t << std::setw(14) << max_error(j, ref) << "\n";
+	t = time_ns([&](unsigned int)
+	{
+		vec xp(x);
+		for (unsigned int k = 0; k < DIM; ++k)
+		{
+			const double h = 6e-6 * (1.0 + std::abs(x.get(k)));
+			xp.set(k, x.get(k) + h);
+			const vec f1 = broyden(xp);
+			xp.set(k, x.get(k) - h);
+			const vec f2 = broyden(xp);
+			xp.set(k, x.get(k));
+			for (unsigned int i = 0; i < DIM; ++i)
+				j[i][k] = (f1.get(i) - f2.get(i)) / (2.0 * h);
+		}
+		sink += j[0][0];
+	}, rounds);
+	std::cout << std::setw(16) << "central diff" << std::setw(10) << 2 * DIM << std::setw(14) << t << std::setw(14) << max_error(j, ref) << "\n";
+	dual_row<1>(x, ref, rounds, sink);
+	dual_row<4>(x, ref, rounds, sink);
+	dual_row<8>(x, ref, rounds, sink);
+	dual_row<16>(x, ref, rounds, sink);
+	std::cout << "(" << sink << ")\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,81 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+#include "../integration/tgauss.hpp"
+
+/*
+ * Cost of making Gauss rules against fetching them from the process-wide cache, and of applying one Kronrod rule to a
+ * batch of m integrands cos(x + j/m) on [0,1]: one integrand at a time against gauss::apply(), which evaluates all of
+ * them per node and accumulates the weighted sums in vector registers.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+int main()
+{
+	std::cout << std::setprecision(3);
+	std::cout << std::setw(10) << "family" << std::setw(6) << "n" << std::setw(14) << "make [us]" << std::setw(14) << "cached [ns]" << "\n";
+	const char* names[] = { "legendre", "laguerre", "hermite", "kronrod" };
+	const gauss::family families[] = { gauss::family::legendre, gauss::family::laguerre, gauss::family::hermite, gauss::family::kronrod };
+	double sink = 0.0;
+	for (int f = 0; f < 4; ++f)
+		for (unsigned int n : { 10u, 50u, 200u })
+		{
+			const unsigned int rounds = 20, lookups = 100000;
+			bench_clock::time_point t0 = bench_clock::now();
+			for (unsigned int r = 0; r < rounds; ++r)
+				sink += gauss::make_rule(families[f], n)->weights[0];
+			const double tm = std::chrono::duration<double>(bench_clock::now() - t0).count() / rounds;
+			gauss::get(families[f], n);
+			t0 = bench_clock::now();
+			for (unsigned int r = 0; r < lookups; ++r)
+				sink += gauss::get(families[f], n)->weights[0];
+			const double tc = std::chrono::duration<double>(bench_clock::now() - t0).count() / lookups;
+			std::cout << std::setw(10) << names[f] << std::setw(6) << n << std::setw(14) << tm * 1e6 << std::setw(14) << tc * 1e9 << "\n";
+		}
+
+	std::cout << "\n" << std::setw(12) << "integrands" << std::setw(16) << "single [ns]" << std::setw(16) << "batched [ns]" << std::setw(12) << "max error" << "\n";
+	const gauss::rule& r = *gauss::get(gauss::family::kronrod, 15);
+	for (std::size_t m : { 8, 64, 512 })
+	{
+		std::vector<double> single(m), batched(m), gs(m), cs(m), sn(m);
+		for (std::size_t j = 0; j < m; ++j)
+		{
+			cs[j] = std::cos(double(j) / double(m));
+			sn[j] = std::sin(double(j) / double(m));
+		}
+		const unsigned int rounds = 200;
+		bench_clock::time_point t0 = bench_clock::now();
+		for (unsigned int k = 0; k < rounds; ++k)
+			for (std::size_t j = 0; j < m; ++j)
+			{
+				const double phase = double(j) / double(m);
+				single[j] = gauss::integrate_kronrod([phase](const double x) { return std::cos(x + phase); }, 0.0, 1.0, 15u);
+			}
+		const double ts = std::chrono::duration<double>(bench_clock::now() - t0).count() / (rounds * m);
+		t0 = bench_clock::now();
+		for (unsigned int k = 0; k < rounds; ++k)
+			gauss::apply(r, [&](const double x, double* y)
+			{
+				// cos(x + phase) = cos(x)cos(phase) - sin(x)sin(phase), one cosine and sine per node
+				const double c = std::cos(x), s = std::sin(x);
+				for (std::size_t j = 0; j < m; ++j)
+					y[j] = c * cs[j] - s * sn[j];
+			}, m, batched.data(), 0.5, 0.5, gs.data());
+		const double tb = std::chrono::duration<double>(bench_clock::now() - t0).count() / (rounds * m);
+		double worst = 0.0;
+		for (std::size_t j = 0; j < m; ++j)
+		{
+			const double phase = double(j) / double(m);
+			worst = std::max(worst, std::abs(batched[j] - (std::sin(1.0 + phase) - std::sin(phase))));
+			sink += single[j];
+		}
+		std::cout << std::setw(12) << m << std::setw(16) << ts * 1e9 << std::setw(16) << tb * 1e9 << std::setw(12) << worst << "\n";
+	}
+	std::cout << "cached rules: " << gauss::global_cache().size() << "    (" << sink << ")\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,57 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+
+#include "../interpolation/tnewton.hpp"
+
+/*
+ * NewtonInterpolant as a sliding window over a long stream of samples of sin(t) on an equidistant grid: the time per
+ * sample, and at checkpoints along the stream the largest difference, at the midpoints between the nodes, between
+ * the streamed interpolant and one built from scratch on the same window. It has to stay at the level of the
+ * rounding errors of a single fit however long the stream gets.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+void stream(const std::size_t window, const std::size_t samples, const std::size_t checkpoints)
+{
+	const double h = 0.01;
+	newton_interpolantd p(window, window);
+	std::cout << "window " << window << "\n";
+	std::cout << std::setw(12) << "samples" << std::setw(14) << "ns / sample" << std::setw(14) << "vs refit" << std::setw(14) << "vs sin" << "\n";
+	std::size_t done = 0;
+	for (std::size_t c = 1; c <= checkpoints; ++c)
+	{
+		const std::size_t until = samples * c / checkpoints;
+		bench_clock::time_point t0 = bench_clock::now();
+		for (; done < until; ++done)
+		{
+			const double t = double(done) * h;
+			p.add_point(t, std::sin(t));
+		}
+		const double t = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / double(samples / checkpoints);
+		newton_interpolantd fresh(window);
+		for (std::size_t k = 0; k < p.size(); ++k)
+			fresh.add_point(p.node(k), std::sin(p.node(k)));
+		double refit = 0.0, exact = 0.0;
+		for (std::size_t k = 0; k + 1 < p.size(); ++k)
+		{
+			const double x = 0.5 * (p.node(k) + p.node(k + 1));
+			refit = std::max(refit, std::abs(p(x) - fresh(x)));
+			exact = std::max(exact, std::abs(p(x) - std::sin(x)));
+		}
+		std::cout << std::setw(12) << done << std::setw(14) << t << std::setw(14) << refit << std::setw(14) << exact << "\n";
+	}
+}
+
+int main()
+{
+	std::cout << std::setprecision(3);
+	for (std::size_t window : { 4, 8, 12 })
+		stream(window, 2000000, 5);
+	return EXIT_SUCCESS;
+}
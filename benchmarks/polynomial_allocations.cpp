@@ -0,0 +1,128 @@
+#include <cstdlib>
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <new>
+#include <vector>
+
+#include "../util/tpolynomial.hpp"
+
+/*
+ * Counts heap allocations and times typical sequences of Polynomial operations: small polynomials built term by term,
+ * passed around by value, differentiated, integrated and combined. With the inline coefficient storage of
+ * util/tsmallvector.hpp most of these need no allocation at all; the larger cases show the growth policy.
+ */
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+	++allocations;
+	if (void* p = std::malloc((size == 0) ? (1) : (size)))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+template <typename _fn> void run(const char* name, _fn fn, const unsigned int reps)
+{
+	typedef std::chrono::high_resolution_clock clock;
+	double sink = 0.0;
+	const std::size_t a0 = allocations;
+	clock::time_point t0 = clock::now();
+	for (unsigned int r = 0; r < reps; ++r)
+		sink += fn(r);
+	const double dt = std::chrono::duration<double>(clock::now() - t0).count();
+	const std::size_t a = allocations - a0;
+	std::cout << std::setw(36) << name << std::setw(16) << double(a) / reps << std::setw(16) << dt / reps * 1e9 << "    (" << sink << ")\n";
+}
+
+Polynomial<double> linear(const double a)
+{
+	return Polynomial<double>{ -a, 1.0 };
+}
+
+/** deduces the coefficient type from a Polynomial, like most generic code taking one */
+template <typename _ty> _ty value_at(const Polynomial<_ty>& p, const _ty x)
+{
+	return p(x);
+}
+
+int main()
+{
+	const unsigned int reps = 200000;
+	std::cout << std::setprecision(2) << std::fixed;
+	std::cout << std::setw(36) << "sequence" << std::setw(16) << "allocs/iter" << std::setw(16) << "ns/iter" << "\n";
+
+	run("degree 5, term by term", [](unsigned int r)
+	{
+		Polynomial<double> p;
+		for (unsigned int i = 0; i <= 5; ++i)
+			p.set_coefficient(i, double(r + i));
+		return p(0.5);
+	}, reps);
+	run("degree 60, term by term", [](unsigned int r)
+	{
+		Polynomial<double> p;
+		for (unsigned int i = 0; i <= 60; ++i)
+			p.set_coefficient(i, double(r + i));
+		return p(0.5);
+	}, reps / 10);
+	run("make_exp(7)", [](unsigned int r)
+	{
+		Polynomial<double> p;
+		make_exp(&p, 7);
+		return p(double(r & 7));
+	}, reps);
+	run("returned by value, product of 3 linear", [](unsigned int r)
+	{
+		Polynomial<double> p = linear(double(r & 3)) * linear(1.0) * linear(2.0);
+		return p(0.5);
+	}, reps);
+	run("derivative and integral, degree 6", [](unsigned int r)
+	{
+		Polynomial<double> p = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, double(r & 7) };
+		Polynomial<double> q = p.derivative();
+		Polynomial<double> s = p.integral();
+		return q(0.5) + s(0.5);
+	}, reps);
+	run("p = p*a + q - r', degree 6, eager", [](unsigned int r)
+	{
+		Polynomial<double> p = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, double(r & 7) };
+		Polynomial<double> q = { 1.0, -1.0, 1.0 };
+		Polynomial<double> s = { 0.0, 0.0, 0.0, 1.0 };
+		p = p * 2.0 + q - s.derivative();
+		return p(0.5);
+	}, reps);
+	run("p = p*a + q - r', degree 6, lazy", [](unsigned int r)
+	{
+		Polynomial<double> p = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, double(r & 7) };
+		Polynomial<double> q = { 1.0, -1.0, 1.0 };
+		Polynomial<double> s = { 0.0, 0.0, 0.0, 1.0 };
+		p = lazy(p) * 2.0 + q - derivative(s);
+		return p(0.5);
+	}, reps);
+	run("vector of 16 degree-3 polynomials", [](unsigned int r)
+	{
+		std::vector<Polynomial<double>> v;
+		for (unsigned int i = 0; i < 16; ++i)
+			v.push_back(Polynomial<double>{ double(r), double(i), 1.0, 1.0 });
+		double s = 0.0;
+		for (const Polynomial<double>& p : v)
+			s += p(0.25);
+		return s;
+	}, reps / 10);
+
+	// the eager operators return Polynomials, so the rest of the Polynomial interface applies to their results
+	const Polynomial<double> p = { 1.0, 2.0, 3.0 }, q = { 0.5, -1.0 };
+	const Polynomial<double> lazy_sum = lazy(p) + q, lazy_difference = lazy(p) - q;
+	bool same = (p + q).to_string() == lazy_sum.to_string() && (p - q).to_string() == lazy_difference.to_string();
+	same = same && (p - q).derivative().to_string() == Polynomial<double>(derivative(lazy(p) - q)).to_string();
+	same = same && value_at(-p, 2.0) == -p(2.0) && value_at(p * 2.0, 2.0) == value_at(2.0 * p, 2.0) && value_at(p / 2.0, 2.0) == 0.5 * p(2.0);
+	const Polynomial<int> ip = { 2, 4, 6 };
+	same = same && (ip / 2).to_string() == Polynomial<int>{ 1, 2, 3 }.to_string();
+	std::cout << "\n" << p + q << ", " << (p - q).derivative() << ": eager and lazy results " << ((same) ? ("agree") : ("DIFFER")) << "\n";
+	return (same) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
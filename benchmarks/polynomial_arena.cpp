@@ -0,0 +1,103 @@
+#include <cstdlib>
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <new>
+#include <vector>
+
+#include "../util/tarena.hpp"
+#include "../util/tpolynomial.hpp"
+#include "../util/tparallel.hpp"
+
+/*
+ * Batches of short-lived polynomials, as in interpolation and deflation loops: every item builds the Lagrange
+ * interpolant through n points, differentiates it and deflates it by a linear factor. Compares the global allocator
+ * with memory::arena_allocator on the thread-local arena, reset once per batch.
+ */
+
+static std::size_t allocations = 0;
+
+void* operator new(std::size_t size)
+{
+	++allocations;
+	if (void* p = std::malloc((size == 0) ? (1) : (size)))
+		return p;
+	throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+template <typename _alloc> double item(std::vector<double>& x, std::vector<double>& y, const _alloc& a)
+{
+	typedef Polynomial<double, _alloc> pol;
+	pol p(a), q(a), r(a);
+	interpolate_lagrange(x, y, &p);
+	pol d = p.derivative();
+	divide(p, pol({ -x[0], 1.0 }, a), &q, &r);
+	return d(0.5) + q(0.5) + r(0.0);
+}
+
+/** the allocator an item on the calling thread uses */
+template <typename _alloc> _alloc item_allocator();
+template <> std::allocator<double> item_allocator<std::allocator<double>>() { return std::allocator<double>(); }
+template <> memory::arena_allocator<double> item_allocator<memory::arena_allocator<double>>() { return memory::arena_allocator<double>(memory::thread_arena()); }
+
+/** runs batches of items over the given points, each batch on threads threads; returns seconds per item */
+template <typename _alloc> double run(std::vector<std::vector<double>>& xs, std::vector<std::vector<double>>& ys, const unsigned int batches, const unsigned int threads, double& sink)
+{
+	typedef std::chrono::high_resolution_clock clock;
+	clock::time_point t0 = clock::now();
+	std::vector<double> sums(xs.size());
+	for (unsigned int b = 0; b < batches; ++b)
+	{
+		parallel::for_ranges(xs.size(), threads, [&](const std::size_t begin, const std::size_t end)
+		{
+			memory::arena_scope batch;
+			const _alloc a = item_allocator<_alloc>();
+			for (std::size_t i = begin; i < end; ++i)
+				sums[i] = item(xs[i], ys[i], a);
+		}, 64);
+		for (double s : sums)
+			sink += s;
+	}
+	return std::chrono::duration<double>(clock::now() - t0).count() / (double(batches) * xs.size());
+}
+
+int main()
+{
+	const std::size_t items = 4096;
+	const unsigned int batches = 20;
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<double> d(-1.0, 1.0);
+	std::cout << std::setprecision(2) << std::fixed;
+	std::cout << std::setw(8) << "points" << std::setw(8) << "threads" << std::setw(18) << "std allocs/item" << std::setw(14) << "std [ns]"
+		<< std::setw(18) << "arena allocs/item" << std::setw(14) << "arena [ns]" << "\n";
+	for (std::size_t n : { 6, 12, 24, 48 })
+	{
+		std::vector<std::vector<double>> xs(items, std::vector<double>(n)), ys(items, std::vector<double>(n));
+		for (std::size_t i = 0; i < items; ++i)
+			for (std::size_t j = 0; j < n; ++j)
+			{
+				xs[i][j] = double(j) + 0.5 * d(gen);
+				ys[i][j] = d(gen);
+			}
+		for (unsigned int threads : { 1u, 0u })
+		{
+			double sink = 0.0;
+			// warm up the thread arenas once
+			run<memory::arena_allocator<double>>(xs, ys, 1, threads, sink);
+			std::size_t a0 = allocations;
+			const double ts = run<std::allocator<double>>(xs, ys, batches, threads, sink);
+			const double as = double(allocations - a0) / (double(batches) * items);
+			a0 = allocations;
+			const double ta = run<memory::arena_allocator<double>>(xs, ys, batches, threads, sink);
+			const double aa = double(allocations - a0) / (double(batches) * items);
+			std::cout << std::setw(8) << n << std::setw(8) << parallel::resolve_threads(threads) << std::setw(18) << as << std::setw(14) << ts * 1e9
+				<< std::setw(18) << aa << std::setw(14) << ta * 1e9 << "    (" << sink << ")\n";
+		}
+	}
+	std::cout << "thread arena: " << memory::thread_arena().bytes_reserved() << " bytes reserved, peak batch " << memory::thread_arena().bytes_peak() << " bytes\n";
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,80 @@
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+
+#include "../util/tpolynomial.hpp"
+
+/*
+ * Latency and throughput of the single-point evaluation schemes in util/tpolyeval.hpp.
+ * Latency: every argument depends on the previous result, so only the dependency chain counts.
+ * Throughput: independent arguments, so the core may overlap consecutive evaluations.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+const unsigned int POINTS = 1u << 12;
+const unsigned int ROUNDS = 200;
+
+double latency_ns(const polynomiald& p, const polyeval::scheme s, const double tiny)
+{
+	double x = 0.5, acc = 0.0;
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int k = 0; k < POINTS * ROUNDS; ++k)
+	{
+		const double y = p(x, s);
+		acc += y;
+		x = 0.5 + y * tiny;
+	}
+	double dt = std::chrono::duration<double>(bench_clock::now() - t0).count();
+	if (acc == 42.0)
+		std::cout << "";
+	return dt * 1e9 / (POINTS * ROUNDS);
+}
+
+double throughput_ns(const polynomiald& p, const polyeval::scheme s, const std::vector<double>& xs)
+{
+	double acc = 0.0;
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < ROUNDS; ++r)
+		for (unsigned int k = 0; k < POINTS; ++k)
+			acc += p(xs[k], s);
+	double dt = std::chrono::duration<double>(bench_clock::now() - t0).count();
+	if (acc == 42.0)
+		std::cout << "";
+	return dt * 1e9 / (POINTS * ROUNDS);
+}
+
+int main(int argc, char** argv)
+{
+	std::mt19937 gen(7);
+	std::uniform_real_distribution<double> dist(-1.0, 1.0);
+	std::vector<double> xs(POINTS);
+	for (double& x : xs)
+		x = dist(gen);
+	// not a compile-time constant, so the latency chain cannot be folded away
+	const double tiny = (argc > 99) ? (std::atof(argv[1])) : (1e-300);
+
+	const polyeval::scheme schemes[] = { polyeval::scheme::horner, polyeval::scheme::second_order_horner, polyeval::scheme::estrin, polyeval::scheme::automatic };
+	const char* names[] = { "horner", "2nd-order", "estrin", "auto" };
+
+	std::cout << std::setprecision(2) << std::fixed;
+	std::cout << "ns per evaluation, latency / throughput; estrin_threshold() = " << polyeval::estrin_threshold() << "\n";
+	std::cout << std::setw(8) << "degree";
+	for (const char* name : names)
+		std::cout << std::setw(20) << name;
+	std::cout << "\n";
+	for (unsigned int deg = 4; deg <= 128; deg *= 2)
+	{
+		polynomiald p;
+		for (unsigned int i = 0; i <= deg; ++i)
+			p[i] = dist(gen) / (i + 1);
+		std::cout << std::setw(8) << deg;
+		for (polyeval::scheme s : schemes)
+			std::cout << std::setw(11) << latency_ns(p, s, tiny) << " /" << std::setw(7) << throughput_ns(p, s, xs);
+		std::cout << "\n";
+	}
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <complex>
+
+#include "../util/tcomplex.hpp"
+#include "../util/tpolynomial.hpp"
+
+/*
+ * Times the three multiplication kernels of util/tconvolution.hpp for growing factor lengths,
+ * so the crossover points karatsuba_threshold() and fft_threshold() can be tuned for a machine.
+ */
+
+template <typename _ty> _ty random_coefficient(std::mt19937& gen);
+template <> double random_coefficient<double>(std::mt19937& gen) { return std::uniform_real_distribution<double>(-1.0, 1.0)(gen); }
+template <> std::complex<double> random_coefficient<std::complex<double>>(std::mt19937& gen) { std::uniform_real_distribution<double> d(-1.0, 1.0); return std::complex<double>(d(gen), d(gen)); }
+template <> complexd random_coefficient<complexd>(std::mt19937& gen) { std::uniform_real_distribution<double> d(-1.0, 1.0); return complexd(d(gen), d(gen)); }
+
+template <typename _fn> double time_per_call(_fn fn)
+{
+	typedef std::chrono::high_resolution_clock clock;
+	unsigned int reps = 1;
+	for (;;)
+	{
+		clock::time_point t0 = clock::now();
+		for (unsigned int r = 0; r < reps; ++r)
+			fn();
+		double dt = std::chrono::duration<double>(clock::now() - t0).count();
+		if (dt > 0.05)
+			return dt / reps;
+		reps *= 2;
+	}
+}
+
+template <typename _ty> void run(const char* name)
+{
+	std::mt19937 gen(42);
+	std::cout << "\n" << name << "\n";
+	std::cout << std::setw(8) << "n" << std::setw(16) << "schoolbook[us]" << std::setw(16) << "karatsuba[us]" << std::setw(16) << "fft[us]" << "\n";
+	for (std::size_t n = 8; n <= 8192; n *= 2)
+	{
+		std::vector<_ty> a(n), b(n), c(2 * n - 1);
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			a[i] = random_coefficient<_ty>(gen);
+			b[i] = random_coefficient<_ty>(gen);
+		}
+		double ts = (n <= 4096) ? (time_per_call([&]() { convolution::schoolbook(a.data(), n, b.data(), n, c.data()); })) : (0.0);
+		double tk = time_per_call([&]() { convolution::karatsuba(a.data(), n, b.data(), n, c.data()); });
+		double tf = time_per_call([&]() { convolution::fft_product(a.data(), n, b.data(), n, c.data()); });
+		std::cout << std::setw(8) << n << std::setw(16) << ts * 1e6 << std::setw(16) << tk * 1e6 << std::setw(16) << tf * 1e6 << "\n";
+	}
+}
+
+int main()
+{
+	std::cout << std::setprecision(4) << std::fixed;
+	std::cout << "karatsuba_threshold() = " << convolution::karatsuba_threshold() << ", fft_threshold() = " << convolution::fft_threshold() << "\n";
+	run<double>("double");
+	run<std::complex<double>>("std::complex<double>");
+	run<complexd>("Complex<double>");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,210 @@
+#include <cstdlib>
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <random>
+
+#include "../util/tpolynomial.hpp"
+#include "../util/tdoubledouble.hpp"
+#include "../util/tconvolution.hpp"
+#include "../roots/tdeflation.hpp"
+#include "../roots/tdescartes.hpp"
+
+/*
+ * Real roots of the Wilkinson polynomials (x-1)(x-2)...(x-n) and of the Mignotte polynomials x^n - 2(4x-1)^2, which
+ * have two roots closer than 2(1/4)^(n/2) next to 1/4: Descartes isolation with Illinois refinement against Muller's
+ * method with deflation on the complex polynomial, keeping the roots with a small imaginary part. Reports the time per
+ * solve, the number of real roots found and the largest distance to the nearest reference root.
+ * Also: the Taylor shift of a random polynomial by the quadratic scheme and by the fast one (Karatsuba/FFT products)
+ * against a quad-double shift, as a multiple of the componentwise error bound that Descartes' test relies on (it must
+ * stay below 1 for the quadratic scheme; the fast one has no such bound), and isolation on random N(0,1)
+ * polynomials, where every isolated interval is checked against the sign changes of p in quad-double.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+/** largest distance from a reference root to the nearest found root (infinite if nothing was found) */
+double worst_error(const std::vector<double>& found, const std::vector<double>& reference)
+{
+	double worst = 0.0;
+	for (double r : reference)
+	{
+		double best = HUGE_VAL;
+		for (double x : found)
+			best = std::min(best, std::abs(x - r));
+		worst = std::max(worst, best);
+	}
+	return worst;
+}
+
+void compare(const std::string& name, const polynomiald& p, const std::vector<double>& reference, const unsigned int rounds)
+{
+	polynomialcd pc;
+	for (int i = 0; i <= p.degree(); ++i)
+		pc.set_coefficient(i, std::complex<double>(p.get_coefficient(i), 0.0));
+	std::vector<double> descartes_roots, muller_roots;
+
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		descartes_roots = find_real_roots(p);
+	const double td = std::chrono::duration<double>(bench_clock::now() - t0).count() / rounds;
+
+	deflation_workspace<std::complex<double>> ws;
+	std::vector<std::complex<double>> zs;
+	t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		find_roots_muller(pc, zs, ws);
+	const double tm = std::chrono::duration<double>(bench_clock::now() - t0).count() / rounds;
+	for (const std::complex<double>& z : zs)
+		if (std::abs(z.imag()) <= 1e-6 * (1.0 + std::abs(z.real())))
+			muller_roots.push_back(z.real());
+
+	unsigned int unresolved = 0;
+	for (const root_interval<double>& iv : isolate_real_roots(p))
+		unresolved += !iv.isolated;
+	std::cout << std::setw(14) << name << std::setw(8) << reference.size()
+		<< std::setw(12) << td * 1e6 << std::setw(8) << descartes_roots.size() << std::setw(12) << worst_error(descartes_roots, reference) << std::setw(8) << unresolved
+		<< std::setw(12) << tm * 1e6 << std::setw(8) << muller_roots.size() << std::setw(12) << worst_error(muller_roots, reference) << "\n";
+}
+
+std::vector<double> random_coefficients(const int degree, const unsigned int seed)
+{
+	std::mt19937 gen(seed);
+	std::normal_distribution<double> dist(0.0, 1.0);
+	std::vector<double> c(degree + 1);
+	for (double& x : c)
+		x = dist(gen);
+	return c;
+}
+
+QuadDouble horner(const std::vector<double>& c, const QuadDouble& x)
+{
+	QuadDouble y(c.back());
+	for (std::size_t i = c.size() - 1; i-- > 0;)
+		y = y * x + QuadDouble(c[i]);
+	return y;
+}
+
+void shift_paths(const int degree, const double a)
+{
+	const std::vector<double> c = random_coefficients(degree, 0);
+	const std::size_t n = c.size();
+	std::vector<double> ac(n), classic(n), fast(n), bound(n);
+	std::vector<QuadDouble> exact(c.begin(), c.end()), shifted(n);
+	for (std::size_t i = 0; i < n; ++i)
+		ac[i] = std::abs(c[i]);
+	convolution::taylor_shift_classic(c.data(), n, a, classic.data());
+	convolution::taylor_shift(c.data(), n, a, fast.data());
+	convolution::taylor_shift_classic(ac.data(), n, std::abs(a), bound.data());
+	convolution::taylor_shift_classic(exact.data(), n, QuadDouble(a), shifted.data());
+	// the bound of descartes_options::rounding = 4
+	const double gamma = 4.0 * double(n + 2) * std::numeric_limits<double>::epsilon();
+	double worst_classic = 0.0, worst_fast = 0.0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		// NaN (overflow in the binomials of the fast shift) sticks
+		const double ec = std::abs((QuadDouble(classic[i]) - shifted[i])[0]) / (gamma * bound[i]), ef = std::abs((QuadDouble(fast[i]) - shifted[i])[0]) / (gamma * bound[i]);
+		worst_classic = (ec <= worst_classic) ? (worst_classic) : (ec);
+		worst_fast = (ef <= worst_fast) ? (worst_fast) : (ef);
+	}
+	std::cout << std::setw(14) << ("shift " + std::to_string(degree)) << std::setw(8) << a << std::setw(12) << worst_classic << std::setw(12) << worst_fast << "\n";
+}
+
+void random_isolation(const int degree, const unsigned int seed)
+{
+	const std::vector<double> c = random_coefficients(degree, seed);
+	polynomiald p;
+	for (int i = degree; i >= 0; --i)
+		p.set_coefficient(i, c[i]);
+	bench_clock::time_point t0 = bench_clock::now();
+	const std::vector<root_interval<double>> iv = isolate_real_roots(p);
+	const double t = std::chrono::duration<double>(bench_clock::now() - t0).count();
+	unsigned int isolated = 0, unresolved = 0, wrong = 0, count = 0;
+	for (const root_interval<double>& r : iv)
+	{
+		count += r.count;
+		if (!r.isolated)
+		{
+			++unresolved;
+			continue;
+		}
+		++isolated;
+		// a simple root changes sign across the interval, and p has no other sign change on a fine grid inside
+		unsigned int changes = 0;
+		QuadDouble prev = horner(c, QuadDouble(r.lower));
+		for (int j = 1; j <= 256; ++j)
+		{
+			const QuadDouble y = horner(c, QuadDouble(r.lower + (r.upper - r.lower) * double(j) / 256.0));
+			changes += ((y[0] < 0.0) != (prev[0] < 0.0));
+			prev = y;
+		}
+		wrong += (changes != 1);
+	}
+	std::cout << std::setw(14) << ("random " + std::to_string(degree)) << std::setw(8) << seed << std::setw(12) << t * 1e6 << std::setw(8) << isolated
+		<< std::setw(8) << unresolved << std::setw(8) << count << std::setw(8) << wrong << "\n";
+}
+
+int main()
+{
+	std::cout << std::setprecision(3);
+	std::cout << std::setw(14) << "polynomial" << std::setw(8) << "real" << std::setw(12) << "desc [us]" << std::setw(8) << "found" << std::setw(12) << "error"
+		<< std::setw(8) << "unres" << std::setw(12) << "muller [us]" << std::setw(8) << "found" << std::setw(12) << "error" << "\n";
+	for (int n : { 5, 10, 15, 20 })
+	{
+		polynomiald w = { 1.0 };
+		std::vector<double> reference;
+		for (int k = 1; k <= n; ++k)
+		{
+			w *= polynomiald{ -double(k), 1.0 };
+			reference.push_back(double(k));
+		}
+		compare("wilkinson " + std::to_string(n), w, reference, 200);
+	}
+	for (int n : { 8, 16, 24, 32 })
+	{
+		polynomiald m;
+		for (int k = 0; k <= n; ++k)
+			m.set_coefficient(k, 0.0);
+		m.set_coefficient(n, 1.0);
+		m.set_coefficient(2, -32.0);
+		m.set_coefficient(1, 16.0);
+		m.set_coefficient(0, -2.0);
+		// reference roots by Newton's method in long double, started at the asymptotic positions
+		const double close = std::pow(0.25, 0.5 * n) / std::sqrt(32.0);
+		std::vector<double> reference;
+		for (double x : { -1.5, 0.25 - close, 0.25 + close, 1.5 })
+		{
+			long double z = x;
+			for (int it = 0; it < 50; ++it)
+			{
+				long double v = 1.0L, d = 0.0L;
+				for (int k = 0; k < n; ++k)
+				{
+					d = d * z + v;
+					v = v * z;
+				}
+				const long double q = 4.0L * z - 1.0L;
+				z -= (v - 2.0L * q * q) / (d - 16.0L * q);
+			}
+			reference.push_back(double(z));
+		}
+		compare("mignotte " + std::to_string(n), m, reference, 200);
+	}
+
+	std::cout << "\n" << std::setw(14) << "Taylor shift" << std::setw(8) << "by" << std::setw(12) << "classic" << std::setw(12) << "fast" << "   (largest error / bound)\n";
+	for (int degree : { 50, 200, 800 })
+		for (double a : { -1.5, 0.75 })
+			shift_paths(degree, a);
+
+	std::cout << "\n" << std::setw(14) << "polynomial" << std::setw(8) << "seed" << std::setw(12) << "desc [us]" << std::setw(8) << "isol." << std::setw(8) << "unres"
+		<< std::setw(8) << "count" << std::setw(8) << "wrong" << "\n";
+	for (int degree : { 50, 200, 250, 400 })
+		for (unsigned int seed = 0; seed < 3; ++seed)
+			random_isolation(degree, seed);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <thread>
+
+#include "../util/tpolynomial.hpp"
+#include "../util/tcomplex.hpp"
+#include "../util/tinterval.hpp"
+#include "../roots/taberth.hpp"
+#include "../roots/tdeflation.hpp"
+#include "../roots/tkrawczyk.hpp"
+
+/*
+ * Certified root inclusions with verify_roots() / verify_real_roots():
+ *  - random complex polynomials of growing degree, candidates from find_roots_aberth() and find_roots_muller():
+ *    time per candidate, how many come out verified, and the largest region and enclosure radius. At high degree
+ *    deflation loses accuracy, so many Muller candidates are rejected or converge onto roots found before.
+ *  - the same candidates plus as many spurious points (random points in the root annulus), to show that rejecting
+ *    those costs a fraction of a verification.
+ *  - thread scaling over the candidates.
+ *  - the Wilkinson polynomial (x-1)...(x-20) with the integers as real candidates: the extra compensated Newton steps
+ *    are what carry the ill-conditioned middle roots.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+typedef Complex<double> cplx;
+
+const char* status_name(const root_status s)
+{
+	switch (s)
+	{
+	case root_status::verified: return "verified";
+	case root_status::rejected: return "rejected";
+	case root_status::unverified: return "unverified";
+	default: return "duplicate";
+	}
+}
+
+Polynomial<cplx> random_polynomial(const int degree, std::mt19937& gen)
+{
+	std::normal_distribution<double> dist(0.0, 1.0);
+	Polynomial<cplx> p;
+	for (int i = degree; i >= 0; --i)
+		p.set_coefficient(i, cplx(dist(gen), dist(gen)));
+	return p;
+}
+
+double radius(const ComplexDisc<double>& d) { return d.radius(); }
+double radius(const Interval<double>& x) { return x.rad(); }
+
+/** microseconds per candidate */
+template <typename _fn> double time_per_candidate(_fn&& fn, const std::size_t candidates, const unsigned int rounds)
+{
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int r = 0; r < rounds; ++r)
+		fn();
+	return std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e6 / (double(rounds) * double(candidates));
+}
+
+template <typename _rty> void report(const std::string& name, const double t, const std::vector<root_inclusion<_rty>>& res)
+{
+	unsigned int count[4] = { 0, 0, 0, 0 };
+	double region = 0.0, enclosure = 0.0;
+	for (const root_inclusion<_rty>& r : res)
+	{
+		++count[int(r.status)];
+		if (r.status == root_status::verified)
+		{
+			region = std::max(region, radius(r.region));
+			enclosure = std::max(enclosure, radius(r.enclosure));
+		}
+	}
+	std::cout << std::setw(24) << name << std::setw(12) << t;
+	for (unsigned int s = 0; s < 4; ++s)
+		std::cout << std::setw(11) << count[s];
+	std::cout << std::setw(12) << region << std::setw(12) << enclosure << "\n";
+}
+
+void random_polynomials(const int degree, std::mt19937& gen)
+{
+	const Polynomial<cplx> p = random_polynomial(degree, gen);
+	const std::vector<cplx> aberth = find_roots_aberth(p).roots;
+	const std::vector<cplx> muller = find_roots_muller(p);
+	std::vector<cplx> spurious = aberth;
+	std::uniform_real_distribution<double> angle(0.0, 6.283185307179586), radius(0.8, 1.2);
+	for (int k = 0; k < degree; ++k)
+	{
+		const double a = angle(gen), m = radius(gen);
+		spurious.push_back(cplx(m * std::cos(a), m * std::sin(a)));
+	}
+	const unsigned int rounds = std::max(1, 4000 / (degree * degree));
+	std::vector<root_inclusion<ComplexDisc<double>>> res;
+	std::cout << "degree " << degree << "\n";
+	double t = time_per_candidate([&]() { res = verify_roots(p, aberth); }, aberth.size(), rounds);
+	report("Aberth", t, res);
+	t = time_per_candidate([&]() { res = verify_roots(p, muller); }, muller.size(), rounds);
+	report("Muller + deflation", t, res);
+	t = time_per_candidate([&]() { res = verify_roots(p, spurious); }, spurious.size(), rounds);
+	report("Aberth + spurious", t, res);
+}
+
+void thread_scaling(const int degree, std::mt19937& gen)
+{
+	const Polynomial<cplx> p = random_polynomial(degree, gen);
+	const std::vector<cplx> roots = find_roots_aberth(p).roots;
+	const unsigned int hardware = std::max(1u, std::thread::hardware_concurrency());
+	std::cout << "degree " << degree << ", Aberth candidates\n";
+	for (unsigned int threads = 1; threads <= hardware; threads *= 2)
+	{
+		krawczyk_options opts;
+		opts.threads = threads;
+		std::vector<root_inclusion<ComplexDisc<double>>> res;
+		const double t = time_per_candidate([&]() { res = verify_roots(p, roots, opts); }, roots.size(), 4);
+		report(std::to_string(threads) + " threads", t, res);
+	}
+}
+
+void wilkinson()
+{
+	Polynomial<double> w{ 1.0 };
+	for (int k = 1; k <= 20; ++k)
+		w = w * Polynomial<double>{ double(-k), 1.0 };
+	std::vector<double> candidates;
+	for (int k = 1; k <= 20; ++k)
+		candidates.push_back(double(k));
+	std::cout << "\nWilkinson (x-1)...(x-20), double coefficients, the integers as candidates, max_step 1e-2\n";
+	std::cout << std::setw(24) << "refinements" << std::setw(12) << "us / cand." << std::setw(11) << "verified" << std::setw(11) << "rejected" << std::setw(11) << "unverified" << std::setw(11) << "duplicate" << std::setw(12) << "region" << std::setw(12) << "enclosure" << "\n";
+	std::vector<root_inclusion<Interval<double>>> res;
+	for (unsigned int refinements : { 0u, 1u, 3u, 6u })
+	{
+		krawczyk_options opts;
+		opts.max_step = 1e-2;
+		opts.refinements = refinements;
+		const double t = time_per_candidate([&]() { res = verify_real_roots(w, candidates, opts); }, candidates.size(), 1000);
+		report(std::to_string(refinements), t, res);
+	}
+	for (std::size_t k = 0; k < res.size(); k += 4)
+		std::cout << std::setw(24) << candidates[k] << "  " << status_name(res[k].status) << " " << std::setprecision(17) << res[k].enclosure << std::setprecision(3) << "\n";
+}
+
+int main()
+{
+	std::mt19937 gen(20240521);
+	std::cout << std::setprecision(3);
+	std::cout << std::setw(24) << "candidates" << std::setw(12) << "us / cand." << std::setw(11) << "verified" << std::setw(11) << "rejected" << std::setw(11) << "unverified" << std::setw(11) << "duplicate" << std::setw(12) << "region" << std::setw(12) << "enclosure" << "\n";
+	for (int degree : { 10, 40, 160 })
+		random_polynomials(degree, gen);
+	std::cout << "\n";
+	thread_scaling(400, gen);
+	wilkinson();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#include <cstdlib>
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <vector>
+
+#include "../util/tstaticpolynomial.hpp"
+
+/*
+ * StaticPolynomial against Polynomial: the time per evaluation of the degree 12 Taylor polynomial of exp, and a check
+ * that the arithmetic of both gives the same coefficients, for double (bit for bit) and for int, where division has
+ * to divide each coefficient instead of multiplying by a reciprocal that truncates to 0.
+ */
+
+typedef std::chrono::high_resolution_clock bench_clock;
+
+// integer division at compile time
+static_assert((StaticPolynomial<2, int>(2, 4, 6) / 2)[1] == 2, "StaticPolynomial<int>::operator/ divides each coefficient");
+
+template <unsigned int N, typename _ty> bool same(const StaticPolynomial<N, _ty>& s, const Polynomial<_ty>& p)
+{
+	for (unsigned int i = 0; i <= N; ++i)
+		if (!(s.get_coefficient(i) == p.get_coefficient(i)))
+			return false;
+	return p.degree() <= int(N);
+}
+
+template <typename _ty> bool arithmetic(const StaticPolynomial<4, _ty>& a, const StaticPolynomial<2, _ty>& b, const _ty s)
+{
+	const Polynomial<_ty> pa = a.to_polynomial(), pb = b.to_polynomial();
+	bool ok = same(a + b, pa + pb) && same(a - b, pa - pb) && same(-a, -pa) && same(a * b, pa * pb);
+	ok = ok && same(a * s, pa * s) && same(s * a, s * pa) && same(a / s, pa / s) && same(a.derivative(), pa.derivative());
+	return ok;
+}
+
+int main()
+{
+	const unsigned int points = 1000000;
+	std::vector<double> xs(points);
+	for (unsigned int k = 0; k < points; ++k)
+		xs[k] = -1.0 + 2.0 * double(k) / double(points);
+	constexpr static_polynomiald<12> e = make_static_exp<12>();
+	const Polynomial<double> pe = e.to_polynomial();
+	double sink = 0.0;
+	bench_clock::time_point t0 = bench_clock::now();
+	for (unsigned int k = 0; k < points; ++k)
+		sink += e(xs[k]);
+	const double ts = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / points;
+	t0 = bench_clock::now();
+	for (unsigned int k = 0; k < points; ++k)
+		sink -= pe(xs[k]);
+	const double tp = std::chrono::duration<double>(bench_clock::now() - t0).count() * 1e9 / points;
+	std::cout << std::setprecision(3) << "exp, degree 12: StaticPolynomial " << ts << " ns, Polynomial " << tp << " ns per point (difference " << sink << ")\n";
+
+	const bool real = arithmetic(StaticPolynomial<4, double>(0.3, -1.7, 2.9, 0.1, -5.3), StaticPolynomial<2, double>(1.1, 0.7, -3.0), 3.0);
+	const bool integer = arithmetic(StaticPolynomial<4, int>(7, -9, 12, 5, -30), StaticPolynomial<2, int>(2, 4, 6), 4);
+	const bool halves = same(StaticPolynomial<2, int>(2, 4, 6) / 2, Polynomial<int>{ 1, 2, 3 });
+	std::cout << "same coefficients as Polynomial: double " << ((real) ? ("yes") : ("NO")) << ", int " << ((integer && halves) ? ("yes") : ("NO")) << "\n";
+	return (real && integer && halves) ? (EXIT_SUCCESS) : (EXIT_FAILURE);
+}
@@ -0,0 +1,92 @@
+#ifndef _FHP_TCOMPLEXSTEP_HPP_INCLUDED_
+#define _FHP_TCOMPLEXSTEP_HPP_INCLUDED_
+
+#include <cstddef>
+#include <limits>
+#include "../util/tcomplex.hpp"
+#include "../util/tvector.hpp"
+#include "../util/tparallel.hpp"
+
+
+/**
+ * Complex-step differentiation: for f real on the real axis and analytic near x, f'(x) = Im f(x + ih) / h + O(h^2).
+ * Nothing is subtracted, so h can be far below the square root of epsilon and the result is accurate to rounding
+ * without tuning the step. The functions differentiated here are called with Complex<_ty> arguments, so they have to
+ * be written generically (a template or a generic lambda) with operations that are analytic: + - * /, exp, log, sin,
+ * cos, tan, sinh, cosh, tanh and sqrt of util/tcomplex.hpp, and complex_step::abs() instead of a modulus. Comparisons
+ * go through real(). Powers of negative bases should be written as products, since the polar form of pow() rounds
+ * the argument pi.
+ */
+namespace complex_step
+{
+
+	/** default step, epsilon^2: the truncation error h^2 f'''/6 is far below rounding, and h*|f'| does not underflow */
+	template <typename _ty> inline _ty default_step()
+	{
+		return std::numeric_limits<_ty>::epsilon() * std::numeric_limits<_ty>::epsilon();
+	}
+
+	/** |x| continued analytically from the sign of the real part, which is what complex-step needs */
+	template <typename _ty> inline Complex<_ty> abs(const Complex<_ty>& z)
+	{
+		return (z.real() < _ty(0)) ? (-z) : (z);
+	}
+
+	/** f'(x) for f: Complex<_ty> -> Complex<_ty>; *value, if given, gets f(x) from the same call */
+	template <typename _ty, typename _fn> inline _ty derivative(_fn&& f, const _ty x, _ty* value = nullptr, const _ty h = default_step<_ty>())
+	{
+		const Complex<_ty> y = f(Complex<_ty>(x, h));
+		if (value)
+			*value = y.real();
+		return y.imag() / h;
+	}
+
+	/** dys[k] = f'(xs[k]) for k < n (and ys[k] = f(xs[k]) if ys is not null), split over the given number of threads */
+	template <typename _ty, typename _fn> inline void derivatives(_fn&& f, const _ty* xs, _ty* dys, const std::size_t n, _ty* ys = nullptr, const unsigned int threads = 1, const _ty h = default_step<_ty>())
+	{
+		parallel::for_each_index(n, threads, [&](const std::size_t k)
+		{
+			dys[k] = derivative(f, xs[k], (ys) ? (ys + k) : (nullptr), h);
+		}, 16);
+	}
+
+	/** df/dx_i at x for f: Vector<dim, Complex<base_t>> -> Complex<base_t>, one complex evaluation */
+	template <unsigned int dim, typename base_t, typename _fn> inline base_t partial(_fn&& f, const Vector<dim, base_t>& x, const unsigned int i, const base_t h = default_step<base_t>())
+	{
+		Vector<dim, Complex<base_t>> z;
+		for (unsigned int j = 0; j < dim; ++j)
+			z.set(j, Complex<base_t>(x.get(j), (j == i) ? (h) : (base_t(0))));
+		return f(z).imag() / h;
+	}
+
+	/**
+	 * gradient of f: Vector<dim, Complex<base_t>> -> Complex<base_t> at x, one complex evaluation per component; the
+	 * components are spread over the given number of threads (0: one per hardware thread), so f has to be thread-safe
+	 */
+	template <unsigned int dim, typename base_t, typename _fn> inline Vector<dim, base_t> gradient(_fn&& f, const Vector<dim, base_t>& x, const unsigned int threads = 1, const base_t h = default_step<base_t>())
+	{
+		Vector<dim, base_t> g;
+		parallel::for_each_index(dim, threads, [&](const std::size_t i)
+		{
+			g.set(unsigned(i), partial(f, x, unsigned(i), h));
+		});
+		return g;
+	}
+
+	/**
+	 * gradients gs[k] at the points xs[k], k < count; all count*dim components are independent and spread over the
+	 * threads in contiguous ranges, so neighbouring components of one point usually stay on one thread
+	 */
+	template <unsigned int dim, typename base_t, typename _fn> inline void gradients(_fn&& f, const Vector<dim, base_t>* xs, Vector<dim, base_t>* gs, const std::size_t count, const unsigned int threads = 1, const base_t h = default_step<base_t>())
+	{
+		parallel::for_each_index(count * dim, threads, [&](const std::size_t t)
+		{
+			const std::size_t k = t / dim;
+			const unsigned int i = unsigned(t % dim);
+			gs[k].set(i, partial(f, xs[k], i, h));
+		}, dim);
+	}
+
+}
+
+#endif
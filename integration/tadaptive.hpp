@@ -0,0 +1,442 @@
+#ifndef _FHP_TADAPTIVE_HPP_INCLUDED_
+#define _FHP_TADAPTIVE_HPP_INCLUDED_
+
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "tgauss.hpp"
+#include "../util/tparallel.hpp"
+
+
+/** settings for integrate_adaptive() */
+struct adaptive_options
+{
+	/** stop once the estimated error is at most max(abs_tolerance, rel_tolerance*|integral|) */
+	double abs_tolerance = 1e-10;
+	double rel_tolerance = 1e-10;
+	/** most bisections over the whole run */
+	unsigned int max_subdivisions = 10000;
+	/** Gauss points of the Kronrod pair: 7 (7-15 points) or 10 (10-21 points) */
+	unsigned int points = 7;
+	/** worker threads, 0: one per hardware thread */
+	unsigned int threads = 1;
+	/**
+	 * split the worst intervals in rounds of `batch`, chosen and merged back in a fixed order, so the result is bitwise
+	 * the same for every thread count; otherwise every worker splits whatever is worst when it runs dry
+	 */
+	bool deterministic = false;
+	unsigned int batch = 16;
+};
+
+/** what one worker did */
+struct adaptive_thread_stats
+{
+	/** calls of the integrand */
+	unsigned long evaluations = 0;
+	/** Kronrod rules applied */
+	unsigned int intervals = 0;
+	/** worst intervals this worker took off the heap and bisected */
+	unsigned int splits = 0;
+	/** intervals taken from the deques of other workers */
+	unsigned int steals = 0;
+	/** time spent evaluating rules */
+	double busy_seconds = 0.0;
+};
+
+template <typename _ty> struct adaptive_result
+{
+	_ty value;
+	/** sum of the error estimates |Kronrod - Gauss| of the final intervals */
+	_ty error;
+	/** false if the subdivision budget ran out, intervals got too narrow to split, or the error estimate stopped being finite (the integrand overflowed) before the tolerance was met */
+	bool converged;
+	unsigned long evaluations;
+	unsigned int subdivisions;
+	/** final number of intervals */
+	unsigned int intervals;
+	/** one entry per worker, the calling thread first */
+	std::vector<adaptive_thread_stats> threads;
+};
+
+
+namespace adaptive
+{
+
+	template <typename _ty> struct piece
+	{
+		_ty a, b, value, error;
+		/** share of the parent's error that stands in for this piece until it has been evaluated */
+		_ty pending;
+	};
+
+	/** heap order: largest error on top, ties broken by position so the order does not depend on timing */
+	template <typename _ty> inline bool less_urgent(const piece<_ty>& x, const piece<_ty>& y)
+	{
+		return x.error < y.error || (x.error == y.error && x.a > y.a);
+	}
+
+	/** the Kronrod rule r and its embedded Gauss rule on [p.a, p.b] */
+	template <typename _ty, typename _fn> inline void evaluate(const gauss::rule& r, _fn& f, piece<_ty>& p)
+	{
+		using std::abs;
+		const _ty h = (p.b - p.a) / _ty(2), c = (p.a + p.b) / _ty(2);
+		_ty k = _ty(0), g = _ty(0);
+		for (std::size_t i = 0; i < r.size(); ++i)
+		{
+			const _ty y = f(c + h * _ty(r.nodes[i]));
+			k += _ty(r.weights[i]) * y;
+			g += _ty(r.gauss_weights[i]) * y;
+		}
+		p.value = h * k;
+		p.error = abs(h * (k - g));
+	}
+
+	/** whether [a,b] can still be bisected in _ty */
+	template <typename _ty> inline bool splittable(const piece<_ty>& p)
+	{
+		const _ty m = p.a + (p.b - p.a) / _ty(2);
+		return m > p.a && m < p.b;
+	}
+
+	/** a worker's deque: the owner pushes and pops at the back, thieves take from the front */
+	template <typename _task> class work_deque
+	{
+	protected:
+		std::mutex lock;
+		std::deque<_task> tasks;
+
+	public:
+		inline void push(const _task& t)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			tasks.push_back(t);
+		}
+		inline bool pop(_task& t)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (tasks.empty())
+				return false;
+			t = tasks.back();
+			tasks.pop_back();
+			return true;
+		}
+		inline bool steal(_task& t)
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			if (tasks.empty())
+				return false;
+			t = tasks.front();
+			tasks.pop_front();
+			return true;
+		}
+	};
+
+	/** pops the own deque of worker id, or steals from the others in turn */
+	template <typename _task> inline bool next_task(std::vector<work_deque<_task>>& deques, const std::size_t id, _task& t, adaptive_thread_stats& stats)
+	{
+		if (deques[id].pop(t))
+			return true;
+		for (std::size_t k = 1; k < deques.size(); ++k)
+			if (deques[(id + k) % deques.size()].steal(t))
+			{
+				++stats.steals;
+				return true;
+			}
+		return false;
+	}
+
+	/** false for infinities and NaN, which end the subdivision in both modes: splitting cannot make them finite */
+	template <typename _ty> inline bool is_finite(const _ty& x)
+	{
+		return x - x == _ty(0);
+	}
+
+	template <typename _ty> inline _ty tolerance(const adaptive_options& opts, const _ty value)
+	{
+		using std::abs;
+		const _ty r = _ty(opts.rel_tolerance) * abs(value);
+		return (r > _ty(opts.abs_tolerance)) ? (r) : (_ty(opts.abs_tolerance));
+	}
+
+	/** the final sums, taken over the intervals in increasing order so they do not depend on the heap layout */
+	template <typename _ty> inline void finish(std::vector<piece<_ty>>& done, const adaptive_options& opts, adaptive_result<_ty>& res)
+	{
+		std::sort(done.begin(), done.end(), [](const piece<_ty>& x, const piece<_ty>& y) { return x.a < y.a; });
+		res.value = res.error = _ty(0);
+		for (const piece<_ty>& p : done)
+		{
+			res.value += p.value;
+			res.error += p.error;
+		}
+		res.intervals = unsigned(done.size());
+		res.converged = (res.error <= tolerance(opts, res.value));
+		res.evaluations = 0;
+		for (const adaptive_thread_stats& s : res.threads)
+			res.evaluations += s.evaluations;
+	}
+
+	/** times one rule application for the statistics */
+	template <typename _ty, typename _fn> inline void timed_evaluate(const gauss::rule& r, _fn& f, piece<_ty>& p, adaptive_thread_stats& stats)
+	{
+		const std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+		evaluate(r, f, p);
+		stats.busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+		stats.evaluations += r.size();
+		++stats.intervals;
+	}
+
+	/**
+	 * free-running workers around one error-ordered heap: a worker whose deque and whose neighbours' deques are empty
+	 * takes the worst interval off the heap, pushes one half to its deque (where idle workers can steal it) and
+	 * evaluates the other. Bisected errors stay counted as pending until both halves are back. A worker with nothing to
+	 * do sleeps until a half is posted or a result comes back.
+	 */
+	template <typename _ty, typename _fn> inline void run_free(_fn& f, const gauss::rule& r, const piece<_ty>& whole, const adaptive_options& opts, adaptive_result<_ty>& res)
+	{
+		const std::size_t T = res.threads.size();
+		std::mutex lock;
+		std::vector<piece<_ty>> heap(1, whole), frozen;
+		std::vector<work_deque<piece<_ty>>> deques(T);
+		_ty value = whole.value, error = whole.error, pending = _ty(0);
+		unsigned int outstanding = 0, waiting = 0;
+		// counts posted halves and returned results, so a worker can tell whether anything happened since it last looked
+		std::atomic<unsigned long> events(0);
+		std::condition_variable idle;
+		bool done = false;
+		res.subdivisions = 0;
+		// called with lock held, after the heap or a deque has changed
+		auto signal = [&]()
+		{
+			++events;
+			if (waiting > 0)
+				idle.notify_all();
+		};
+		auto worker = [&](const std::size_t id)
+		{
+			adaptive_thread_stats& stats = res.threads[id];
+			piece<_ty> p;
+			for (;;)
+			{
+				const unsigned long seen = events.load();
+				if (next_task(deques, id, p, stats))
+				{
+					timed_evaluate(r, f, p, stats);
+					std::lock_guard<std::mutex> guard(lock);
+					heap.push_back(p);
+					std::push_heap(heap.begin(), heap.end(), less_urgent<_ty>);
+					value += p.value;
+					error += p.error;
+					pending -= p.pending;
+					--outstanding;
+					signal();
+					continue;
+				}
+				std::unique_lock<std::mutex> guard(lock);
+				if (done)
+					return;
+				const _ty tol = tolerance(opts, value), total = error + ((pending > _ty(0)) ? (pending) : (_ty(0)));
+				// while halves are out, an interval with only a small part of the excess error is not worth splitting yet
+				const bool minor = outstanding > 0 && !heap.empty() && heap.front().error < (total - tol) / _ty(2 * T);
+				if (!is_finite(total) || total <= tol || res.subdivisions >= opts.max_subdivisions || heap.empty() || minor)
+				{
+					if (outstanding == 0)
+					{
+						done = true;
+						idle.notify_all();
+						return;
+					}
+					++waiting;
+					idle.wait(guard, [&]() { return done || events.load() != seen; });
+					--waiting;
+					continue;
+				}
+				std::pop_heap(heap.begin(), heap.end(), less_urgent<_ty>);
+				const piece<_ty> w = heap.back();
+				heap.pop_back();
+				if (!splittable(w))
+				{
+					// keeps its share of value and error, but is not looked at again
+					frozen.push_back(w);
+					continue;
+				}
+				value -= w.value;
+				error -= w.error;
+				pending += w.error;
+				outstanding += 2;
+				++res.subdivisions;
+				++stats.splits;
+				const _ty m = w.a + (w.b - w.a) / _ty(2);
+				// posted under the lock, so a worker that is about to sleep sees the event
+				deques[id].push(piece<_ty>{ m, w.b, _ty(0), _ty(0), w.error / _ty(2) });
+				signal();
+				guard.unlock();
+				p = piece<_ty>{ w.a, m, _ty(0), _ty(0), w.error / _ty(2) };
+				timed_evaluate(r, f, p, stats);
+				guard.lock();
+				heap.push_back(p);
+				std::push_heap(heap.begin(), heap.end(), less_urgent<_ty>);
+				value += p.value;
+				error += p.error;
+				pending -= p.pending;
+				--outstanding;
+				signal();
+			}
+		};
+		std::vector<std::thread> workers;
+		for (std::size_t id = 1; id < T; ++id)
+			workers.push_back(std::thread(worker, id));
+		worker(0);
+		for (std::thread& t : workers)
+			t.join();
+		heap.insert(heap.end(), frozen.begin(), frozen.end());
+		finish(heap, opts, res);
+	}
+
+	/**
+	 * rounds: the calling thread takes the batch worst intervals off the heap and deals their halves out to the
+	 * deques, all workers drain them (stealing when their own runs dry), and the results go back onto the heap in the
+	 * order they were dealt. Which intervals get split never depends on the thread count or timing.
+	 */
+	template <typename _ty, typename _fn> inline void run_rounds(_fn& f, const gauss::rule& r, const piece<_ty>& whole, const adaptive_options& opts, adaptive_result<_ty>& res)
+	{
+		const std::size_t T = res.threads.size();
+		std::mutex lock;
+		std::condition_variable wake, finished;
+		std::vector<piece<_ty>> heap(1, whole), frozen, tasks;
+		std::vector<work_deque<std::size_t>> deques(T);
+		std::size_t remaining = 0;
+		unsigned long generation = 0;
+		bool stop = false;
+		auto drain = [&](const std::size_t id)
+		{
+			std::size_t t, count = 0;
+			while (next_task(deques, id, t, res.threads[id]))
+			{
+				timed_evaluate(r, f, tasks[t], res.threads[id]);
+				++count;
+			}
+			std::lock_guard<std::mutex> guard(lock);
+			remaining -= count;
+			if (remaining == 0)
+				finished.notify_all();
+		};
+		auto worker = [&](const std::size_t id)
+		{
+			unsigned long seen = 0;
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> guard(lock);
+					wake.wait(guard, [&]() { return stop || generation != seen; });
+					if (stop)
+						return;
+					seen = generation;
+				}
+				drain(id);
+			}
+		};
+		std::vector<std::thread> workers;
+		for (std::size_t id = 1; id < T; ++id)
+			workers.push_back(std::thread(worker, id));
+		_ty value = whole.value, error = whole.error;
+		res.subdivisions = 0;
+		while (is_finite(error) && error > tolerance(opts, value) && !heap.empty() && res.subdivisions < opts.max_subdivisions)
+		{
+			tasks.clear();
+			// beyond the worst one, only intervals holding a fair share of the excess error are worth splitting
+			const _ty share = (error - tolerance(opts, value)) / _ty(2 * opts.batch);
+			for (unsigned int k = 0; k < opts.batch && !heap.empty() && res.subdivisions < opts.max_subdivisions && (k == 0 || heap.front().error >= share); ++k)
+			{
+				std::pop_heap(heap.begin(), heap.end(), less_urgent<_ty>);
+				const piece<_ty> w = heap.back();
+				heap.pop_back();
+				if (!splittable(w))
+				{
+					frozen.push_back(w);
+					continue;
+				}
+				value -= w.value;
+				error -= w.error;
+				++res.subdivisions;
+				++res.threads[0].splits;
+				const _ty m = w.a + (w.b - w.a) / _ty(2);
+				tasks.push_back(piece<_ty>{ w.a, m, _ty(0), _ty(0), _ty(0) });
+				tasks.push_back(piece<_ty>{ m, w.b, _ty(0), _ty(0), _ty(0) });
+			}
+			if (tasks.empty())
+				continue;
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				for (std::size_t t = 0; t < tasks.size(); ++t)
+					deques[t % T].push(t);
+				remaining = tasks.size();
+				++generation;
+			}
+			wake.notify_all();
+			drain(0);
+			{
+				std::unique_lock<std::mutex> guard(lock);
+				finished.wait(guard, [&]() { return remaining == 0; });
+			}
+			for (const piece<_ty>& p : tasks)
+			{
+				heap.push_back(p);
+				std::push_heap(heap.begin(), heap.end(), less_urgent<_ty>);
+				value += p.value;
+				error += p.error;
+			}
+		}
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			stop = true;
+		}
+		wake.notify_all();
+		for (std::thread& t : workers)
+			t.join();
+		heap.insert(heap.end(), frozen.begin(), frozen.end());
+		finish(heap, opts, res);
+	}
+
+}
+
+
+/**
+ * Adaptive integration of f over [a,b] with a Gauss-Kronrod pair (7-15 or 10-21 points, see adaptive_options): the
+ * subintervals sit in a heap ordered by their error estimate, and the worst ones are bisected until the summed
+ * estimate meets the tolerance. With more than one thread the bisected halves are spread over per-worker deques with
+ * work stealing; f is then called concurrently and has to be thread-safe. The result carries the work counters of
+ * every worker.
+ */
+template <typename _ty, typename _fn> inline adaptive_result<_ty> integrate_adaptive(_fn&& f, const _ty a, const _ty b, const adaptive_options& opts = adaptive_options())
+{
+	adaptive_result<_ty> res;
+	res.threads.assign(parallel::resolve_threads(opts.threads), adaptive_thread_stats());
+	const gauss::rule* rp = gauss::get(gauss::family::kronrod, (opts.points == 10) ? (10) : (7));
+	if (rp == nullptr)
+	{
+		// the rule could not be made (see gauss::make_rule())
+		res.value = res.error = _ty(std::numeric_limits<double>::quiet_NaN());
+		res.converged = false;
+		res.evaluations = 0;
+		res.subdivisions = res.intervals = 0;
+		return res;
+	}
+	const gauss::rule& r = *rp;
+	adaptive::piece<_ty> whole{ a, b, _ty(0), _ty(0), _ty(0) };
+	adaptive::timed_evaluate(r, f, whole, res.threads[0]);
+	if (opts.deterministic)
+		adaptive::run_rounds(f, r, whole, opts, res);
+	else
+		adaptive::run_free(f, r, whole, opts, res);
+	return res;
+}
+
+#endif
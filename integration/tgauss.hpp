@@ -0,0 +1,506 @@
+#ifndef _FHP_TGAUSS_HPP_INCLUDED_
+#define _FHP_TGAUSS_HPP_INCLUDED_
+
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include "../util/tpolyeval.hpp"
+
+
+namespace gauss
+{
+
+	/**
+	 * quadrature families, with the weight function and interval they integrate against:
+	 * legendre 1 on [-1,1], laguerre e^-x on [0,inf), hermite e^-x^2 on (-inf,inf),
+	 * kronrod the 2n+1 point Gauss-Kronrod extension of the n point Gauss-Legendre rule
+	 */
+	enum class family { legendre, laguerre, hermite, kronrod };
+
+	/** nodes in increasing order and their weights; rules are made by get() and shared, so they are never modified */
+	struct rule
+	{
+		family kind;
+		/** number of Gauss points (a Kronrod rule has 2n+1 nodes) */
+		unsigned int n;
+		std::vector<double> nodes, weights;
+		/** kronrod only: weights of the embedded Gauss rule on the same nodes, zero at the added ones */
+		std::vector<double> gauss_weights;
+
+		inline std::size_t size() const { return nodes.size(); }
+	};
+
+
+	/// three-term recurrences of the orthonormal polynomials: sqrt(beta[k+1])*p[k+1] = (x - alpha[k])*p[k] - sqrt(beta[k])*p[k-1]
+	/** alpha[k], beta[k] for k < m of family f (legendre for kronrod); beta[0] is the integral of the weight function */
+	inline void recurrence(const family f, const std::size_t m, double* alpha, double* beta)
+	{
+		for (std::size_t k = 0; k < m; ++k)
+		{
+			const double dk = double(k);
+			switch (f)
+			{
+			case family::laguerre:
+				alpha[k] = 2.0 * dk + 1.0;
+				beta[k] = (k == 0) ? (1.0) : (dk * dk);
+				break;
+			case family::hermite:
+				alpha[k] = 0.0;
+				beta[k] = (k == 0) ? (std::sqrt(3.14159265358979323846)) : (0.5 * dk);
+				break;
+			default:
+				alpha[k] = 0.0;
+				beta[k] = (k == 0) ? (2.0) : (dk * dk / (4.0 * dk * dk - 1.0));
+				break;
+			}
+		}
+	}
+
+	/**
+	 * p_n(x) of the orthonormal polynomials (alpha, beta with n+1 entries) and its derivative in *d, and in *sum the sum
+	 * of p_k(x)^2 for k < n, whose reciprocal is the Gauss weight (Christoffel function) at a node; O(n)
+	 */
+	inline double orthonormal(const double* alpha, const double* beta, const std::size_t n, const double x, double* d, double* sum)
+	{
+		double p0 = 0.0, p1 = 1.0 / std::sqrt(beta[0]);
+		double d0 = 0.0, d1 = 0.0, s = 0.0;
+		for (std::size_t k = 0; k < n; ++k)
+		{
+			s += p1 * p1;
+			const double rb = 1.0 / std::sqrt(beta[k + 1]);
+			const double sb = (k > 0) ? (std::sqrt(beta[k])) : (0.0);
+			const double p2 = ((x - alpha[k]) * p1 - sb * p0) * rb;
+			const double d2 = (p1 + (x - alpha[k]) * d1 - sb * d0) * rb;
+			p0 = p1;
+			p1 = p2;
+			d0 = d1;
+			d1 = d2;
+		}
+		if (d)
+			*d = d1;
+		if (sum)
+			*sum = s;
+		return p1;
+	}
+
+	/**
+	 * eigenvalues of the symmetric tridiagonal matrix with diagonal d[0..n-1] and off-diagonal e[1..n-1] (e[0] unused) by
+	 * implicit QL iterations; z[0..n-1] comes in as the first row of the identity and leaves as the first components of
+	 * the normalized eigenvectors (Golub-Welsch). O(n^2). Returns false if an eigenvalue did not converge.
+	 */
+	inline bool tridiagonal_eigen(double* d, double* e, double* z, const std::size_t n)
+	{
+		for (std::size_t i = 1; i < n; ++i)
+			e[i - 1] = e[i];
+		if (n > 0)
+			e[n - 1] = 0.0;
+		for (std::size_t l = 0; l < n; ++l)
+		{
+			unsigned int iter = 0;
+			std::size_t m;
+			do
+			{
+				for (m = l; m + 1 < n; ++m)
+				{
+					const double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+					if (std::abs(e[m]) <= 1e-17 * dd)
+						break;
+				}
+				if (m != l)
+				{
+					if (iter++ == 60)
+						return false;
+					double g = (d[l + 1] - d[l]) / (2.0 * e[l]);
+					double r = std::hypot(g, 1.0);
+					g = d[m] - d[l] + e[l] / (g + ((g >= 0.0) ? (r) : (-r)));
+					double s = 1.0, c = 1.0, p = 0.0;
+					std::size_t i = m;
+					bool underflow = false;
+					while (i-- > l)
+					{
+						double f = s * e[i];
+						const double b = c * e[i];
+						r = std::hypot(f, g);
+						e[i + 1] = r;
+						if (r == 0.0)
+						{
+							d[i + 1] -= p;
+							e[m] = 0.0;
+							underflow = true;
+							break;
+						}
+						s = f / r;
+						c = g / r;
+						g = d[i + 1] - p;
+						r = (d[i] - g) * s + 2.0 * c * b;
+						p = s * r;
+						d[i + 1] = g + p;
+						g = c * r - b;
+						f = z[i + 1];
+						z[i + 1] = s * z[i] + c * f;
+						z[i] = c * z[i] - s * f;
+					}
+					if (underflow)
+						continue;
+					d[l] -= p;
+					e[l] = g;
+					e[m] = 0.0;
+				}
+			} while (m != l);
+		}
+		return true;
+	}
+
+	/** sorts nodes increasingly, carrying the weights along */
+	inline void sort_rule(std::vector<double>& x, std::vector<double>& w)
+	{
+		std::vector<std::size_t> order(x.size());
+		for (std::size_t i = 0; i < order.size(); ++i)
+			order[i] = i;
+		std::sort(order.begin(), order.end(), [&x](const std::size_t a, const std::size_t b) { return x[a] < x[b]; });
+		std::vector<double> xs(x.size()), ws(w.size());
+		for (std::size_t i = 0; i < order.size(); ++i)
+		{
+			xs[i] = x[order[i]];
+			ws[i] = w[order[i]];
+		}
+		x.swap(xs);
+		w.swap(ws);
+	}
+
+	/**
+	 * n point Gauss-Legendre rule by Newton's method on the recurrence from the asymptotic guesses
+	 * cos(pi*(i+3/4)/(n+1/2)); O(n) per node, symmetric nodes are mirrored
+	 */
+	inline void make_legendre(const unsigned int n, std::vector<double>& x, std::vector<double>& w)
+	{
+		const double pi = 3.14159265358979323846;
+		std::vector<double> alpha(n + 1), beta(n + 1);
+		recurrence(family::legendre, n + 1, alpha.data(), beta.data());
+		x.assign(n, 0.0);
+		w.assign(n, 0.0);
+		for (unsigned int i = 0; i < (n + 1) / 2; ++i)
+		{
+			double t = std::cos(pi * (double(i) + 0.75) / (double(n) + 0.5)), d, s;
+			for (int it = 0; it < 100; ++it)
+			{
+				const double dt = orthonormal(alpha.data(), beta.data(), n, t, &d, nullptr) / d;
+				t -= dt;
+				if (std::abs(dt) <= 1e-16)
+					break;
+			}
+			orthonormal(alpha.data(), beta.data(), n, t, &d, &s);
+			// the middle node of odd rules is exactly 0
+			if (2 * i + 1 == n)
+				t = 0.0;
+			x[i] = -t;
+			x[n - 1 - i] = t;
+			w[i] = w[n - 1 - i] = 1.0 / s;
+		}
+	}
+
+	/**
+	 * n point rule of family f from the eigenvalues of its Jacobi matrix (Golub-Welsch), polished by one Newton step;
+	 * returns false (with x and w unspecified) if the eigenvalue iteration did not converge
+	 */
+	inline bool make_golub_welsch(const family f, const unsigned int n, std::vector<double>& x, std::vector<double>& w)
+	{
+		std::vector<double> alpha(n + 1), beta(n + 1), e(n), z(n, 0.0);
+		recurrence(f, n + 1, alpha.data(), beta.data());
+		x.assign(alpha.begin(), alpha.begin() + n);
+		for (unsigned int i = 1; i < n; ++i)
+			e[i] = std::sqrt(beta[i]);
+		z[0] = 1.0;
+		if (!tridiagonal_eigen(x.data(), e.data(), z.data(), n))
+			return false;
+		w.assign(n, 0.0);
+		for (unsigned int i = 0; i < n; ++i)
+		{
+			double d, s;
+			const double p = orthonormal(alpha.data(), beta.data(), n, x[i], &d, nullptr);
+			if (d != 0.0 && std::abs(p / d) < 1e-3 * (1.0 + std::abs(x[i])))
+				x[i] -= p / d;
+			orthonormal(alpha.data(), beta.data(), n, x[i], &d, &s);
+			// the Christoffel sum is accurate where the eigenvector components underflow
+			w[i] = (s > 0.0) ? (1.0 / s) : (beta[0] * z[i] * z[i]);
+		}
+		sort_rule(x, w);
+		return true;
+	}
+
+	/**
+	 * 2n+1 point Gauss-Kronrod rule: Laurie's algorithm extends the Jacobi matrix of the Legendre weight to the
+	 * Jacobi-Kronrod matrix in O(n^2), whose eigenvalues are the nodes and whose first eigenvector components give the
+	 * weights. The embedded Gauss weights are placed on the nodes 1, 3, ..., 2n-1. Returns false if the eigenvalue
+	 * iteration did not converge.
+	 */
+	inline bool make_kronrod(const unsigned int n, std::vector<double>& x, std::vector<double>& w, std::vector<double>& wg)
+	{
+		const std::size_t N = n, len = 3 * N / 2 + 2;
+		std::vector<double> a0(len + 1), b0(len + 1);
+		recurrence(family::legendre, len + 1, a0.data(), b0.data());
+		// 1-based as in Laurie's paper: a(i) = av[i], b(i) = bv[i]
+		std::vector<double> av(2 * N + 3, 0.0), bv(2 * N + 3, 0.0), sv(N + 6, 0.0), tv(N + 6, 0.0), tmp(N + 6);
+		for (std::size_t k = 0; k <= 3 * N / 2; ++k)
+			av[k + 1] = a0[k];
+		for (std::size_t k = 0; k <= (3 * N + 1) / 2; ++k)
+			bv[k + 1] = b0[k];
+		double* s = sv.data();
+		double* t = tv.data();
+		t[2] = bv[N + 2];
+		for (std::size_t m = 0; m + 2 <= N; ++m)
+		{
+			double acc = 0.0;
+			for (std::size_t k = (m + 1) / 2 + 1; k-- > 0;)
+			{
+				const std::size_t l = m - k;
+				acc += (av[k + N + 2] - av[l + 1]) * t[k + 2] + bv[k + N + 2] * s[k + 1] - bv[l + 1] * s[k + 2];
+				tmp[k] = acc;
+			}
+			for (std::size_t k = 0; k <= (m + 1) / 2; ++k)
+				s[k + 2] = tmp[k];
+			std::swap(s, t);
+		}
+		for (std::size_t j = N / 2 + 1; j-- > 0;)
+			s[j + 2] = s[j + 1];
+		for (std::size_t m = N - 1; m + 3 <= 2 * N; ++m)
+		{
+			double acc = 0.0;
+			std::size_t j = 0;
+			const std::size_t k0 = m + 1 - N, k1 = (m - 1) / 2;
+			for (std::size_t k = k0; k <= k1; ++k)
+			{
+				const std::size_t l = m - k;
+				j = N - 1 - l;
+				acc += -(av[k + N + 2] - av[l + 1]) * t[j + 2] - bv[k + N + 2] * s[j + 2] + bv[l + 1] * s[j + 3];
+				tmp[k - k0] = acc;
+			}
+			for (std::size_t k = k0; k <= k1; ++k)
+				s[N - 1 - (m - k) + 2] = tmp[k - k0];
+			const std::size_t k = (m + 1) / 2;
+			if (m % 2 == 0)
+				av[k + N + 2] = av[k + 1] + (s[j + 2] - bv[k + N + 2] * s[j + 3]) / t[j + 2];
+			else
+				bv[k + N + 2] = s[j + 2] / s[j + 3];
+			std::swap(s, t);
+		}
+		av[2 * N + 1] = av[N] - bv[2 * N + 1] * s[2] / t[2];
+
+		const std::size_t K = 2 * N + 1;
+		std::vector<double> e(K), z(K, 0.0);
+		x.assign(K, 0.0);
+		for (std::size_t i = 0; i < K; ++i)
+			x[i] = av[i + 1];
+		for (std::size_t i = 1; i < K; ++i)
+			e[i] = std::sqrt(bv[i + 1]);
+		z[0] = 1.0;
+		if (!tridiagonal_eigen(x.data(), e.data(), z.data(), K))
+			return false;
+		w.assign(K, 0.0);
+		for (std::size_t i = 0; i < K; ++i)
+			w[i] = bv[1] * z[i] * z[i];
+		sort_rule(x, w);
+		// symmetric by construction; averaging removes the rounding asymmetry and puts the middle node on 0
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			const double xm = 0.5 * (x[K - 1 - i] - x[i]), wm = 0.5 * (w[K - 1 - i] + w[i]);
+			x[i] = -xm;
+			x[K - 1 - i] = xm;
+			w[i] = w[K - 1 - i] = wm;
+		}
+		x[N] = 0.0;
+		std::vector<double> xg, wgs;
+		make_legendre(n, xg, wgs);
+		wg.assign(K, 0.0);
+		for (std::size_t i = 0; i < N; ++i)
+		{
+			// the Gauss nodes are the more accurate ones
+			x[2 * i + 1] = xg[i];
+			wg[2 * i + 1] = wgs[i];
+		}
+		return true;
+	}
+
+	/** builds a rule without consulting the cache; null if its eigenvalue iteration did not converge */
+	inline std::unique_ptr<rule> make_rule(const family f, const unsigned int n)
+	{
+		std::unique_ptr<rule> r(new rule());
+		r->kind = f;
+		r->n = n;
+		if (n == 0)
+			return r;
+		bool ok = true;
+		switch (f)
+		{
+		case family::legendre:
+			make_legendre(n, r->nodes, r->weights);
+			break;
+		case family::kronrod:
+			ok = make_kronrod(n, r->nodes, r->weights, r->gauss_weights);
+			break;
+		default:
+			ok = make_golub_welsch(f, n, r->nodes, r->weights);
+			break;
+		}
+		if (!ok)
+			r.reset();
+		return r;
+	}
+
+
+	/** process-wide store of the rules made so far, keyed by (family, n) */
+	class cache
+	{
+	protected:
+		std::mutex lock;
+		std::map<std::pair<family, unsigned int>, std::unique_ptr<rule>> rules;
+
+	public:
+		/**
+		 * the rule (f, n), made on first use; the pointer stays valid for the lifetime of the process. Null if the rule
+		 * could not be made (see make_rule()); failures are not cached.
+		 */
+		inline const rule* get(const family f, const unsigned int n)
+		{
+			const std::pair<family, unsigned int> key(f, n);
+			{
+				std::lock_guard<std::mutex> guard(lock);
+				auto it = rules.find(key);
+				if (it != rules.end())
+					return it->second.get();
+			}
+			// made outside the lock, so other rules can be looked up meanwhile; a thread losing the race drops its copy
+			std::unique_ptr<rule> made = make_rule(f, n);
+			if (!made)
+				return nullptr;
+			std::lock_guard<std::mutex> guard(lock);
+			return rules.emplace(key, std::move(made)).first->second.get();
+		}
+		inline std::size_t size()
+		{
+			std::lock_guard<std::mutex> guard(lock);
+			return rules.size();
+		}
+	};
+
+	inline cache& global_cache()
+	{
+		static cache c;
+		return c;
+	}
+
+	/** the cached rule (f, n), null if it could not be made */
+	inline const rule* get(const family f, const unsigned int n)
+	{
+		return global_cache().get(f, n);
+	}
+
+
+	/// batched application: sums[j] += w * values[j] for j < m
+	template <typename _ty> inline void accumulate(const double w, const _ty* values, _ty* sums, const std::size_t m, const std::false_type&)
+	{
+		for (std::size_t j = 0; j < m; ++j)
+			sums[j] += _ty(w) * values[j];
+	}
+#ifdef _FHP_POLYEVAL_SIMD_
+	inline void accumulate(const double w, const double* values, double* sums, const std::size_t m, const std::true_type&)
+	{
+		typedef polyeval::simd_double v;
+		const std::size_t width = v::width;
+		const v::reg vw = v::set1(w);
+		std::size_t j = 0;
+		for (; j + width <= m; j += width)
+			v::store(sums + j, v::fmadd(vw, v::load(values + j), v::load(sums + j)));
+		for (; j < m; ++j)
+			sums[j] += w * values[j];
+	}
+#endif
+
+	/**
+	 * integrals of m integrands at once: f(x, values) writes the m integrand values at x, and sums[j] gets
+	 * scale * sum w[i]*values_j(shift + scale*x[i]) over the rule (the Gauss rule of a Kronrod rule in gauss_sums, if not null).
+	 * One call of f per node; the weighted sums run over the integrands in vector registers.
+	 */
+	template <typename _ty, typename _fn> inline void apply(const rule& r, _fn&& f, const std::size_t m, _ty* sums, const _ty shift = _ty(0), const _ty scale = _ty(1), _ty* gauss_sums = nullptr)
+	{
+		std::vector<_ty> values(m);
+		for (std::size_t j = 0; j < m; ++j)
+			sums[j] = _ty(0);
+		const bool embedded = (gauss_sums != nullptr && !r.gauss_weights.empty());
+		if (embedded)
+			for (std::size_t j = 0; j < m; ++j)
+				gauss_sums[j] = _ty(0);
+		for (std::size_t i = 0; i < r.size(); ++i)
+		{
+			f(shift + scale * _ty(r.nodes[i]), values.data());
+			accumulate(r.weights[i], values.data(), sums, m, polyeval::use_simd<_ty>());
+			if (embedded && r.gauss_weights[i] != 0.0)
+				accumulate(r.gauss_weights[i], values.data(), gauss_sums, m, polyeval::use_simd<_ty>());
+		}
+		for (std::size_t j = 0; j < m; ++j)
+			sums[j] *= scale;
+		if (embedded)
+			for (std::size_t j = 0; j < m; ++j)
+				gauss_sums[j] *= scale;
+	}
+
+	/** sum w[i]*f(x[i]) over the rule, on its own interval and weight function */
+	template <typename _ty = double, typename _fn> inline _ty integrate(const rule& r, _fn&& f)
+	{
+		_ty s = _ty(0);
+		for (std::size_t i = 0; i < r.size(); ++i)
+			s += _ty(r.weights[i]) * f(_ty(r.nodes[i]));
+		return s;
+	}
+
+	/** integral of f over [a,b] by the n point Gauss-Legendre rule */
+	template <typename _ty, typename _fn> inline _ty integrate(_fn&& f, const _ty a, const _ty b, const unsigned int n)
+	{
+		// Legendre rules come from Newton's method, not from the eigenvalue iteration, so they are always made
+		const rule& r = *get(family::legendre, n);
+		const _ty h = (b - a) / _ty(2), c = (a + b) / _ty(2);
+		_ty s = _ty(0);
+		for (std::size_t i = 0; i < r.size(); ++i)
+			s += _ty(r.weights[i]) * f(c + h * _ty(r.nodes[i]));
+		return h * s;
+	}
+
+	/**
+	 * integral of f over [a,b] by the 2n+1 point Gauss-Kronrod rule; *error gets |Kronrod - Gauss|, the usual
+	 * (pessimistic) estimate of the error of the Kronrod result. Both are NaN if the rule could not be made.
+	 */
+	template <typename _ty, typename _fn> inline _ty integrate_kronrod(_fn&& f, const _ty a, const _ty b, const unsigned int n, _ty* error = nullptr)
+	{
+		using std::abs;
+		const rule* rp = get(family::kronrod, n);
+		if (rp == nullptr)
+		{
+			const _ty nan = _ty(std::numeric_limits<double>::quiet_NaN());
+			if (error)
+				*error = nan;
+			return nan;
+		}
+		const rule& r = *rp;
+		const _ty h = (b - a) / _ty(2), c = (a + b) / _ty(2);
+		_ty k = _ty(0), g = _ty(0);
+		for (std::size_t i = 0; i < r.size(); ++i)
+		{
+			const _ty y = f(c + h * _ty(r.nodes[i]));
+			k += _ty(r.weights[i]) * y;
+			g += _ty(r.gauss_weights[i]) * y;
+		}
+		if (error)
+			*error = abs(h * (k - g));
+		return h * k;
+	}
+
+}
+
+#endif
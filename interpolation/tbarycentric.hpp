@@ -0,0 +1,230 @@
+#ifndef _FHP_TBARYCENTRIC_HPP_INCLUDED_
+#define _FHP_TBARYCENTRIC_HPP_INCLUDED_
+
+#include <vector>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <algorithm>
+#include "../util/tpolynomial.hpp"
+#include "../util/tparallel.hpp"
+
+
+/**
+ * Lagrange interpolant in the second (true) barycentric form
+ *   p(t) = sum(w[j]*y[j]/(t-x[j])) / sum(w[j]/(t-x[j])),  w[j] ~ 1/prod_{k!=j}(x[j]-x[k])
+ * The form does not change when all weights share a factor, so they are kept scaled with the largest |w[j]| near 1:
+ * the raw products over- or underflow from about a thousand Chebyshev points on. Setup is O(n^2), evaluation and adding
+ * a node are O(n).
+ */
+template <typename _ty> class Barycentric
+{
+protected:
+	std::vector<_ty> x, y, w;
+	/** w[j] = 2^shift / prod_{k!=j}((x[j]-x[k])/scale): the differences are scaled by the capacity of the nodes' interval at assign(), and normalize() keeps the largest weight in [1/2, 1) by exact powers of two */
+	_ty scale;
+	int shift;
+
+public:
+	typedef _ty value_type;
+	/** creates an interpolant without nodes */
+	inline Barycentric() : scale(1), shift(0) {}
+	/** creates the interpolant through (xs[j], ys[j]), j < n */
+	inline Barycentric(const _ty* xs, const _ty* ys, const std::size_t n)
+	{
+		assign(xs, ys, n);
+	}
+	inline Barycentric(const std::vector<_ty>& xs, const std::vector<_ty>& ys)
+	{
+		assign(xs.data(), ys.data(), xs.size());
+	}
+	inline ~Barycentric() {}
+
+	/** replaces all nodes and recomputes the weights, O(n^2) */
+	inline Barycentric<_ty>& assign(const _ty* xs, const _ty* ys, const std::size_t n)
+	{
+		x.assign(xs, xs + n);
+		y.assign(ys, ys + n);
+		w.assign(n, _ty(1));
+		scale = interpolation_scale(xs, n);
+		// the partial products pass through far larger and smaller values than the final ones, so each is kept as w[j]*2^e[j]
+		std::vector<int> e(n, 0);
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			for (std::size_t k = 0; k < j; ++k)
+			{
+				const _ty d = (x[j] - x[k]) / scale;
+				w[j] *= d;
+				w[k] *= -d;
+				rebalance(w[j], e[j]);
+				rebalance(w[k], e[k]);
+			}
+		}
+		int top = std::numeric_limits<int>::min();
+		for (std::size_t j = 0; j < n; ++j)
+		{
+			w[j] = _ty(1) / w[j];
+			e[j] = -e[j];
+			if (w[j] != _ty(0))
+				top = std::max(top, std::ilogb(w[j]) + e[j]);
+		}
+		shift = (n == 0) ? (0) : (-top - 1);
+		for (std::size_t j = 0; j < n; ++j)
+			w[j] = std::ldexp(w[j], e[j] + shift);
+		return *this;
+	}
+	/** reserves storage for n nodes */
+	inline Barycentric<_ty>& reserve(const std::size_t n)
+	{
+		x.reserve(n);
+		y.reserve(n);
+		w.reserve(n);
+		return *this;
+	}
+	/**
+	 * adds the node (xn, yn) and updates the weights, O(n). Every intermediate set of nodes has its own weights, and
+	 * those of a set crowded at one end (say, Chebyshev points added in sorted order) can span more than the exponent
+	 * range of _ty, which loses the smallest for good: add nodes in an order that keeps each set spread out.
+	 */
+	inline Barycentric<_ty>& add_node(const _ty xn, const _ty yn)
+	{
+		// the product for the new weight as p*2^e, so that it cannot leave the range of _ty on the way
+		_ty p = _ty(1);
+		int e = 0;
+		for (std::size_t j = 0; j < x.size(); ++j)
+		{
+			const _ty d = (x[j] - xn) / scale;
+			w[j] /= d;
+			p *= -d;
+			rebalance(p, e);
+		}
+		x.push_back(xn);
+		y.push_back(yn);
+		w.push_back(std::ldexp(_ty(1) / p, shift - e));
+		return normalize();
+	}
+	/** replaces the value at node j; the weights do not depend on it */
+	inline Barycentric<_ty>& set_value(const std::size_t j, const _ty yj)
+	{
+		y[j] = yj;
+		return *this;
+	}
+
+	/** evaluates the interpolant, O(n) */
+	template <typename aux> inline _ty operator()(const aux t) const
+	{
+		const _ty tv = _ty(t);
+		_ty num = _ty(0), den = _ty(0);
+		for (std::size_t j = 0; j < x.size(); ++j)
+		{
+			const _ty d = tv - x[j];
+			if (d == _ty(0))
+				return y[j];
+			const _ty c = w[j] / d;
+			num += c * y[j];
+			den += c;
+		}
+		return (x.size() == 0) ? (_ty(0)) : (num / den);
+	}
+	/** evaluates the interpolant at n points, ys[k] = p(ts[k]); the range is split over the given number of threads (0: one per hardware thread) */
+	inline void evaluate(const _ty* ts, _ty* ys, const std::size_t n, const unsigned int threads = 1) const
+	{
+		parallel::for_ranges(n, threads, [=](const std::size_t begin, const std::size_t end)
+		{
+			evaluate_range(ts + begin, ys + begin, end - begin);
+		}, 256);
+	}
+	inline std::vector<_ty> evaluate(const std::vector<_ty>& ts, const unsigned int threads = 1) const
+	{
+		std::vector<_ty> ys(ts.size());
+		evaluate(ts.data(), ys.data(), ts.size(), threads);
+		return ys;
+	}
+
+	/** converts the interpolant to monomial form, O(n^2); note that the monomial basis is far worse conditioned */
+	inline Polynomial<_ty> to_polynomial() const
+	{
+		Polynomial<_ty> res;
+		interpolate_lagrange(x.data(), y.data(), x.size(), &res);
+		return res;
+	}
+
+	inline std::size_t size() const { return x.size(); }
+	inline const std::vector<_ty>& nodes() const { return x; }
+	inline const std::vector<_ty>& values() const { return y; }
+	/** the barycentric weights, up to a common factor (the largest has modulus in [1/2, 1)) */
+	inline const std::vector<_ty>& weights() const { return w; }
+
+protected:
+	/** keeps m*2^e in range: m is brought to [1/2, 1) once it is far from 1 */
+	static inline void rebalance(_ty& m, int& e)
+	{
+		const _ty far = _ty(1.157920892373162e77); // 2^256
+		if (std::abs(m) > far || std::abs(m) * far < _ty(1))
+		{
+			int k;
+			m = std::frexp(m, &k);
+			e += k;
+		}
+	}
+	/** scales the weights by a power of two (exactly) so that the largest modulus is in [1/2, 1) */
+	inline Barycentric<_ty>& normalize()
+	{
+		_ty m = _ty(0);
+		for (const _ty& v : w)
+			m = (m < std::abs(v)) ? (std::abs(v)) : (m);
+		if (!(m > _ty(0)) || !std::isfinite(m))
+			return *this;
+		int k;
+		std::frexp(m, &k);
+		for (_ty& v : w)
+			v = std::ldexp(v, -k);
+		shift -= k;
+		return *this;
+	}
+
+	/** four points at a time, so the divisions of neighbouring points overlap */
+	inline void evaluate_range(const _ty* ts, _ty* ys, const std::size_t n) const
+	{
+		const std::size_t m = x.size();
+		std::size_t k = 0;
+		for (; k + 4 <= n; k += 4)
+		{
+			_ty n0 = _ty(0), n1 = _ty(0), n2 = _ty(0), n3 = _ty(0);
+			_ty d0 = _ty(0), d1 = _ty(0), d2 = _ty(0), d3 = _ty(0);
+			std::size_t j = 0;
+			for (; j < m; ++j)
+			{
+				const _ty e0 = ts[k] - x[j], e1 = ts[k + 1] - x[j], e2 = ts[k + 2] - x[j], e3 = ts[k + 3] - x[j];
+				if (e0 == _ty(0) || e1 == _ty(0) || e2 == _ty(0) || e3 == _ty(0))
+					break;
+				const _ty c0 = w[j] / e0, c1 = w[j] / e1, c2 = w[j] / e2, c3 = w[j] / e3;
+				n0 += c0 * y[j];
+				n1 += c1 * y[j];
+				n2 += c2 * y[j];
+				n3 += c3 * y[j];
+				d0 += c0;
+				d1 += c1;
+				d2 += c2;
+				d3 += c3;
+			}
+			if (j < m || m == 0)
+			{
+				// a point coincides with a node: fall back to the scalar path for this block
+				for (std::size_t i = 0; i < 4; ++i)
+					ys[k + i] = this->operator()(ts[k + i]);
+				continue;
+			}
+			ys[k] = n0 / d0;
+			ys[k + 1] = n1 / d1;
+			ys[k + 2] = n2 / d2;
+			ys[k + 3] = n3 / d3;
+		}
+		for (; k < n; ++k)
+			ys[k] = this->operator()(ts[k]);
+	}
+};
+
+typedef Barycentric<double> barycentricd;
+
+#endif
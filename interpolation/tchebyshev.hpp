@@ -0,0 +1,462 @@
+#ifndef _FHP_TCHEBYSHEV_HPP_INCLUDED_
+#define _FHP_TCHEBYSHEV_HPP_INCLUDED_
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include "../util/tpolynomial.hpp"
+#include "../util/tconvolution.hpp"
+#include "../util/tpolyeval.hpp"
+#include "../util/tparallel.hpp"
+
+
+namespace chebyshev
+{
+
+	/// Clenshaw's recurrence b[k] = c[k] + 2t*b[k+1] - b[k+2], sum = c[0] + t*b[1] - b[2]
+	/** sum c[k]*T_k(t) for k < n, n >= 1 */
+	template <typename _ty> inline _ty clenshaw(const _ty* c, const std::size_t n, const _ty t)
+	{
+		_ty b1 = _ty(0), b2 = _ty(0);
+		const _ty t2 = t + t;
+		for (std::size_t k = n - 1; k > 0; --k)
+		{
+			const _ty b0 = c[k] + t2 * b1 - b2;
+			b2 = b1;
+			b1 = b0;
+		}
+		return c[0] + t * b1 - b2;
+	}
+
+	/** ys[j] = sum c[k]*T_k(alpha*xs[j] + beta) for j < m, four interleaved recurrences */
+	template <typename _ty> inline void clenshaw(const _ty* c, const std::size_t n, const _ty alpha, const _ty beta, const _ty* xs, _ty* ys, const std::size_t m)
+	{
+		std::size_t j = 0;
+		for (; j + 4 <= m; j += 4)
+		{
+			const _ty t0 = alpha * xs[j] + beta, t1 = alpha * xs[j + 1] + beta, t2 = alpha * xs[j + 2] + beta, t3 = alpha * xs[j + 3] + beta;
+			_ty a0 = _ty(0), a1 = _ty(0), a2 = _ty(0), a3 = _ty(0);
+			_ty b0 = _ty(0), b1 = _ty(0), b2 = _ty(0), b3 = _ty(0);
+			for (std::size_t k = n - 1; k > 0; --k)
+			{
+				const _ty u0 = c[k] + (t0 + t0) * a0 - b0;
+				const _ty u1 = c[k] + (t1 + t1) * a1 - b1;
+				const _ty u2 = c[k] + (t2 + t2) * a2 - b2;
+				const _ty u3 = c[k] + (t3 + t3) * a3 - b3;
+				b0 = a0; b1 = a1; b2 = a2; b3 = a3;
+				a0 = u0; a1 = u1; a2 = u2; a3 = u3;
+			}
+			ys[j] = c[0] + t0 * a0 - b0;
+			ys[j + 1] = c[0] + t1 * a1 - b1;
+			ys[j + 2] = c[0] + t2 * a2 - b2;
+			ys[j + 3] = c[0] + t3 * a3 - b3;
+		}
+		for (; j < m; ++j)
+			ys[j] = clenshaw(c, n, alpha * xs[j] + beta);
+	}
+
+#ifdef _FHP_POLYEVAL_SIMD_
+	/** the batched recurrence over blocks of 2 registers of points */
+	inline void clenshaw_simd(const double* c, const std::size_t n, const double alpha, const double beta, const double* xs, double* ys, const std::size_t m)
+	{
+		typedef polyeval::simd_double v;
+		const std::size_t w = v::width;
+		const v::reg va = v::set1(alpha), vb = v::set1(beta);
+		std::size_t j = 0;
+		for (; j + 2 * w <= m; j += 2 * w)
+		{
+			const v::reg t0 = v::fmadd(va, v::load(xs + j), vb), t1 = v::fmadd(va, v::load(xs + j + w), vb);
+			const v::reg s0 = v::add(t0, t0), s1 = v::add(t1, t1);
+			v::reg a0 = v::set1(0.0), a1 = a0, b0 = a0, b1 = a0;
+			for (std::size_t k = n - 1; k > 0; --k)
+			{
+				const v::reg ck = v::set1(c[k]);
+				const v::reg u0 = v::fmadd(s0, a0, v::sub(ck, b0));
+				const v::reg u1 = v::fmadd(s1, a1, v::sub(ck, b1));
+				b0 = a0;
+				b1 = a1;
+				a0 = u0;
+				a1 = u1;
+			}
+			const v::reg c0 = v::set1(c[0]);
+			v::store(ys + j, v::fmadd(t0, a0, v::sub(c0, b0)));
+			v::store(ys + j + w, v::fmadd(t1, a1, v::sub(c0, b1)));
+		}
+		clenshaw(c, n, alpha, beta, xs + j, ys + j, m - j);
+	}
+	inline void clenshaw_dispatch(const double* c, const std::size_t n, const double alpha, const double beta, const double* xs, double* ys, const std::size_t m, const std::true_type&)
+	{
+		clenshaw_simd(c, n, alpha, beta, xs, ys, m);
+	}
+#endif
+	template <typename _ty> inline void clenshaw_dispatch(const _ty* c, const std::size_t n, const _ty alpha, const _ty beta, const _ty* xs, _ty* ys, const std::size_t m, const std::false_type&)
+	{
+		clenshaw(c, n, alpha, beta, xs, ys, m);
+	}
+
+
+	/**
+	 * coefficients c[0..n] of the interpolant through the values v[j] = f(cos(pi*j/n)), j <= n (DCT-I):
+	 * c[k] = 2/n * sum'' v[j]*cos(pi*j*k/n), the ends of the sum and c[0], c[n] halved.
+	 * Powers of two go through the FFT of the even extension of length 2n, other n through the O(n^2) sum.
+	 */
+	template <typename _ty> inline void coefficients_from_values(const _ty* v, const std::size_t n, _ty* c)
+	{
+		if (n == 0)
+		{
+			c[0] = v[0];
+			return;
+		}
+		if ((n & (n - 1)) == 0)
+		{
+			std::vector<std::complex<double>> buf(2 * n);
+			for (std::size_t j = 0; j <= n; ++j)
+				buf[j] = std::complex<double>(static_cast<double>(v[j]), 0.0);
+			for (std::size_t j = 1; j < n; ++j)
+				buf[2 * n - j] = buf[j];
+			convolution::fft(buf.data(), 2 * n, false);
+			for (std::size_t k = 0; k <= n; ++k)
+				c[k] = static_cast<_ty>(buf[k].real() / static_cast<double>(n));
+		}
+		else
+		{
+			const double pi = 3.14159265358979323846;
+			for (std::size_t k = 0; k <= n; ++k)
+			{
+				double s = 0.5 * (static_cast<double>(v[0]) + (((k & 1) == 0) ? (1.0) : (-1.0)) * static_cast<double>(v[n]));
+				for (std::size_t j = 1; j < n; ++j)
+					s += static_cast<double>(v[j]) * std::cos(pi * static_cast<double>((j * k) % (2 * n)) / static_cast<double>(n));
+				c[k] = static_cast<_ty>(2.0 * s / static_cast<double>(n));
+			}
+		}
+		c[0] /= _ty(2);
+		c[n] /= _ty(2);
+	}
+
+	/** solves a*x = b in place (a row-major m x m, overwritten; x ends up in b) by Gaussian elimination with partial pivoting */
+	template <typename _ty> inline bool solve(_ty* a, _ty* b, const std::size_t m)
+	{
+		using std::abs;
+		for (std::size_t col = 0; col < m; ++col)
+		{
+			std::size_t piv = col;
+			for (std::size_t r = col + 1; r < m; ++r)
+				if (abs(a[r * m + col]) > abs(a[piv * m + col]))
+					piv = r;
+			if (a[piv * m + col] == _ty(0))
+				return false;
+			if (piv != col)
+			{
+				for (std::size_t k = 0; k < m; ++k)
+					std::swap(a[piv * m + k], a[col * m + k]);
+				std::swap(b[piv], b[col]);
+			}
+			for (std::size_t r = col + 1; r < m; ++r)
+			{
+				const _ty f = a[r * m + col] / a[col * m + col];
+				for (std::size_t k = col; k < m; ++k)
+					a[r * m + k] -= f * a[col * m + k];
+				b[r] -= f * b[col];
+			}
+		}
+		for (std::size_t r = m; r-- > 0;)
+		{
+			_ty s = b[r];
+			for (std::size_t k = r + 1; k < m; ++k)
+				s -= a[r * m + k] * b[k];
+			b[r] = s / a[r * m + r];
+		}
+		return true;
+	}
+
+}
+
+
+/**
+ * Chebyshev series p(x) = sum c[k]*T_k(t), t = (2x - a - b)/(b - a), on an interval [a,b].
+ * Built from any callable by sampling at Chebyshev points and a DCT, with the degree chosen from a tolerance,
+ * this is a near-minimax approximation: for smooth functions it needs far fewer terms than a Taylor polynomial of the
+ * same accuracy on the interval. Evaluation is Clenshaw's recurrence, for many points in a batched (vectorized) form.
+ * _ty has to be a floating point type.
+ */
+template <typename _ty> class Chebyshev
+{
+protected:
+	std::vector<_ty> c;
+	_ty lo, hi;
+
+	inline _ty to_t(const _ty x) const { return (x + x - lo - hi) / (hi - lo); }
+	inline _ty to_x(const _ty t) const { return (lo + hi) / _ty(2) + (hi - lo) / _ty(2) * t; }
+
+public:
+	typedef _ty value_type;
+	/** the zero series on [-1,1] */
+	inline Chebyshev() : c(1, _ty(0)), lo(_ty(-1)), hi(_ty(1)) {}
+	/** the series with the given coefficients on [a,b] */
+	inline Chebyshev(const std::vector<_ty>& coefficients, const _ty a, const _ty b) : c(coefficients), lo(a), hi(b)
+	{
+		if (c.empty())
+			c.push_back(_ty(0));
+	}
+	/** interpolates f at the degree+1 Chebyshev points cos(pi*j/degree) (mapped onto [a,b]) */
+	template <typename _fn> inline Chebyshev(_fn&& f, const _ty a, const _ty b, const unsigned int degree) : c(degree + 1), lo(a), hi(b)
+	{
+		std::vector<_ty> v(degree + 1);
+		const double pi = 3.14159265358979323846;
+		for (unsigned int j = 0; j <= degree; ++j)
+			v[j] = f(to_x((degree == 0) ? (_ty(0)) : (_ty(std::cos(pi * double(j) / double(degree))))));
+		chebyshev::coefficients_from_values(v.data(), degree, c.data());
+	}
+	inline ~Chebyshev() {}
+
+	/**
+	 * approximates f on [a,b] to a relative tolerance (0: 8 units of roundoff): interpolates at 17, 33, 65, ... points,
+	 * reusing the samples of the previous round, until the last eighth of the coefficients is below tolerance*max|c[k]|,
+	 * then drops the tail whose absolute sum stays below that bound. Stops at max_degree if the series does not settle.
+	 */
+	template <typename _fn> static inline Chebyshev<_ty> fit(_fn&& f, const _ty a, const _ty b, _ty tolerance = _ty(0), const unsigned int max_degree = 4096)
+	{
+		using std::abs;
+		if (tolerance <= _ty(0))
+			tolerance = _ty(8) * std::numeric_limits<_ty>::epsilon();
+		Chebyshev<_ty> res;
+		res.lo = a;
+		res.hi = b;
+		const double pi = 3.14159265358979323846;
+		std::size_t n = 16;
+		std::vector<_ty> v(n + 1), next;
+		for (std::size_t j = 0; j <= n; ++j)
+			v[j] = f(res.to_x(_ty(std::cos(pi * double(j) / double(n)))));
+		for (;;)
+		{
+			res.c.resize(n + 1);
+			chebyshev::coefficients_from_values(v.data(), n, res.c.data());
+			_ty scale = _ty(0);
+			for (const _ty& x : res.c)
+				scale = std::max(scale, _ty(abs(x)));
+			if (scale == _ty(0))
+			{
+				res.c.assign(1, _ty(0));
+				return res;
+			}
+			const _ty bound = tolerance * scale;
+			bool settled = true;
+			for (std::size_t k = n - n / 8; k <= n && settled; ++k)
+				settled = (abs(res.c[k]) <= bound);
+			if (settled || 2 * n > max_degree)
+			{
+				std::size_t m = n;
+				_ty dropped = _ty(0);
+				while (m > 0 && dropped + abs(res.c[m]) <= bound)
+					dropped += abs(res.c[m--]);
+				res.c.resize(m + 1);
+				return res;
+			}
+			// the points for 2n contain those for n at the even indices
+			next.resize(2 * n + 1);
+			for (std::size_t j = 0; j <= n; ++j)
+				next[2 * j] = v[j];
+			for (std::size_t j = 1; j < 2 * n; j += 2)
+				next[j] = f(res.to_x(_ty(std::cos(pi * double(j) / double(2 * n)))));
+			v.swap(next);
+			n *= 2;
+		}
+	}
+
+	/**
+	 * Remez exchange: moves the coefficients (keeping the degree) towards the minimax approximation of f on [a,b].
+	 * Each round solves for the series that equioscillates on the current reference, then moves the reference to the
+	 * extrema of the error (located on a grid and refined by golden section search). Stops once the extrema agree
+	 * to within 1% or after the given number of rounds; the best series seen is kept. Dense O(degree^3) per round,
+	 * so meant for the low and moderate degrees where minimax beats truncated Chebyshev noticeably.
+	 * Returns the maximum error found on the grid.
+	 */
+	template <typename _fn> inline _ty remez(_fn&& f, const unsigned int iterations = 20)
+	{
+		using std::abs;
+		const std::size_t deg = c.size() - 1, m = deg + 2;
+		const double pi = 3.14159265358979323846;
+		// error on a Chebyshev-distributed grid of t
+		const std::size_t g = 16 * m;
+		std::vector<_ty> grid(g), err(g);
+		for (std::size_t i = 0; i < g; ++i)
+			grid[i] = _ty(-std::cos(pi * double(i) / double(g - 1)));
+		auto error_at = [&](const std::vector<_ty>& coef, const _ty t) { return f(to_x(t)) - chebyshev::clenshaw(coef.data(), coef.size(), t); };
+		auto max_error = [&](const std::vector<_ty>& coef)
+		{
+			_ty e = _ty(0);
+			for (std::size_t i = 0; i < g; ++i)
+			{
+				err[i] = error_at(coef, grid[i]);
+				e = std::max(e, _ty(abs(err[i])));
+			}
+			return e;
+		};
+		std::vector<_ty> best = c, ref(m), a(m * m), rhs(m), trial(deg + 1);
+		_ty best_error = max_error(best);
+		for (std::size_t i = 0; i < m; ++i)
+			ref[i] = _ty(-std::cos(pi * double(i) / double(m - 1)));
+		for (unsigned int it = 0; it < iterations; ++it)
+		{
+			// sum c[k]*T_k(ref[i]) + (-1)^i*E = f(ref[i])
+			for (std::size_t i = 0; i < m; ++i)
+			{
+				_ty tk1 = _ty(1), tk = ref[i];
+				a[i * m] = _ty(1);
+				for (std::size_t k = 1; k <= deg; ++k)
+				{
+					a[i * m + k] = tk;
+					const _ty tn = _ty(2) * ref[i] * tk - tk1;
+					tk1 = tk;
+					tk = tn;
+				}
+				a[i * m + deg + 1] = ((i & 1) == 0) ? (_ty(1)) : (_ty(-1));
+				rhs[i] = f(to_x(ref[i]));
+			}
+			if (!chebyshev::solve(a.data(), rhs.data(), m))
+				break;
+			std::copy(rhs.begin(), rhs.begin() + deg + 1, trial.begin());
+			const _ty e = max_error(trial);
+			if (e < best_error)
+			{
+				best_error = e;
+				best = trial;
+			}
+			// one extremum per run of equal sign; surplus runs are dropped from the end with the smaller error
+			std::vector<std::size_t> ext;
+			for (std::size_t i = 0; i < g;)
+			{
+				std::size_t j = i, top = i;
+				while (j < g && ((err[j] >= _ty(0)) == (err[i] >= _ty(0))))
+				{
+					if (abs(err[j]) > abs(err[top]))
+						top = j;
+					++j;
+				}
+				ext.push_back(top);
+				i = j;
+			}
+			if (ext.size() < m)
+				break;
+			std::size_t first = 0, last = ext.size();
+			while (last - first > m)
+			{
+				if (abs(err[ext[first]]) < abs(err[ext[last - 1]]))
+					++first;
+				else
+					--last;
+			}
+			_ty emin = HUGE_VAL, emax = _ty(0);
+			for (std::size_t i = 0; i < m; ++i)
+			{
+				// golden section search for the extremum between the neighbouring grid points
+				const std::size_t p = ext[first + i];
+				_ty l = grid[(p > 0) ? (p - 1) : (p)], r = grid[(p + 1 < g) ? (p + 1) : (p)];
+				const _ty phi = _ty(0.6180339887498949);
+				for (unsigned int s = 0; s < 24; ++s)
+				{
+					const _ty u = r - phi * (r - l), w = l + phi * (r - l);
+					if (abs(error_at(trial, u)) > abs(error_at(trial, w)))
+						r = w;
+					else
+						l = u;
+				}
+				const _ty t = (abs(error_at(trial, l)) > abs(err[p])) ? (l) : (grid[p]);
+				ref[i] = t;
+				const _ty et = abs(error_at(trial, t));
+				emin = std::min(emin, et);
+				emax = std::max(emax, et);
+			}
+			if (emax - emin <= _ty(0.01) * emax)
+			{
+				std::copy(trial.begin(), trial.end(), c.begin());
+				return std::min(e, emax);
+			}
+		}
+		c = best;
+		return best_error;
+	}
+
+	/** p(x) by Clenshaw's recurrence */
+	inline _ty operator()(const _ty x) const
+	{
+		return chebyshev::clenshaw(c.data(), c.size(), to_t(x));
+	}
+	/** ys[k] = p(xs[k]) for k < n; the range is split over the given number of threads (0: one per hardware thread) */
+	inline void evaluate(const _ty* xs, _ty* ys, const std::size_t n, const unsigned int threads = 1) const
+	{
+		const _ty* cc = c.data();
+		const std::size_t nc = c.size();
+		const _ty alpha = _ty(2) / (hi - lo), beta = -(lo + hi) / (hi - lo);
+		parallel::for_ranges(n, threads, [=](const std::size_t begin, const std::size_t end)
+		{
+			chebyshev::clenshaw_dispatch(cc, nc, alpha, beta, xs + begin, ys + begin, end - begin, polyeval::use_simd<_ty>());
+		}, 1024);
+	}
+	inline std::vector<_ty> evaluate(const std::vector<_ty>& xs, const unsigned int threads = 1) const
+	{
+		std::vector<_ty> ys(xs.size());
+		evaluate(xs.data(), ys.data(), xs.size(), threads);
+		return ys;
+	}
+
+	/**
+	 * the same polynomial in the monomial basis of x, O(degree^2) by running Clenshaw's recurrence on polynomials.
+	 * The monomial coefficients can be far larger than the function values for high degrees or intervals away from 0,
+	 * so the result is best kept to moderate degrees.
+	 */
+	inline Polynomial<_ty> to_polynomial() const
+	{
+		const std::size_t n = c.size();
+		const _ty alpha = _ty(2) / (hi - lo), beta = -(lo + hi) / (hi - lo);
+		// b1 = b[k+1], b2 = b[k+2] as polynomials in x; t = alpha*x + beta
+		std::vector<_ty> b1(n + 1, _ty(0)), b2(n + 1, _ty(0)), b0(n + 1);
+		for (std::size_t k = n - 1; k > 0; --k)
+		{
+			b0[0] = c[k] + _ty(2) * beta * b1[0] - b2[0];
+			for (std::size_t i = 1; i <= n; ++i)
+				b0[i] = _ty(2) * (beta * b1[i] + alpha * b1[i - 1]) - b2[i];
+			b2.swap(b1);
+			b1.swap(b0);
+		}
+		Polynomial<_ty> res;
+		typename Polynomial<_ty>::storage_type& r = res.coefficients();
+		r.assign(n, _ty(0));
+		r[0] = c[0] + beta * b1[0] - b2[0];
+		for (std::size_t i = 1; i < n; ++i)
+			r[i] = beta * b1[i] + alpha * b1[i - 1] - b2[i];
+		return res;
+	}
+
+	inline int degree() const { return int(c.size()) - 1; }
+	inline const std::vector<_ty>& coefficients() const { return c; }
+	inline _ty lower() const { return lo; }
+	inline _ty upper() const { return hi; }
+};
+
+typedef Chebyshev<double> chebyshevd;
+typedef Chebyshev<float> chebyshevf;
+
+
+/// near-minimax replacements of the Taylor polynomials of make_sin(), make_cos() and make_exp() in util/tpolynomial.hpp
+/** sin on [a,b] to the given relative tolerance (0: roundoff level), as a polynomial in x */
+inline void make_sin(Polynomial<double>* pol, const double a, const double b, const double tolerance = 0.0)
+{
+	*pol = Chebyshev<double>::fit([](const double x) { return std::sin(x); }, a, b, tolerance).to_polynomial();
+}
+/** cos on [a,b] to the given relative tolerance (0: roundoff level), as a polynomial in x */
+inline void make_cos(Polynomial<double>* pol, const double a, const double b, const double tolerance = 0.0)
+{
+	*pol = Chebyshev<double>::fit([](const double x) { return std::cos(x); }, a, b, tolerance).to_polynomial();
+}
+/** exp on [a,b] to the given relative tolerance (0: roundoff level), as a polynomial in x */
+inline void make_exp(Polynomial<double>* pol, const double a, const double b, const double tolerance = 0.0)
+{
+	*pol = Chebyshev<double>::fit([](const double x) { return std::exp(x); }, a, b, tolerance).to_polynomial();
+}
+
+#endif
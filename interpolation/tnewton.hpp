@@ -0,0 +1,156 @@
+#ifndef _FHP_TNEWTON_HPP_INCLUDED_
+#define _FHP_TNEWTON_HPP_INCLUDED_
+
+#include <vector>
+#include <cstddef>
+#include "../util/tpolynomial.hpp"
+
+
+/**
+ * Interpolant in Newton form on the nodes newest first,
+ *   p(t) = d[0] + (t-x[m-1])*(d[1] + (t-x[m-2])*(d[2] + ...)),  d[k] = f[x[m-1-k],...,x[m-1]],
+ * fed one sample at a time. The coefficients are the last diagonal of the divided-difference table, which adding a
+ * node rebuilds from the previous one in O(n). Dropping the oldest node only drops d[m-1], as no other coefficient
+ * depends on it, so a sliding window over a stream of any length carries no rounding error from nodes that are
+ * gone. Nodes and coefficients share one buffer and do not allocate once it is large enough.
+ * With a window size set, adding a node to a full window drops the oldest node first.
+ */
+template <typename _ty> class NewtonInterpolant
+{
+protected:
+	std::vector<_ty> buf;
+	std::size_t cap, m, win;
+
+	inline _ty* x() { return buf.data(); }
+	inline _ty* d() { return buf.data() + cap; }
+	inline const _ty* x() const { return buf.data(); }
+	inline const _ty* d() const { return buf.data() + cap; }
+
+public:
+	typedef _ty value_type;
+	/** creates an empty interpolant with room for `capacity` nodes; window == 0 lets it grow without bound */
+	inline NewtonInterpolant(const std::size_t capacity = 16, const std::size_t window = 0) : buf(), cap(0), m(0), win(window)
+	{
+		reserve((window > capacity) ? (window) : (capacity));
+	}
+	inline ~NewtonInterpolant() {}
+
+	/** makes room for n nodes */
+	inline NewtonInterpolant<_ty>& reserve(const std::size_t n)
+	{
+		if (n <= cap)
+			return *this;
+		std::vector<_ty> nbuf(2 * n);
+		for (std::size_t k = 0; k < m; ++k)
+		{
+			nbuf[k] = buf[k];
+			nbuf[n + k] = buf[cap + k];
+		}
+		buf.swap(nbuf);
+		cap = n;
+		return *this;
+	}
+	/** sets the sliding window size (0: unbounded), dropping the oldest nodes if there are too many */
+	inline NewtonInterpolant<_ty>& set_window(const std::size_t window)
+	{
+		win = window;
+		reserve(win);
+		while (win != 0 && m > win)
+			drop_oldest();
+		return *this;
+	}
+	/** removes all nodes */
+	inline NewtonInterpolant<_ty>& clear()
+	{
+		m = 0;
+		return *this;
+	}
+
+	/** adds the sample (xn, yn), O(n) */
+	inline NewtonInterpolant<_ty>& add_point(const _ty xn, const _ty yn)
+	{
+		if (win != 0 && m >= win)
+			drop_oldest();
+		if (m == cap)
+			reserve((cap < 8) ? (16) : (2 * cap));
+		_ty* xs = x();
+		_ty* dd = d();
+		// new diagonal: f[xn] = yn, f[x[m-k],...,xn] = (f[x[m-k+1],...,xn] - f[x[m-k],...,x[m-1]]) / (xn - x[m-k])
+		_ty prev = yn;
+		for (std::size_t k = 1; k <= m; ++k)
+		{
+			const _ty next = (prev - dd[k - 1]) / (xn - xs[m - k]);
+			dd[k - 1] = prev;
+			prev = next;
+		}
+		dd[m] = prev;
+		xs[m] = xn;
+		++m;
+		return *this;
+	}
+	/** removes the oldest node: drops the coefficient d[m-1] and moves the nodes down, O(n) and exact */
+	inline NewtonInterpolant<_ty>& drop_oldest()
+	{
+		if (m == 0)
+			return *this;
+		_ty* xs = x();
+		for (std::size_t k = 0; k + 1 < m; ++k)
+			xs[k] = xs[k + 1];
+		--m;
+		return *this;
+	}
+
+	/** evaluates the interpolant with the nested (Horner-like) scheme, O(n) */
+	template <typename aux> inline _ty operator()(const aux t) const
+	{
+		if (m == 0)
+			return _ty(0);
+		const _ty tv = _ty(t);
+		const _ty* xs = x();
+		const _ty* ds = d();
+		_ty res = ds[m - 1];
+		for (std::size_t k = m - 1; k-- > 0;)
+			res = res * (tv - xs[m - 1 - k]) + ds[k];
+		return res;
+	}
+	/** evaluates the interpolant at n points */
+	inline void evaluate(const _ty* ts, _ty* ys, const std::size_t n) const
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			ys[i] = this->operator()(ts[i]);
+	}
+
+	/** converts the interpolant to monomial form, O(n^2) */
+	inline Polynomial<_ty> to_polynomial() const
+	{
+		Polynomial<_ty> res;
+		if (m == 0)
+			return res;
+		typename Polynomial<_ty>::storage_type& p = res.coefficients();
+		p.assign(m, _ty(0));
+		const _ty* xs = x();
+		const _ty* ds = d();
+		// p <- p*(t - x[m-1-k]) + d[k], from the innermost bracket outwards
+		p[0] = ds[m - 1];
+		for (std::size_t k = m - 1; k-- > 0;)
+		{
+			const _ty xk = xs[m - 1 - k];
+			for (std::size_t i = m - 1 - k; i > 0; --i)
+				p[i] = p[i - 1] - xk * p[i];
+			p[0] = ds[k] - xk * p[0];
+		}
+		return res;
+	}
+
+	inline std::size_t size() const { return m; }
+	inline std::size_t capacity() const { return cap; }
+	inline std::size_t window() const { return win; }
+	/** k-th node, oldest first */
+	inline _ty node(const std::size_t k) const { return x()[k]; }
+	/** k-th Newton coefficient d[k] = f[x[m-1-k],...,x[m-1]] of the newest-first form */
+	inline _ty coefficient(const std::size_t k) const { return d()[k]; }
+};
+
+typedef NewtonInterpolant<double> newton_interpolantd;
+
+#endif
@@ -0,0 +1,317 @@
+#ifndef _FHP_TSPLINE_HPP_INCLUDED_
+#define _FHP_TSPLINE_HPP_INCLUDED_
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include "../util/tparallel.hpp"
+
+
+namespace spline
+{
+
+	/** end conditions of a cubic spline */
+	enum boundary
+	{
+		/** zero second derivative at both ends */
+		natural,
+		/** given first derivatives at both ends */
+		clamped,
+		/** third derivative continuous across the second and the second to last node */
+		not_a_knot
+	};
+
+	/**
+	 * solves the tridiagonal system a[i]*s[i-1] + b[i]*s[i] + c[i]*s[i+1] = d[i], i < n (a[0] and c[n-1] unused),
+	 * by Thomas' algorithm in O(n) without pivoting; b and d are overwritten, the solution ends up in d
+	 */
+	template <typename _ty> inline void solve_tridiagonal(const _ty* a, _ty* b, const _ty* c, _ty* d, const std::size_t n)
+	{
+		for (std::size_t i = 1; i < n; ++i)
+		{
+			const _ty f = a[i] / b[i - 1];
+			b[i] -= f * c[i - 1];
+			d[i] -= f * d[i - 1];
+		}
+		d[n - 1] /= b[n - 1];
+		for (std::size_t i = n - 1; i-- > 0;)
+			d[i] = (d[i] - c[i] * d[i + 1]) / b[i];
+	}
+
+	/** the largest i < n with x[i] <= t (0 if there is none) for ascending x[0..n-1], by a binary search without branches */
+	template <typename _ty> inline std::size_t find_interval(const _ty* x, const std::size_t n, const _ty t)
+	{
+		std::size_t lo = 0, len = n;
+		while (len > 1)
+		{
+			const std::size_t half = len >> 1;
+			lo = (x[lo + half] <= t) ? (lo + half) : (lo);
+			len -= half;
+		}
+		return lo;
+	}
+
+}
+
+
+/**
+ * Piecewise polynomial on breakpoints x[0] < ... < x[n]: on [x[i], x[i+1]] it is sum c[i][j]*(t - x[i])^j, j < order.
+ * The coefficients of one interval are stored next to each other, so an evaluation touches one or two cache lines.
+ * Intervals are found in O(1) on uniform grids and by a branch-free binary search otherwise; batches of ascending
+ * queries walk the breakpoints instead of searching. Points outside [x[0], x[n]] use the first or last piece.
+ * Cubic splines (natural, clamped, not-a-knot) and Akima splines are built in O(n) by cubic() and akima().
+ * _ty has to be a floating point type.
+ */
+template <typename _ty> class PiecewisePolynomial
+{
+protected:
+	std::vector<_ty> x, c;
+	std::size_t k;
+	/** whether the breakpoints are equidistant, and 1/spacing if so */
+	bool uniform;
+	_ty inv_h;
+
+	inline void setup()
+	{
+		const std::size_t n = intervals();
+		uniform = false;
+		inv_h = _ty(0);
+		if (n == 0)
+			return;
+		const _ty h = (x[n] - x[0]) / _ty(n);
+		const _ty tol = _ty(8) * std::numeric_limits<_ty>::epsilon() * ((std::abs(x[0]) > std::abs(x[n])) ? (std::abs(x[0])) : (std::abs(x[n])));
+		for (std::size_t i = 1; i < n; ++i)
+			if (std::abs(x[i] - (x[0] + _ty(i) * h)) > tol)
+				return;
+		uniform = true;
+		inv_h = _ty(1) / h;
+	}
+
+	/** piece i evaluated at t */
+	inline _ty piece(const std::size_t i, const _ty t) const
+	{
+		const _ty dt = t - x[i];
+		const _ty* ci = c.data() + i * k;
+		_ty res = ci[k - 1];
+		for (std::size_t j = k - 1; j-- > 0;)
+			res = res * dt + ci[j];
+		return res;
+	}
+
+	/** Hermite cubics from node values y and slopes s */
+	inline void hermite(const _ty* y, const _ty* s)
+	{
+		const std::size_t n = intervals();
+		k = 4;
+		c.assign(4 * n, _ty(0));
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const _ty h = x[i + 1] - x[i];
+			const _ty d = (y[i + 1] - y[i]) / h;
+			_ty* ci = c.data() + 4 * i;
+			ci[0] = y[i];
+			ci[1] = s[i];
+			ci[2] = (_ty(3) * d - _ty(2) * s[i] - s[i + 1]) / h;
+			ci[3] = (s[i] + s[i + 1] - _ty(2) * d) / (h * h);
+		}
+	}
+
+public:
+	typedef _ty value_type;
+	/** the zero function on [0,1] */
+	inline PiecewisePolynomial() : x{ _ty(0), _ty(1) }, c(1, _ty(0)), k(1), uniform(true), inv_h(_ty(1)) {}
+	/** n+1 breakpoints and order*n coefficients, those of interval i at coefficients[i*order + j] */
+	inline PiecewisePolynomial(const std::vector<_ty>& breakpoints, const std::vector<_ty>& coefficients, const std::size_t order) : x(breakpoints), c(coefficients), k(order)
+	{
+		setup();
+	}
+	inline ~PiecewisePolynomial() {}
+
+	/**
+	 * cubic spline through (xs[i], ys[i]), i < n, xs ascending, with the given end conditions (d0, dn being the end
+	 * slopes of a clamped spline). The node slopes come from one tridiagonal solve. Two points give the line, and a
+	 * not-a-knot spline through three points is the parabola.
+	 */
+	static inline PiecewisePolynomial<_ty> cubic(const _ty* xs, const _ty* ys, const std::size_t n, const spline::boundary bc = spline::natural, const _ty d0 = _ty(0), const _ty dn = _ty(0))
+	{
+		PiecewisePolynomial<_ty> res;
+		if (n < 2)
+		{
+			res.c.assign(1, (n == 1) ? (ys[0]) : (_ty(0)));
+			return res;
+		}
+		res.x.assign(xs, xs + n);
+		res.setup();
+		const std::size_t m = n - 1;
+		std::vector<_ty> h(m), d(m), a(n), b(n), u(n), s(n);
+		for (std::size_t i = 0; i < m; ++i)
+		{
+			h[i] = xs[i + 1] - xs[i];
+			d[i] = (ys[i + 1] - ys[i]) / h[i];
+		}
+		// interior rows: h[i]*s[i-1] + 2(h[i-1]+h[i])*s[i] + h[i-1]*s[i+1] = 3(h[i]*d[i-1] + h[i-1]*d[i])
+		for (std::size_t i = 1; i < m; ++i)
+		{
+			a[i] = h[i];
+			b[i] = _ty(2) * (h[i - 1] + h[i]);
+			u[i] = h[i - 1];
+			s[i] = _ty(3) * (h[i] * d[i - 1] + h[i - 1] * d[i]);
+		}
+		if (bc == spline::clamped)
+		{
+			b[0] = _ty(1); u[0] = _ty(0); s[0] = d0;
+			a[m] = _ty(0); b[m] = _ty(1); s[m] = dn;
+		}
+		else if (bc == spline::not_a_knot && m >= 3)
+		{
+			b[0] = h[1];
+			u[0] = h[0] + h[1];
+			s[0] = ((h[0] + _ty(2) * u[0]) * h[1] * d[0] + h[0] * h[0] * d[1]) / u[0];
+			a[m] = h[m - 1] + h[m - 2];
+			b[m] = h[m - 2];
+			s[m] = (h[m - 1] * h[m - 1] * d[m - 2] + (_ty(2) * a[m] + h[m - 1]) * h[m - 2] * d[m - 1]) / a[m];
+		}
+		else if (bc == spline::not_a_knot && m == 2)
+		{
+			// the parabola through the three points
+			const _ty q = (d[1] - d[0]) / (xs[2] - xs[0]);
+			for (std::size_t i = 0; i < 3; ++i)
+				s[i] = d[0] + q * (_ty(2) * xs[i] - xs[0] - xs[1]);
+			res.hermite(ys, s.data());
+			return res;
+		}
+		else
+		{
+			// natural; also not-a-knot on two points, where it is the line
+			b[0] = _ty(2); u[0] = _ty(1); s[0] = _ty(3) * d[0];
+			a[m] = _ty(1); b[m] = _ty(2); s[m] = _ty(3) * d[m - 1];
+		}
+		spline::solve_tridiagonal(a.data(), b.data(), u.data(), s.data(), n);
+		res.hermite(ys, s.data());
+		return res;
+	}
+	static inline PiecewisePolynomial<_ty> cubic(const std::vector<_ty>& xs, const std::vector<_ty>& ys, const spline::boundary bc = spline::natural, const _ty d0 = _ty(0), const _ty dn = _ty(0))
+	{
+		return cubic(xs.data(), ys.data(), (xs.size() < ys.size()) ? (xs.size()) : (ys.size()), bc, d0, dn);
+	}
+
+	/**
+	 * Akima spline through (xs[i], ys[i]), i < n, xs ascending: node slopes are weighted from the neighbouring secants,
+	 * so it does not overshoot near outliers and steps like the cubic spline does. Local, O(n), no system to solve.
+	 */
+	static inline PiecewisePolynomial<_ty> akima(const _ty* xs, const _ty* ys, const std::size_t n)
+	{
+		if (n < 3)
+			return cubic(xs, ys, n);
+		PiecewisePolynomial<_ty> res;
+		res.x.assign(xs, xs + n);
+		res.setup();
+		const std::size_t m = n - 1;
+		// secants d[i+2] of interval i, extended by two on either side
+		std::vector<_ty> d(m + 4), s(n);
+		for (std::size_t i = 0; i < m; ++i)
+			d[i + 2] = (ys[i + 1] - ys[i]) / (xs[i + 1] - xs[i]);
+		d[1] = _ty(2) * d[2] - d[3];
+		d[0] = _ty(2) * d[1] - d[2];
+		d[m + 2] = _ty(2) * d[m + 1] - d[m];
+		d[m + 3] = _ty(2) * d[m + 2] - d[m + 1];
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const _ty w1 = std::abs(d[i + 3] - d[i + 2]), w2 = std::abs(d[i + 1] - d[i]);
+			s[i] = (w1 + w2 == _ty(0)) ? ((d[i + 1] + d[i + 2]) / _ty(2)) : ((w1 * d[i + 1] + w2 * d[i + 2]) / (w1 + w2));
+		}
+		res.hermite(ys, s.data());
+		return res;
+	}
+	static inline PiecewisePolynomial<_ty> akima(const std::vector<_ty>& xs, const std::vector<_ty>& ys)
+	{
+		return akima(xs.data(), ys.data(), (xs.size() < ys.size()) ? (xs.size()) : (ys.size()));
+	}
+
+	/// lookup and evaluation
+	/** index of the interval containing t, O(1) on uniform grids, O(log n) otherwise */
+	inline std::size_t find(const _ty t) const
+	{
+		const std::size_t n = intervals();
+		if (!uniform)
+			return spline::find_interval(x.data(), n, t);
+		const _ty f = (t - x[0]) * inv_h;
+		std::size_t i = (f <= _ty(0)) ? (0) : ((f >= _ty(n)) ? (n - 1) : (std::size_t(f)));
+		// rounding of f can be one off near a breakpoint
+		if (i > 0 && t < x[i])
+			--i;
+		else if (i + 1 < n && t >= x[i + 1])
+			++i;
+		return i;
+	}
+	template <typename aux> inline _ty operator()(const aux t) const
+	{
+		const _ty tv = _ty(t);
+		return piece(find(tv), tv);
+	}
+	/** ys[j] = p(ts[j]) for j < m; the range is split over the given number of threads (0: one per hardware thread) */
+	inline void evaluate(const _ty* ts, _ty* ys, const std::size_t m, const unsigned int threads = 1) const
+	{
+		parallel::for_ranges(m, threads, [&](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t j = begin; j < end; ++j)
+				ys[j] = piece(find(ts[j]), ts[j]);
+		}, 1024);
+	}
+	/**
+	 * ys[j] = p(ts[j]) for ascending ts: the interval index only moves forward, so the stream costs O(m + n) lookups
+	 * in total instead of m searches. Each thread's range starts with one search.
+	 */
+	inline void evaluate_sorted(const _ty* ts, _ty* ys, const std::size_t m, const unsigned int threads = 1) const
+	{
+		const std::size_t n = intervals();
+		parallel::for_ranges(m, threads, [&](const std::size_t begin, const std::size_t end)
+		{
+			if (begin == end)
+				return;
+			std::size_t i = find(ts[begin]);
+			for (std::size_t j = begin; j < end; ++j)
+			{
+				const _ty t = ts[j];
+				while (i + 1 < n && t >= x[i + 1])
+					++i;
+				ys[j] = piece(i, t);
+			}
+		}, 1024);
+	}
+	inline std::vector<_ty> evaluate(const std::vector<_ty>& ts, const unsigned int threads = 1) const
+	{
+		std::vector<_ty> ys(ts.size());
+		evaluate(ts.data(), ys.data(), ts.size(), threads);
+		return ys;
+	}
+
+	/** the piecewise derivative, of one order less */
+	inline PiecewisePolynomial<_ty> derivative() const
+	{
+		const std::size_t n = intervals();
+		if (k <= 1)
+			return PiecewisePolynomial<_ty>(x, std::vector<_ty>(n, _ty(0)), 1);
+		std::vector<_ty> dc((k - 1) * n);
+		for (std::size_t i = 0; i < n; ++i)
+			for (std::size_t j = 1; j < k; ++j)
+				dc[i * (k - 1) + j - 1] = _ty(j) * c[i * k + j];
+		return PiecewisePolynomial<_ty>(x, dc, k - 1);
+	}
+
+	/// access
+	inline std::size_t intervals() const { return (x.size() < 2) ? (0) : (x.size() - 1); }
+	/** number of coefficients per interval (degree + 1) */
+	inline std::size_t order() const { return k; }
+	inline bool is_uniform() const { return uniform; }
+	inline const std::vector<_ty>& breakpoints() const { return x; }
+	inline const std::vector<_ty>& coefficients() const { return c; }
+	inline _ty lower() const { return x.front(); }
+	inline _ty upper() const { return x.back(); }
+};
+
+typedef PiecewisePolynomial<double> piecewised;
+typedef PiecewisePolynomial<float> piecewisef;
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef _FHP_TABERTH_HPP_INCLUDED_
+#define _FHP_TABERTH_HPP_INCLUDED_
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <cstddef>
+#include <algorithm>
+#include "../util/tpolynomial.hpp"
+#include "../util/tparallel.hpp"
+
+
+/** settings for find_roots_aberth() */
+struct aberth_options
+{
+	/** a root is frozen once its correction drops below tolerance*|z| */
+	double tolerance = 1.0e-14;
+	unsigned int max_iterations = 500;
+	/** threads for the correction sweep; 0: one per hardware thread */
+	unsigned int threads = 1;
+};
+
+template <typename _cty> struct aberth_result
+{
+	std::vector<_cty> roots;
+	/** number of sweeps over all active roots */
+	unsigned int iterations;
+	/** number of roots that met the stopping criterion */
+	unsigned int converged;
+};
+
+
+namespace aberth_detail
+{
+
+	/** s += sum_{begin <= j < end} 1/(z - z_j), with the roots as split real/imaginary arrays */
+	inline void inverse_distance_sum(const double* re, const double* im, std::size_t begin, const std::size_t end, const double zr, const double zi, double& sr, double& si)
+	{
+		double ar = 0.0, ai = 0.0;
+#ifdef _FHP_POLYEVAL_SIMD_
+		typedef polyeval::simd_double v;
+		const std::size_t w = v::width;
+		if (end - begin >= w)
+		{
+			const v::reg vzr = v::set1(zr), vzi = v::set1(zi);
+			v::reg accr = v::set1(0.0), acci = accr;
+			for (; begin + w <= end; begin += w)
+			{
+				// 1/(dr + i*di) = (dr - i*di)/(dr^2 + di^2)
+				const v::reg dr = v::sub(vzr, v::load(re + begin));
+				const v::reg di = v::sub(vzi, v::load(im + begin));
+				const v::reg inv = v::div(v::set1(1.0), v::fmadd(dr, dr, v::mul(di, di)));
+				accr = v::fmadd(dr, inv, accr);
+				acci = v::fmadd(di, inv, acci);
+			}
+			ar = v::sum(accr);
+			ai = -v::sum(acci);
+		}
+#endif
+		for (std::size_t j = begin; j < end; ++j)
+		{
+			const double dr = zr - re[j], di = zi - im[j];
+			const double inv = 1.0 / (dr * dr + di * di);
+			ar += dr * inv;
+			ai -= di * inv;
+		}
+		sr += ar;
+		si += ai;
+	}
+
+	/**
+	 * Newton correction N = p(z)/p'(z) by Horner's scheme on split coefficients, and whether |p(z)| is at the level of
+	 * its rounding error (|p(z)| <= eps * sum |a_k||z|^k). For |z| > 1 the reversed polynomial q(y) = y^deg p(1/y)
+	 * is evaluated at y = 1/z instead, so that high degrees do not overflow: N = 1/(y*(deg - y*q'(y)/q(y))).
+	 */
+	inline bool newton_correction(const double* ar, const double* ai, const std::size_t n, const double zr, const double zi, double& nr, double& ni)
+	{
+		const double az2 = zr * zr + zi * zi;
+		const bool reversed = (az2 > 1.0);
+		// the point of evaluation x, and the coefficients from the top down
+		const double xr = (reversed) ? (zr / az2) : (zr), xi = (reversed) ? (-zi / az2) : (zi);
+		const double ax = std::sqrt(xr * xr + xi * xi);
+		const std::ptrdiff_t step = (reversed) ? (1) : (-1);
+		std::size_t k = (reversed) ? (0) : (n - 1);
+		double pr = ar[k], pi = ai[k], dr = 0.0, di = 0.0;
+		double bound = std::sqrt(pr * pr + pi * pi);
+		for (std::size_t m = 1; m < n; ++m)
+		{
+			k += step;
+			const double tr = dr * xr - di * xi + pr, ti = dr * xi + di * xr + pi;
+			dr = tr;
+			di = ti;
+			const double ur = pr * xr - pi * xi + ar[k], ui = pr * xi + pi * xr + ai[k];
+			pr = ur;
+			pi = ui;
+			bound = bound * ax + std::sqrt(ar[k] * ar[k] + ai[k] * ai[k]);
+		}
+		const double pp = pr * pr + pi * pi;
+		if (std::sqrt(pp) <= DBL_EPSILON * bound)
+			return true;
+		if (!reversed)
+		{
+			const double dd = dr * dr + di * di;
+			nr = (pr * dr + pi * di) / dd;
+			ni = (pi * dr - pr * di) / dd;
+			return false;
+		}
+		// t = deg - y*q'/q, N = 1/(y*t)
+		const double gr = (dr * pr + di * pi) / pp, gi = (di * pr - dr * pi) / pp;
+		const double tr = double(n - 1) - (xr * gr - xi * gi), ti = -(xr * gi + xi * gr);
+		const double sr = xr * tr - xi * ti, si = xr * ti + xi * tr;
+		const double ss = sr * sr + si * si;
+		nr = sr / ss;
+		ni = -si / ss;
+		return false;
+	}
+
+	/**
+	 * Initial approximations on circles: the radii come from the Cauchy-type bounds (|a_i|/|a_j|)^(1/(j-i)) of the
+	 * coefficient pairs on the upper convex hull of the Newton polygon (i, log|a_i|), j-i points on each circle,
+	 * clamped to the classical Cauchy bounds for the moduli of all roots.
+	 */
+	inline void initial_guesses(const double* ar, const double* ai, const std::size_t n, double* re, double* im)
+	{
+		const std::size_t deg = n - 1;
+		std::vector<double> la(n);
+		double amax = 0.0, amax_hi = 0.0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const double a = std::sqrt(ar[i] * ar[i] + ai[i] * ai[i]);
+			la[i] = (a > 0.0) ? (std::log(a)) : (-HUGE_VAL);
+			if (i > 0)
+				amax = std::max(amax, a);
+			if (i < deg)
+				amax_hi = std::max(amax_hi, a);
+		}
+		const double a0 = std::exp(la[0]), an = std::exp(la[deg]);
+		const double upper = 1.0 + amax_hi / an;
+		const double lower = a0 / (a0 + amax);
+		std::vector<std::size_t> hull;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			if (la[i] == -HUGE_VAL)
+				continue;
+			while (hull.size() >= 2)
+			{
+				const std::size_t p = hull[hull.size() - 2], q = hull[hull.size() - 1];
+				// drop q if it lies on or below the segment p -> i
+				if ((la[q] - la[p]) * double(i - p) <= (la[i] - la[p]) * double(q - p))
+					hull.pop_back();
+				else
+					break;
+			}
+			hull.push_back(i);
+		}
+		const double pi2 = 6.28318530717958647692;
+		std::size_t k = 0;
+		for (std::size_t h = 0; h + 1 < hull.size(); ++h)
+		{
+			const std::size_t i = hull[h], j = hull[h + 1], cnt = j - i;
+			double r = std::exp((la[i] - la[j]) / double(cnt));
+			r = std::min(std::max(r, lower), upper);
+			for (std::size_t m = 0; m < cnt; ++m, ++k)
+			{
+				// the offset keeps the starting points off symmetry axes of real polynomials
+				const double phi = pi2 * (double(m) / double(cnt) + double(i) / double(n)) + 0.4;
+				re[k] = r * std::cos(phi);
+				im[k] = r * std::sin(phi);
+			}
+		}
+	}
+
+	template <typename _cty> inline double real_part(const _cty& z) { return static_cast<double>(z.real()); }
+	template <typename _cty> inline double imag_part(const _cty& z) { return static_cast<double>(z.imag()); }
+
+}
+
+
+/**
+ * Finds all roots of a polynomial with complex coefficients simultaneously with the Aberth-Ehrlich iteration
+ *   z_i <- z_i - N_i / (1 - N_i * sum_{j!=i} 1/(z_i - z_j)),  N_i = p(z_i)/p'(z_i)
+ * All corrections of a sweep are computed from the same approximations (Jacobi style), so the result does not
+ * depend on the number of threads. A root is frozen once its correction is below the tolerance or |p(z_i)| is at
+ * the level of its rounding error; frozen roots still take part in the sums of the others.
+ */
+template <typename _cty> inline aberth_result<_cty> find_roots_aberth(const Polynomial<_cty>& pol, const aberth_options& opts = aberth_options())
+{
+	aberth_result<_cty> res;
+	res.iterations = 0;
+	res.converged = 0;
+	// strip vanishing leading coefficients and roots at zero
+	int top = pol.degree();
+	while (top > 0 && pol.get_coefficient(top) == _cty(0))
+		--top;
+	unsigned int low = 0;
+	while (int(low) < top && pol.get_coefficient(low) == _cty(0))
+		++low;
+	for (unsigned int i = 0; i < low; ++i)
+		res.roots.push_back(_cty(0));
+	res.converged = low;
+	const std::size_t n = std::size_t(top - int(low)) + 1;
+	if (n < 2)
+		return res;
+	const std::size_t deg = n - 1;
+
+	std::vector<double> buf(7 * n);
+	double* ar = buf.data();
+	double* ai = ar + n;
+	double* re = ai + n;
+	double* im = re + n;
+	double* nre = im + n;
+	double* nim = nre + n;
+	double* active = nim + n;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		ar[i] = aberth_detail::real_part(pol.get_coefficient(low + i));
+		ai[i] = aberth_detail::imag_part(pol.get_coefficient(low + i));
+	}
+	aberth_detail::initial_guesses(ar, ai, n, re, im);
+	for (std::size_t i = 0; i < deg; ++i)
+		active[i] = 1.0;
+
+	// the workers are started once for all sweeps
+	parallel::pool workers(opts.threads);
+	std::size_t remaining = deg;
+	while (remaining > 0 && res.iterations < opts.max_iterations)
+	{
+		++res.iterations;
+		workers.for_ranges(deg, [&](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+			{
+				nre[i] = re[i];
+				nim[i] = im[i];
+				if (active[i] == 0.0)
+					continue;
+				double qr, qi;
+				if (aberth_detail::newton_correction(ar, ai, n, re[i], im[i], qr, qi))
+				{
+					active[i] = 0.0;
+					continue;
+				}
+				double sr = 0.0, si = 0.0;
+				aberth_detail::inverse_distance_sum(re, im, 0, i, re[i], im[i], sr, si);
+				aberth_detail::inverse_distance_sum(re, im, i + 1, deg, re[i], im[i], sr, si);
+				// w = N / (1 - N*S)
+				const double tr = 1.0 - (qr * sr - qi * si), ti = -(qr * si + qi * sr);
+				const double tt = tr * tr + ti * ti;
+				const double wr = (qr * tr + qi * ti) / tt, wi = (qi * tr - qr * ti) / tt;
+				if (!(std::isfinite(wr) && std::isfinite(wi)))
+					continue;
+				nre[i] = re[i] - wr;
+				nim[i] = im[i] - wi;
+				if (std::sqrt(wr * wr + wi * wi) <= opts.tolerance * std::sqrt(nre[i] * nre[i] + nim[i] * nim[i]))
+					active[i] = 0.0;
+			}
+		}, 16);
+		std::swap(re, nre);
+		std::swap(im, nim);
+		remaining = 0;
+		for (std::size_t i = 0; i < deg; ++i)
+			remaining += (active[i] != 0.0);
+	}
+	res.converged += unsigned(deg - remaining);
+	for (std::size_t i = 0; i < deg; ++i)
+		res.roots.push_back(_cty(re[i], im[i]));
+	return res;
+}
+
+#endif
@@ -0,0 +1,112 @@
+#ifndef _FHP_TBRACKET_HPP_INCLUDED_
+#define _FHP_TBRACKET_HPP_INCLUDED_
+
+#include <cmath>
+#include <limits>
+
+
+/** settings for illinois() */
+struct bracket_options
+{
+	/** stop once the step or the bracket is at most this wide (0: down to a few ulps of the root) */
+	double tolerance = 0.0;
+	unsigned int max_iterations = 200;
+};
+
+template <typename _ty> struct bracket_result
+{
+	_ty root;
+	/** f(root) */
+	_ty residual;
+	/** the final bracket */
+	_ty lower, upper;
+	unsigned int iterations;
+	/** number of calls to f, two for the ends plus one per iteration */
+	unsigned int evaluations;
+	/** false if the iteration ran out, or if f does not change sign on the starting bracket */
+	bool converged;
+};
+
+
+/**
+ * Illinois variant of regula falsi on a bracket [a,b] with f(a), f(b) of opposite signs: the secant through the ends
+ * replaces the end of the same sign, and an end kept twice in a row has its value halved, which gives superlinear
+ * convergence while the root stays bracketed. Steps that leave the bracket fall back to bisection.
+ * _ty has to be a real floating point type.
+ */
+template <typename _ty, typename _fn> inline bracket_result<_ty> illinois(_fn&& f, const _ty a, const _ty b, const bracket_options& opts = bracket_options())
+{
+	using std::abs;
+	bracket_result<_ty> res;
+	_ty lo = a, hi = b, flo = f(a), fhi = f(b);
+	res.iterations = 0;
+	res.evaluations = 2;
+	res.converged = true;
+	if (flo == _ty(0) || fhi == _ty(0))
+	{
+		res.root = (flo == _ty(0)) ? (lo) : (hi);
+		res.residual = _ty(0);
+		res.lower = lo;
+		res.upper = hi;
+		return res;
+	}
+	if ((flo < _ty(0)) == (fhi < _ty(0)))
+	{
+		res.root = (abs(flo) < abs(fhi)) ? (lo) : (hi);
+		res.residual = (abs(flo) < abs(fhi)) ? (flo) : (fhi);
+		res.lower = lo;
+		res.upper = hi;
+		res.converged = false;
+		return res;
+	}
+	const _ty eps = std::numeric_limits<_ty>::epsilon();
+	// which end was replaced last: -1 lower, +1 upper, 0 none yet
+	int side = 0;
+	_ty x = lo, fx = flo;
+	for (;;)
+	{
+		if (res.iterations >= opts.max_iterations)
+		{
+			res.converged = false;
+			break;
+		}
+		const _ty tol = _ty(opts.tolerance) + _ty(4) * eps * ((abs(lo) > abs(hi)) ? (abs(lo)) : (abs(hi)));
+		if (abs(hi - lo) <= tol)
+			break;
+		_ty next = (flo * hi - fhi * lo) / (flo - fhi);
+		if (!(next > lo && next < hi))
+			next = lo + (hi - lo) / _ty(2);
+		const _ty step = next - x;
+		x = next;
+		fx = f(x);
+		++res.evaluations;
+		++res.iterations;
+		if (fx == _ty(0))
+			break;
+		if ((fx < _ty(0)) == (flo < _ty(0)))
+		{
+			lo = x;
+			flo = fx;
+			if (side == -1)
+				fhi /= _ty(2);
+			side = -1;
+		}
+		else
+		{
+			hi = x;
+			fhi = fx;
+			if (side == 1)
+				flo /= _ty(2);
+			side = 1;
+		}
+		if (abs(step) <= tol)
+			break;
+	}
+	res.root = x;
+	res.residual = fx;
+	res.lower = lo;
+	res.upper = hi;
+	return res;
+}
+
+#endif
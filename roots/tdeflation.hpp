@@ -0,0 +1,247 @@
+#ifndef _FHP_TDEFLATION_HPP_INCLUDED_
+#define _FHP_TDEFLATION_HPP_INCLUDED_
+
+#include <vector>
+#include <cmath>
+#include <cfloat>
+#include <cstddef>
+#include <limits>
+#include "tmuller.hpp"
+#include "../util/tpolynomial.hpp"
+#include "../util/tparallel.hpp"
+
+
+/** settings for find_roots_muller() */
+struct deflation_options
+{
+	/** Muller settings for each root of the deflated polynomial */
+	muller_options muller;
+	/** Newton steps on the original polynomial per root (0: no polishing) */
+	unsigned int polish_iterations = 8;
+	/** further attempts from other starting points when Muller does not converge */
+	unsigned int restarts = 8;
+
+	inline deflation_options()
+	{
+		// the deflated polynomial reports values at its rounding error level as exact zeros, see find_roots_muller()
+		muller.tolerance = DBL_MIN;
+		muller.step_tolerance = 1.0e-14;
+		muller.max_iterations = 200;
+	}
+};
+
+/** scratch space for find_roots_muller(); reusing one per thread avoids allocating per polynomial */
+template <typename _cty> struct deflation_workspace
+{
+	std::vector<_cty> coef;
+};
+
+
+namespace deflation
+{
+
+	/** divides c[0..n-1] by (x - r) from the top down; the quotient ends up in c[0..n-2], the remainder is returned */
+	template <typename _cty> inline _cty forward(_cty* c, const std::size_t n, const _cty r)
+	{
+		_cty carry = c[n - 1];
+		for (std::size_t i = n - 1; i-- > 0;)
+		{
+			const _cty t = c[i];
+			c[i] = carry;
+			carry = t + r * carry;
+		}
+		return carry;
+	}
+
+	/** divides c[0..n-1] by (x - r) from the constant term up; the quotient ends up in c[0..n-2], the remainder is returned */
+	template <typename _cty> inline _cty backward(_cty* c, const std::size_t n, const _cty r)
+	{
+		// c[i] = q[i-1] - r*q[i]  =>  q[i] = (q[i-1] - c[i]) / r
+		_cty prev = _cty(0);
+		for (std::size_t i = 0; i + 1 < n; ++i)
+		{
+			const _cty q = (prev - c[i]) / r;
+			c[i] = q;
+			prev = q;
+		}
+		return c[n - 1] - prev;
+	}
+
+	/**
+	 * divides out the root r in place: forward deflation is stable for roots small compared to the remaining ones,
+	 * backward deflation for large ones, so the typical root modulus (|c0|/|cn|)^(1/deg) decides
+	 */
+	template <typename _cty> inline void deflate(_cty* c, const std::size_t n, const _cty r)
+	{
+		using std::abs;
+		using std::pow;
+		typedef typename _cty::value_type real_type;
+		const real_type a0 = abs(c[0]), an = abs(c[n - 1]);
+		const real_type rho = (a0 == 0.0) ? (real_type(0.0)) : (pow(a0 / an, 1.0 / double(n - 1)));
+		if (abs(r) <= rho)
+			forward(c, n, r);
+		else
+			backward(c, n, r);
+	}
+
+	/** p(x) for c[0..n-1] by Horner's scheme; bound receives the running error bound sum |c[i]| |x|^i of the scheme */
+	template <typename _cty> inline _cty residual(const _cty* c, const std::size_t n, const _cty x, typename _cty::value_type& bound)
+	{
+		using std::abs;
+		typedef typename _cty::value_type real_type;
+		const real_type ax = abs(x);
+		_cty y = c[n - 1];
+		bound = abs(y);
+		for (std::size_t i = n - 1; i-- > 0;)
+		{
+			y = y * x + c[i];
+			bound = bound * ax + abs(c[i]);
+		}
+		return y;
+	}
+
+	/** a few Newton steps on the original coefficients, kept only while |p| decreases */
+	template <typename _cty> inline _cty polish(const _cty* c, const std::size_t n, _cty z, const unsigned int iterations)
+	{
+		using std::abs;
+		_cty pd[2];
+		polyeval::derivatives_at(c, n, z, pd, 1);
+		for (unsigned int it = 0; it < iterations; ++it)
+		{
+			if (abs(pd[0]) == 0.0 || abs(pd[1]) == 0.0)
+				break;
+			const _cty zn = z - pd[0] / pd[1];
+			_cty pn[2];
+			polyeval::derivatives_at(c, n, zn, pn, 1);
+			if (!(abs(pn[0]) < abs(pd[0])))
+				break;
+			z = zn;
+			pd[0] = pn[0];
+			pd[1] = pn[1];
+		}
+		return z;
+	}
+
+}
+
+
+/**
+ * Finds all roots of pol with Muller's method and deflation: each root found is divided out of a working copy of
+ * the coefficients in place (no reallocation), the search continues on the quotient, and at the end every root is
+ * polished with Newton's method against the original polynomial. The roots are written to `roots`.
+ * _cty has to be a complex type; its value_type may be wider than double (Complex<DoubleDouble>, see
+ * util/tdoubledouble.hpp), which is what ill-conditioned polynomials such as Wilkinson's need.
+ * A point is divided out only once the deflated polynomial vanishes there to within the rounding error of Horner's
+ * scheme; otherwise Muller is restarted from other seeds, and if none of them gives a root the point with the
+ * smallest relative residual is divided out all the same. Returns the number of roots that passed this test, so a
+ * value below the degree means that the remaining roots are unreliable.
+ */
+template <typename _cty> inline unsigned int find_roots_muller(const Polynomial<_cty>& pol, std::vector<_cty>& roots, deflation_workspace<_cty>& ws, const deflation_options& opts = deflation_options())
+{
+	using std::abs;
+	using std::pow;
+	typedef typename _cty::value_type real_type;
+	const real_type eps = std::numeric_limits<real_type>::epsilon();
+	roots.clear();
+	int top = pol.degree();
+	while (top > 0 && pol.get_coefficient(top) == _cty(0))
+		--top;
+	if (top < 1)
+		return 0;
+	roots.reserve(top);
+	ws.coef.resize(top + 1);
+	_cty* c = ws.coef.data();
+	for (int i = 0; i <= top; ++i)
+		c[i] = pol.get_coefficient(i);
+	std::size_t n = top + 1;
+	unsigned int verified = 0;
+	// roots at zero are shifted out exactly
+	while (n > 1 && c[0] == _cty(0))
+	{
+		for (std::size_t i = 0; i + 1 < n; ++i)
+			c[i] = c[i + 1];
+		--n;
+		roots.push_back(_cty(0));
+		++verified;
+	}
+	while (n > 2)
+	{
+		const std::size_t m = n;
+		const real_type limit = 2.0 * double(m) * eps;
+		// Muller cannot improve on a value that is within the rounding error of Horner's scheme, so such values are
+		// reported as zero; otherwise it would keep fitting parabolas through noise and may jump away from the root
+		auto f = [c, m, limit](const _cty& x)
+		{
+			real_type bound;
+			const _cty y = deflation::residual(c, m, x, bound);
+			return (abs(y) <= limit * bound) ? (_cty(0)) : (y);
+		};
+		// the typical root modulus, the radius of the circle the restarts are seeded on
+		real_type rho = pow(abs(c[0]) / abs(c[m - 1]), 1.0 / double(m - 1));
+		if (!(rho > 0.0 && rho < HUGE_VAL))
+			rho = 1.0;
+		// dividing out a point that is not a root would spoil all later ones, so every candidate is checked against
+		// the error bound, whatever Muller reports, and on failure the search is restarted on the circle of the typical
+		// root modulus, rotated by the golden angle each time
+		_cty best = _cty(0);
+		real_type best_ratio = HUGE_VAL;
+		bool ok = false;
+		for (unsigned int t = 0; t <= opts.restarts && !ok; ++t)
+		{
+			muller_result<_cty> r;
+			if (t == 0)
+				r = muller(f, _cty(0.5), _cty(-0.5), _cty(0), opts.muller);
+			else
+			{
+				const double phi = 2.39996322972865332 * double(t);
+				const _cty w = _cty(rho * std::cos(phi), rho * std::sin(phi));
+				r = muller(f, w * _cty(1.1), w * _cty(0.9), w, opts.muller);
+			}
+			real_type bound;
+			const real_type y = abs(deflation::residual(c, m, r.root, bound));
+			ok = (y <= limit * bound);
+			const real_type ratio = (bound > 0.0) ? (y / bound) : (real_type(HUGE_VAL));
+			if (ok || ratio < best_ratio)
+			{
+				best = r.root;
+				best_ratio = ratio;
+			}
+		}
+		verified += ok;
+		roots.push_back(best);
+		deflation::deflate(c, n, best);
+		--n;
+	}
+	roots.push_back(-c[0] / c[1]);
+	++verified;
+	if (opts.polish_iterations > 0)
+	{
+		// the working copy is spent, reload the original coefficients
+		for (int i = 0; i <= top; ++i)
+			c[i] = pol.get_coefficient(i);
+		for (_cty& z : roots)
+			z = deflation::polish(c, top + 1, z, opts.polish_iterations);
+	}
+	return verified;
+}
+
+template <typename _cty> inline std::vector<_cty> find_roots_muller(const Polynomial<_cty>& pol, const deflation_options& opts = deflation_options())
+{
+	deflation_workspace<_cty> ws;
+	std::vector<_cty> roots;
+	find_roots_muller(pol, roots, ws, opts);
+	return roots;
+}
+
+/** solves count polynomials, split over the given number of threads (0: one per hardware thread), each thread with its own workspace */
+template <typename _cty> inline void find_roots_muller(const Polynomial<_cty>* pols, std::vector<_cty>* roots, const std::size_t count, const unsigned int threads = 1, const deflation_options& opts = deflation_options())
+{
+	parallel::for_ranges(count, threads, [&](const std::size_t begin, const std::size_t end)
+	{
+		deflation_workspace<_cty> ws;
+		for (std::size_t i = begin; i < end; ++i)
+			find_roots_muller(pols[i], roots[i], ws, opts);
+	});
+}
+
+#endif
@@ -0,0 +1,465 @@
+#ifndef _FHP_TDESCARTES_HPP_INCLUDED_
+#define _FHP_TDESCARTES_HPP_INCLUDED_
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include "tbracket.hpp"
+#include "../util/tpolynomial.hpp"
+#include "../util/tconvolution.hpp"
+#include "../util/tparallel.hpp"
+
+
+/** settings for isolate_real_roots() */
+struct descartes_options
+{
+	/** bisection depth below the root bound [-B, B] after which an interval is reported unresolved */
+	unsigned int max_depth = 60;
+	/** intervals per bisection level, 0: twice the degree; intervals beyond are reported unresolved */
+	std::size_t max_intervals = 0;
+	/**
+	 * rounding errors of the transformed coefficients are taken as rounding*(n+2)*epsilon times the same computation on
+	 * absolute values (n coefficients); 4 leaves a margin over the observed errors, smaller values trust typical error
+	 * growth and can separate roots of badly conditioned polynomials at the risk of a wrong count
+	 */
+	double rounding = 4.0;
+	/** refinement of the isolating intervals in find_real_roots() */
+	bracket_options refine;
+};
+
+/** [lower, upper] holding real roots of a polynomial */
+template <typename _ty> struct root_interval
+{
+	_ty lower, upper;
+	/** isolated: the number of roots (1, or the multiplicity of an exact root lower == upper); otherwise an upper bound */
+	unsigned int count;
+	/** whether the interval holds exactly one distinct root; false for clusters that rounding errors could not separate */
+	bool isolated;
+};
+
+
+namespace descartes
+{
+
+	/** sign of x if it is certainly beyond the error bound e, 2 if it is not */
+	template <typename _ty> inline int certain_sign(const _ty x, const _ty e)
+	{
+		return (x > e) ? (1) : ((x < -e) ? (-1) : ((x == _ty(0) && e == _ty(0)) ? (0) : (2)));
+	}
+
+	/**
+	 * fewest and most sign variations of c[0..n-1] when every coefficient with |c[i]| <= e[i] may have either sign or
+	 * vanish; zeros known to be exact are skipped as in Descartes' rule
+	 */
+	template <typename _ty> inline void sign_variations(const _ty* c, const _ty* e, const std::size_t n, unsigned int& vmin, unsigned int& vmax)
+	{
+		// state: last nonzero sign none, +, -; lo/hi are the fewest/most variations reaching it
+		const unsigned int inf = ~0u;
+		unsigned int lo[3] = { 0, inf, inf }, hi[3] = { 0, 0, 0 };
+		bool reach[3] = { true, false, false };
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			const int s = certain_sign(c[i], e[i]);
+			if (s == 0)
+				continue;
+			unsigned int nlo[3] = { lo[0], lo[1], lo[2] }, nhi[3] = { hi[0], hi[1], hi[2] };
+			bool nreach[3] = { reach[0], reach[1], reach[2] };
+			if (s != 2)
+				nreach[0] = nreach[1] = nreach[2] = false, nlo[0] = nlo[1] = nlo[2] = inf, nhi[0] = nhi[1] = nhi[2] = 0;
+			// uncertain coefficients may also vanish, which keeps the old states (copied above)
+			for (int t = 1; t <= 2; ++t)
+			{
+				if (s != 2 && s != ((t == 1) ? (1) : (-1)))
+					continue;
+				for (int from = 0; from < 3; ++from)
+				{
+					if (!reach[from])
+						continue;
+					const unsigned int add = (from != 0 && from != t) ? (1) : (0);
+					nreach[t] = true;
+					nlo[t] = std::min(nlo[t], lo[from] + add);
+					nhi[t] = std::max(nhi[t], hi[from] + add);
+				}
+			}
+			for (int t = 0; t < 3; ++t)
+			{
+				reach[t] = nreach[t];
+				lo[t] = nlo[t];
+				hi[t] = nhi[t];
+			}
+		}
+		vmin = inf;
+		vmax = 0;
+		for (int t = 0; t < 3; ++t)
+			if (reach[t])
+			{
+				vmin = std::min(vmin, lo[t]);
+				vmax = std::max(vmax, hi[t]);
+			}
+	}
+
+	/** sign variations of c[0..n-1], or of the coefficients of p(-x) for negate, so a bound on the positive roots */
+	template <typename _ty> inline unsigned int variations(const _ty* c, const std::size_t n, const bool negate)
+	{
+		unsigned int res = 0;
+		int last = 0;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			if (c[i] == _ty(0))
+				continue;
+			const int s = ((c[i] < _ty(0)) != (negate && i % 2 == 1)) ? (-1) : (1);
+			res += (last != 0 && s != last);
+			last = s;
+		}
+		return res;
+	}
+
+	/**
+	 * Fujiwara's bound on the moduli of the roots of c[0..n-1] (c[n-1] != 0), rounded up to a power of two so that
+	 * all bisection points are exact
+	 */
+	template <typename _ty> inline _ty root_bound(const _ty* c, const std::size_t n)
+	{
+		using std::abs;
+		const std::size_t d = n - 1;
+		_ty b = _ty(0);
+		for (std::size_t k = 1; k <= d; ++k)
+		{
+			_ty r = abs(c[d - k] / c[d]);
+			if (k == d)
+				r /= _ty(2);
+			r = std::pow(r, _ty(1) / _ty(double(k)));
+			if (r > b)
+				b = r;
+		}
+		b *= _ty(2);
+		_ty p = _ty(1);
+		while (p < b)
+			p *= _ty(2);
+		while (p / _ty(2) >= b && p > _ty(1))
+			p /= _ty(2);
+		return p;
+	}
+
+	/**
+	 * sign of p(x) for p = c[0..n-1] by Horner's scheme: 0 for an exact zero, 2 if it is within twice the error bound
+	 * gamma of test(), so that intervals with certain signs at both ends get certain transforms once they are narrow enough
+	 */
+	template <typename _ty> inline int point_sign(const _ty* c, const _ty* ac, const std::size_t n, const _ty x, const _ty gamma)
+	{
+		using std::abs;
+		_ty y = c[n - 1], e = ac[n - 1];
+		for (std::size_t k = n - 1; k-- > 0;)
+		{
+			y = y * x + c[k];
+			e = e * abs(x) + ac[k];
+		}
+		if (y == _ty(0))
+			return 0;
+		return certain_sign(y, _ty(2) * gamma * e);
+	}
+
+	/** what the test of one interval found */
+	enum verdict { none, isolated, split };
+
+	/**
+	 * Descartes' test on (a, b) for p = c[0..n-1]: q(x) = p(a + (b-a)x) and its transform (x+1)^d q(1/(x+1)), whose sign
+	 * variations bound the roots in (a, b). Each is also computed on |c| and |a|, which times gamma bounds the rounding
+	 * errors, so a coefficient only counts if its sign is certain. Computing q from p for every interval keeps the
+	 * errors from piling up along the bisection. The shifts are the quadratic ones: the bound holds for their
+	 * componentwise errors, which the fast convolution::taylor_shift() through Karatsuba and FFT products does not
+	 * have. sa, sb are the point_sign()s of p at a and b, computed once per point so that neighbouring intervals agree
+	 * on them. count gets the most variations possible, fewest the fewest.
+	 */
+	template <typename _ty> inline verdict test(const _ty* c, const _ty* ac, const std::size_t n, const _ty a, const _ty b, const int sa, const int sb, const _ty gamma, unsigned int& count, unsigned int& fewest)
+	{
+		using std::abs;
+		std::vector<_ty> buf(4 * n);
+		_ty* q = buf.data();
+		_ty* qe = q + n;
+		_ty* t = qe + n;
+		_ty* te = t + n;
+		convolution::taylor_shift_classic(c, n, a, q);
+		convolution::taylor_shift_classic(ac, n, abs(a), qe);
+		const _ty w = b - a;
+		_ty wk = _ty(1);
+		for (std::size_t k = 0; k < n; ++k)
+		{
+			q[k] *= wk;
+			qe[k] *= wk;
+			wk *= w;
+		}
+		std::reverse(q, q + n);
+		std::reverse(qe, qe + n);
+		convolution::taylor_shift_classic(q, n, _ty(1), t);
+		convolution::taylor_shift_classic(qe, n, _ty(1), te);
+		for (std::size_t k = 0; k < n; ++k)
+			te[k] *= gamma;
+		// p(a) is the leading and p(b) the constant coefficient of the transform
+		if (sa == 0)
+			t[n - 1] = te[n - 1] = _ty(0);
+		if (sb == 0)
+			t[0] = te[0] = _ty(0);
+		unsigned int vmin, vmax;
+		sign_variations(t, te, n, vmin, vmax);
+		count = vmax;
+		fewest = vmin;
+		if (vmax == 0)
+			return none;
+		if (vmax == 1 && vmin == 1)
+			return isolated;
+		if (vmax == 1 && (sa == 1 || sa == -1) && (sb == 1 || sb == -1))
+		{
+			count = (sa != sb) ? (1) : (0);
+			return (count == 1) ? (isolated) : (none);
+		}
+		return split;
+	}
+
+	/**
+	 * where to bisect (a, b): the first of a few points around the middle at which the sign of p is certain, so that
+	 * intervals do not end on roots (integer roots would otherwise meet dyadic midpoints); the middle if there is none.
+	 * The points are dyadic fractions of the interval, exact for dyadic ends.
+	 */
+	template <typename _ty> inline _ty split_point(const _ty* c, const _ty* ac, const std::size_t n, const _ty a, const _ty b, const _ty gamma, int& sign)
+	{
+		static const double at[5] = { 0.5, 0.4375, 0.5625, 0.375, 0.625 };
+		_ty first = a;
+		for (int k = 0; k < 5; ++k)
+		{
+			const _ty m = a + (b - a) * _ty(at[k]);
+			const int s = point_sign(c, ac, n, m, gamma);
+			if (k == 0)
+			{
+				first = m;
+				sign = s;
+			}
+			if (s == 1 || s == -1)
+			{
+				sign = s;
+				return m;
+			}
+		}
+		return first;
+	}
+
+}
+
+
+/**
+ * Real root isolation by Descartes' rule of signs with bisection (Vincent-Collins-Akritas): starting from the root
+ * bound [-B, B], every interval whose transformed polynomial shows no sign variation is dropped, one variation isolates
+ * a root, and more are bisected. The intervals of one bisection level are tested in parallel over the given number
+ * of threads (0: one per hardware thread). Rounding errors are bounded throughout, so an interval is only isolating if
+ * that holds for the computed coefficients including their errors; multiple roots and clusters closer than the
+ * rounding errors allow come out as unresolved intervals with an upper bound on their root count: p is within its
+ * rounding error at both ends and at every split point tried, or the sign variations of the transform are uncertain
+ * and bisection stops bringing their most below the parent's, or a level would exceed opts.max_intervals. Each such
+ * bound is also capped by Descartes' rule on p for its side of zero less the roots isolated there; the bounds of
+ * several unresolved intervals on one side are individual and may overlap.
+ * Returns disjoint intervals in increasing order; exact roots (at 0 or at split points) as lower == upper.
+ */
+template <typename _ty> inline std::vector<root_interval<_ty>> isolate_real_roots(const Polynomial<_ty>& pol, const unsigned int threads = 1, const descartes_options& opts = descartes_options())
+{
+	using std::abs;
+	std::vector<root_interval<_ty>> res;
+	int top = pol.degree();
+	while (top > 0 && pol.get_coefficient(top) == _ty(0))
+		--top;
+	if (top < 1)
+		return res;
+	std::size_t lead = 0;
+	while (pol.get_coefficient(unsigned(lead)) == _ty(0))
+		++lead;
+	if (lead > 0)
+		res.push_back(root_interval<_ty>{ _ty(0), _ty(0), unsigned(lead), true });
+	const std::size_t n = std::size_t(top) + 1 - lead;
+	if (n < 2)
+		return res;
+	std::vector<_ty> c(n), ac(n);
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		c[i] = pol.get_coefficient(unsigned(i + lead));
+		ac[i] = abs(c[i]);
+	}
+	const _ty bound = descartes::root_bound(c.data(), n);
+	const _ty gamma = _ty(opts.rounding * double(n + 2)) * std::numeric_limits<_ty>::epsilon();
+	auto certain = [](const int s) { return s == 1 || s == -1; };
+
+	struct node
+	{
+		_ty a, b;
+		unsigned int depth;
+		/** point_sign() at a and b */
+		int sa, sb;
+		/** the most sign variations of the parent */
+		unsigned int bound;
+	};
+	struct outcome
+	{
+		descartes::verdict v;
+		unsigned int count, fewest;
+		bool unresolved;
+		/** split point and point_sign() there */
+		_ty m;
+		int sm;
+	};
+	const std::size_t max_intervals = (opts.max_intervals > 0) ? (opts.max_intervals) : (2 * (n - 1));
+	std::vector<node> level(1, node{ -bound, bound, 0, descartes::point_sign(c.data(), ac.data(), n, -bound, gamma), descartes::point_sign(c.data(), ac.data(), n, bound, gamma), unsigned(n - 1) }), next;
+	std::vector<outcome> out;
+	while (!level.empty())
+	{
+		out.assign(level.size(), outcome{ descartes::none, 0, 0, false, _ty(0), 2 });
+		parallel::for_each_index(level.size(), threads, [&](const std::size_t i)
+		{
+			const node& nd = level[i];
+			outcome& o = out[i];
+			o.v = descartes::test(c.data(), ac.data(), n, nd.a, nd.b, nd.sa, nd.sb, gamma, o.count, o.fewest);
+			o.count = std::min(o.count, nd.bound);
+			if (o.v != descartes::split)
+				return;
+			o.m = descartes::split_point(c.data(), ac.data(), n, nd.a, nd.b, gamma, o.sm);
+			// p drowns in rounding errors all over the interval, the transform does (its variations are uncertain, down
+			// to none at all, and bisection no longer brings the most of them below the parent's), or it cannot be split
+			// any further
+			o.unresolved = (!certain(nd.sa) && !certain(nd.sb) && !certain(o.sm) && (nd.sa == 2 || nd.sb == 2 || o.sm == 2))
+				|| (nd.depth > 0 && o.fewest < o.count && o.count >= nd.bound)
+				|| nd.depth >= opts.max_depth || !(o.m > nd.a && o.m < nd.b);
+		});
+		next.clear();
+		for (std::size_t i = 0; i < level.size(); ++i)
+		{
+			const node& nd = level[i];
+			const outcome& o = out[i];
+			if (o.v == descartes::isolated || (o.v == descartes::split && (o.unresolved || next.size() + 2 > max_intervals)))
+				res.push_back(root_interval<_ty>{ nd.a, nd.b, o.count, o.v == descartes::isolated });
+			else if (o.v == descartes::split)
+			{
+				next.push_back(node{ nd.a, o.m, nd.depth + 1, nd.sa, o.sm, o.count });
+				if (o.sm == 0)
+					res.push_back(root_interval<_ty>{ o.m, o.m, 1, true });
+				next.push_back(node{ o.m, nd.b, nd.depth + 1, o.sm, nd.sb, o.count });
+			}
+		}
+		level.swap(next);
+	}
+	std::sort(res.begin(), res.end(), [](const root_interval<_ty>& x, const root_interval<_ty>& y) { return x.lower < y.lower || (x.lower == y.lower && x.upper < y.upper); });
+	// neighbouring unresolved intervals, and exact roots between them, belong to the same cluster
+	std::size_t k = 0;
+	for (std::size_t i = 0; i < res.size(); ++i)
+	{
+		const bool point = (res[i].lower == res[i].upper);
+		if (k > 0 && !res[k - 1].isolated && res[k - 1].upper == res[i].lower && (!res[i].isolated || point))
+		{
+			res[k - 1].upper = res[i].upper;
+			res[k - 1].count += res[i].count;
+		}
+		else if (k > 0 && !res[i].isolated && res[k - 1].lower == res[k - 1].upper && res[k - 1].upper == res[i].lower && !(k > 1 && res[k - 2].isolated == false && res[k - 2].upper == res[k - 1].lower))
+		{
+			res[k - 1].upper = res[i].upper;
+			res[k - 1].count += res[i].count;
+			res[k - 1].isolated = false;
+		}
+		else
+			res[k++] = res[i];
+	}
+	res.resize(k);
+	// an unresolved cluster holds at most the roots on its side of zero that Descartes' rule on p itself allows
+	// (exact, as the coefficients are) and the isolated ones there leave
+	const unsigned int bounds[2] = { descartes::variations(c.data(), n, false), descartes::variations(c.data(), n, true) };
+	unsigned int known[2] = { 0, 0 };
+	for (const root_interval<_ty>& r : res)
+		if (r.isolated && r.lower != _ty(0))
+			known[(r.lower < _ty(0)) ? (1) : (0)] += r.count;
+	for (root_interval<_ty>& r : res)
+		if (!r.isolated)
+		{
+			unsigned int most = 0;
+			for (int side = 0; side < 2; ++side)
+				if ((side == 0) ? (r.upper > _ty(0)) : (r.lower < _ty(0)))
+					most += bounds[side] - std::min(bounds[side], known[side]);
+			r.count = std::min(r.count, most);
+		}
+	return res;
+}
+
+/**
+ * Real roots of pol: isolate_real_roots() followed by the Illinois method on every isolating interval; exact roots
+ * are repeated by multiplicity. Unresolved clusters are searched for sign changes of the computed values on a grid
+ * (these roots are not certified), or contribute their midpoint once. Sorted increasingly.
+ */
+template <typename _ty> inline std::vector<_ty> find_real_roots(const Polynomial<_ty>& pol, const unsigned int threads = 1, const descartes_options& opts = descartes_options())
+{
+	using std::abs;
+	const std::vector<root_interval<_ty>> iv = isolate_real_roots(pol, threads, opts);
+	std::vector<_ty> roots;
+	const int top = pol.degree();
+	const _ty* c = &*pol.begin();
+	auto horner = [c, top](const _ty x)
+	{
+		_ty y = c[top];
+		for (int i = top; i-- > 0;)
+			y = y * x + c[i];
+		return y;
+	};
+	std::vector<std::vector<_ty>> refined(iv.size());
+	parallel::for_each_index(iv.size(), threads, [&](const std::size_t i)
+	{
+		const root_interval<_ty>& r = iv[i];
+		if (r.lower == r.upper)
+			refined[i].assign(r.count, r.lower);
+		else if (r.isolated)
+		{
+			_ty lo = r.lower, hi = r.upper;
+			const _ty flo = horner(lo), fhi = horner(hi);
+			if (!((flo < _ty(0) && fhi > _ty(0)) || (flo > _ty(0) && fhi < _ty(0))))
+			{
+				// an end on a neighbouring root: bracket from samples inside instead
+				_ty prev = lo, fprev = _ty(0);
+				for (int j = 1; j < 64; ++j)
+				{
+					const _ty x = r.lower + (r.upper - r.lower) * _ty(j) / _ty(64);
+					const _ty fx = horner(x);
+					if (fx == _ty(0))
+						continue;
+					if (fprev != _ty(0) && (fx < _ty(0)) != (fprev < _ty(0)))
+					{
+						lo = prev;
+						hi = x;
+						break;
+					}
+					prev = x;
+					fprev = fx;
+				}
+			}
+			refined[i].push_back(illinois(horner, lo, hi, opts.refine).root);
+		}
+		else
+		{
+			// no certainty left in a cluster: take the sign changes that plain Horner shows on a fine grid, or its
+			// middle if there are none
+			const unsigned int samples = 16 * r.count + 16;
+			_ty prev = r.lower, fprev = horner(r.lower);
+			for (unsigned int j = 1; j <= samples; ++j)
+			{
+				const _ty x = (j == samples) ? (r.upper) : (r.lower + (r.upper - r.lower) * _ty(j) / _ty(samples));
+				const _ty fx = horner(x);
+				if (fx == _ty(0))
+					continue;
+				if (fprev != _ty(0) && (fx < _ty(0)) != (fprev < _ty(0)))
+					refined[i].push_back(illinois(horner, prev, x, opts.refine).root);
+				prev = x;
+				fprev = fx;
+			}
+			if (refined[i].empty())
+				refined[i].push_back(r.lower + (r.upper - r.lower) / _ty(2));
+		}
+	});
+	for (const std::vector<_ty>& r : refined)
+		roots.insert(roots.end(), r.begin(), r.end());
+	return roots;
+}
+
+#endif
@@ -0,0 +1,345 @@
+#ifndef _FHP_TKRAWCZYK_HPP_INCLUDED_
+#define _FHP_TKRAWCZYK_HPP_INCLUDED_
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+#include "../util/tpolynomial.hpp"
+#include "../util/tinterval.hpp"
+#include "../util/tparallel.hpp"
+
+
+/** settings for verify_roots() and verify_real_roots() */
+struct krawczyk_options
+{
+	/** candidates whose Newton correction exceeds max_step*max(1, |z|) are rejected without any interval work */
+	double max_step = 1.0e-6;
+	/** Newton steps taken after that first correction, before the centre of the inclusion is fixed */
+	unsigned int refinements = 3;
+	/** the first inclusion radius tried is inflation times the Newton correction (plus a few ulps of z) */
+	double inflation = 4.0;
+	/** epsilon-inflation: each failed attempt multiplies the radius by growth */
+	double growth = 16.0;
+	unsigned int attempts = 4;
+	/** threads over the candidates; 0: one per hardware thread */
+	unsigned int threads = 1;
+};
+
+enum class root_status
+{
+	/** the region holds exactly one root, which also lies in the enclosure */
+	verified,
+	/** the candidate is too far from a root to be worth testing */
+	rejected,
+	/** the Krawczyk test failed for every radius tried (multiple or clustered roots, or too much rounding error) */
+	unverified,
+	/** verified, but an earlier candidate may have found the same root */
+	duplicate
+};
+
+/** the outcome for one candidate: _rty is ComplexDisc<double> for complex roots, Interval<double> for real ones */
+template <typename _rty> struct root_inclusion
+{
+	/** the region tested; it holds exactly one root if the status is verified */
+	_rty region;
+	/** the Krawczyk image of the region, a smaller set holding that root */
+	_rty enclosure;
+	root_status status;
+};
+
+
+namespace krawczyk
+{
+
+	template <typename _cty> inline Complex<double> to_complex(const _cty& z) { return Complex<double>(z.real(), z.imag()); }
+
+	/** p(z) and p'(z) by plain Horner for the Newton correction */
+	inline void value_and_derivative(const Complex<double>* c, const std::size_t nc, const Complex<double> z, Complex<double>& p, Complex<double>& dp)
+	{
+		p = c[nc - 1];
+		dp = Complex<double>(0.0);
+		for (std::size_t i = nc - 1; i-- > 0;)
+		{
+			dp = dp * z + p;
+			p = p * z + c[i];
+		}
+	}
+	inline void value_and_derivative(const double* c, const std::size_t nc, const double x, double& p, double& dp)
+	{
+		p = c[nc - 1];
+		dp = 0.0;
+		for (std::size_t i = nc - 1; i-- > 0;)
+		{
+			dp = dp * x + p;
+			p = p * x + c[i];
+		}
+	}
+
+	inline double modulus(const Complex<double>& z) { return std::hypot(z.real(), z.imag()); }
+	inline double modulus(const double x) { return std::fabs(x); }
+	inline bool finite(const Complex<double>& z) { return std::isfinite(z.real()) && std::isfinite(z.imag()); }
+	inline bool finite(const double x) { return std::isfinite(x); }
+
+	/** the types of one flavour: point and region type, and the region centred at z with radius r */
+	template <typename _pty> struct region_of;
+	template <> struct region_of<Complex<double>>
+	{
+		typedef ComplexDisc<double> type;
+		static inline type make(const Complex<double> z, const double r) { return type(z, r); }
+		/** X - z for X = make(z, r) */
+		static inline type offset(const Complex<double>, const double r) { return type(Complex<double>(0.0), r); }
+		static inline double mag_up(const Complex<double> z) { return rounding::hypot_up(z.real(), z.imag()); }
+		/** i*c = d + (error of at most e) */
+		static inline void scale(const Complex<double> c, const double i, Complex<double>& d, double& e)
+		{
+			double lr, li;
+			d = Complex<double>(eft::two_prod(c.real(), i, lr), eft::two_prod(c.imag(), i, li));
+			e = rounding::directed<double>::add_up(std::fabs(lr), std::fabs(li));
+		}
+	};
+	template <> struct region_of<double>
+	{
+		typedef Interval<double> type;
+		static inline type make(const double x, const double r)
+		{
+			typedef rounding::directed<double> R;
+			return type(R::sub_down(x, r), R::add_up(x, r));
+		}
+		static inline type offset(const double x, const double r) { return make(x, r) - type(x); }
+		static inline double mag_up(const double x) { return std::fabs(x); }
+		static inline void scale(const double c, const double i, double& d, double& e)
+		{
+			d = eft::two_prod(c, i, e);
+			e = std::fabs(e);
+		}
+	};
+
+	/** Horner with upward rounding on nonnegative coefficients */
+	inline double horner_up(const std::vector<double>& a, const double t)
+	{
+		typedef rounding::directed<double> R;
+		if (a.empty())
+			return 0.0;
+		double res = a.back();
+		for (std::size_t i = a.size() - 1; i-- > 0;)
+			res = R::add_up(R::mul_up(res, t), a[i]);
+		return res;
+	}
+
+	/**
+	 * p' in Taylor form around the centre z, set up once per polynomial: for X the region of radius r around z,
+	 *   p'(X) is inside p'(z) + (r |p''(z)| + r^2/2 Q'''(|z| + r)) times the unit disc (or [-1, 1]),
+	 * with Q(t) = sum |c_i| t^i over the coefficients c_i of p, as Q''' bounds the remainder. p'(z) and p''(z) come
+	 * from compensated Horner with its error bound once per candidate, Q''' from Horner with upward rounding once per
+	 * radius. Horner on the region itself costs several times more in circular arithmetic, overestimates
+	 * exponentially in the degree on rectangles, where every multiplication by a complex number rotates the box, and
+	 * the mean-value form r Q''(|z| + r) alone is far too wide at ill-conditioned roots.
+	 */
+	template <typename _pty> struct derivative_form
+	{
+		typedef region_of<_pty> reg;
+		/** the coefficients of p' and p'', rounded ... */
+		std::vector<_pty> d1, d2;
+		/** ... with these errors */
+		std::vector<double> e1, e2;
+		/** upper bounds of the coefficients of Q''' */
+		std::vector<double> q3;
+
+		inline derivative_form(const _pty* c, const std::size_t nc)
+		{
+			typedef rounding::directed<double> R;
+			_pty d;
+			double e;
+			for (std::size_t i = 1; i < nc; ++i)
+			{
+				reg::scale(c[i], double(i), d, e);
+				d1.push_back(d);
+				e1.push_back(e);
+				if (i < 2)
+					continue;
+				reg::scale(c[i], double(i) * double(i - 1), d, e);
+				d2.push_back(d);
+				e2.push_back(e);
+				if (i < 3)
+					continue;
+				q3.push_back(R::mul_up(double(i) * double(i - 1) * double(i - 2), reg::mag_up(c[i])));
+			}
+		}
+
+		/** the polynomial with coefficients d (off by at most e) at z, and in bound a bound on its error */
+		static inline _pty evaluate(const std::vector<_pty>& d, const std::vector<double>& e, const _pty z, double& bound)
+		{
+			if (d.empty())
+			{
+				bound = 0.0;
+				return _pty(0.0);
+			}
+			const _pty res = polyeval::compensated_horner(d.data(), d.size(), z, &bound);
+			bound = rounding::directed<double>::add_up(bound, horner_up(e, reg::mag_up(z)));
+			return res;
+		}
+		/** p'(z), and in bound a bound on its error */
+		inline _pty at(const _pty z, double& bound) const { return evaluate(d1, e1, z, bound); }
+		/** upper bound of |p''(z)| */
+		inline double curvature(const _pty z) const
+		{
+			double bound;
+			const _pty p2 = evaluate(d2, e2, z, bound);
+			return rounding::directed<double>::add_up(reg::mag_up(p2), bound);
+		}
+		/** upper bound of |p'(x) - p'(z)| over the region of radius r around z, for p2 = curvature(z) */
+		inline double spread(const _pty z, const double r, const double p2) const
+		{
+			typedef rounding::directed<double> R;
+			const double remainder = R::mul_up(R::mul_up(R::mul_up(r, r), 0.5), horner_up(q3, R::add_up(reg::mag_up(z), r)));
+			return R::add_up(R::mul_up(r, p2), remainder);
+		}
+	};
+
+	/**
+	 * one candidate: Newton steps with the compensated value p(z) and its error bound, then the Krawczyk operator
+	 *   K(X) = z - Y p(z) + (1 - Y p'(X)) (X - z),  Y = 1/p'(z)
+	 * on regions X around z of growing radius; K(X) inside the interior of X proves a unique root in X, and it lies in
+	 * K(X).
+	 */
+	template <typename _pty> inline root_inclusion<typename region_of<_pty>::type> verify(const _pty* c, const std::size_t nc, const derivative_form<_pty>& df, const _pty z0, const krawczyk_options& opts)
+	{
+		typedef region_of<_pty> reg;
+		typedef typename reg::type rty;
+		root_inclusion<rty> res;
+		res.region = res.enclosure = reg::make(z0, 0.0);
+		res.status = root_status::rejected;
+		// Newton steps on the compensated value: near an ill-conditioned root plain Horner has no correct digits left
+		_pty p, dp, z = z0;
+		double bound;
+		_pty pz = polyeval::compensated_horner(c, nc, z, &bound);
+		for (unsigned int k = 0; k <= opts.refinements; ++k)
+		{
+			value_and_derivative(c, nc, z, p, dp);
+			const _pty step = pz / dp;
+			if (!finite(step) || (k == 0 && !(modulus(step) <= opts.max_step * std::max(1.0, modulus(z0)))))
+				return res;
+			z = z - step;
+			pz = polyeval::compensated_horner(c, nc, z, &bound);
+		}
+		double dbound;
+		const _pty dz = df.at(z, dbound);
+		const _pty y = _pty(1.0) / dz;
+		if (!finite(y))
+			return res;
+		res.status = root_status::unverified;
+		const rty yr(y), shifted = reg::make(z, 0.0) - yr * reg::make(pz, bound);
+		const double p2 = df.curvature(z);
+		double r = opts.inflation * modulus(y) * (modulus(pz) + bound) + 4.0 * std::numeric_limits<double>::epsilon() * modulus(z) + std::numeric_limits<double>::min();
+		for (unsigned int k = 0; k < opts.attempts; ++k, r *= opts.growth)
+		{
+			const rty x = reg::make(z, r);
+			const rty kx = shifted + (rty(1.0) - yr * reg::make(dz, rounding::directed<double>::add_up(dbound, df.spread(z, r, p2)))) * reg::offset(z, r);
+			if (in_interior(kx, x))
+			{
+				res.region = x;
+				res.enclosure = kx;
+				res.status = root_status::verified;
+				break;
+			}
+		}
+		if (res.status == root_status::unverified)
+			res.region = res.enclosure = reg::make(z, r / opts.growth);
+		return res;
+	}
+
+	inline bool apart(const ComplexDisc<double>& a, const ComplexDisc<double>& b) { return disjoint(a, b); }
+	inline bool apart(const Interval<double>& a, const Interval<double>& b) { return a < b || b < a; }
+	inline double lower_real(const ComplexDisc<double>& d) { return rounding::directed<double>::sub_down(d.center().real(), d.radius()); }
+	inline double upper_real(const ComplexDisc<double>& d) { return rounding::directed<double>::add_up(d.center().real(), d.radius()); }
+	inline double lower_real(const Interval<double>& x) { return x.lower(); }
+	inline double upper_real(const Interval<double>& x) { return x.upper(); }
+
+	/**
+	 * two verified candidates whose enclosures may meet could have found the same root: the later one is marked
+	 * duplicate. Enclosures are tiny, so sorting by their lower real bound leaves few pairs to compare.
+	 */
+	template <typename _rty> inline void mark_duplicates(std::vector<root_inclusion<_rty>>& res)
+	{
+		std::vector<std::size_t> order;
+		for (std::size_t i = 0; i < res.size(); ++i)
+			if (res[i].status == root_status::verified)
+				order.push_back(i);
+		auto left = [&](const std::size_t i) { return lower_real(res[i].enclosure); };
+		auto right = [&](const std::size_t i) { return upper_real(res[i].enclosure); };
+		std::sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b) { return left(a) < left(b); });
+		for (std::size_t a = 0; a < order.size(); ++a)
+			for (std::size_t b = a + 1; b < order.size() && left(order[b]) <= right(order[a]); ++b)
+			{
+				const std::size_t i = std::min(order[a], order[b]), j = std::max(order[a], order[b]);
+				if (res[i].status != root_status::duplicate && res[j].status == root_status::verified && !apart(res[i].enclosure, res[j].enclosure))
+					res[j].status = root_status::duplicate;
+			}
+	}
+
+}
+
+
+/**
+ * Certifies approximate roots of a polynomial with complex double coefficients (std::complex<double> or
+ * Complex<double>), e.g. from find_roots_muller() or find_roots_aberth(): for every candidate either a disc that
+ * provably holds exactly one root (interval Newton in the form of Krawczyk, in circular arithmetic), or the reason it
+ * could not be certified. Candidates far from any root are rejected after one Newton correction, before any interval
+ * work. The candidates are spread over opts.threads; afterwards verified discs whose root enclosures may overlap are
+ * resolved in favour of the earlier candidate, so if all deg(p) candidates come out verified, all roots are
+ * certified.
+ */
+template <typename _cty> inline std::vector<root_inclusion<ComplexDisc<double>>> verify_roots(const Polynomial<_cty>& pol, const std::vector<_cty>& candidates, const krawczyk_options& opts = krawczyk_options())
+{
+	static_assert(std::is_same<typename _cty::value_type, double>::value, "verify_roots() needs double coefficients");
+	std::vector<root_inclusion<ComplexDisc<double>>> res(candidates.size());
+	int top = pol.degree();
+	while (top > 0 && pol.get_coefficient(top) == _cty(0))
+		--top;
+	std::vector<Complex<double>> c(std::size_t(top) + 1);
+	for (int i = 0; i <= top; ++i)
+		c[i] = krawczyk::to_complex(pol.get_coefficient(i));
+	if (top < 1)
+	{
+		for (std::size_t k = 0; k < candidates.size(); ++k)
+			res[k] = root_inclusion<ComplexDisc<double>>{ ComplexDisc<double>(krawczyk::to_complex(candidates[k])), ComplexDisc<double>(krawczyk::to_complex(candidates[k])), root_status::rejected };
+		return res;
+	}
+	const krawczyk::derivative_form<Complex<double>> df(c.data(), c.size());
+	parallel::for_each_index(candidates.size(), opts.threads, [&](const std::size_t k)
+	{
+		res[k] = krawczyk::verify(c.data(), c.size(), df, krawczyk::to_complex(candidates[k]), opts);
+	}, 4);
+	krawczyk::mark_duplicates(res);
+	return res;
+}
+
+/** the same for real roots of a polynomial with double coefficients, with intervals in place of discs */
+inline std::vector<root_inclusion<Interval<double>>> verify_real_roots(const Polynomial<double>& pol, const std::vector<double>& candidates, const krawczyk_options& opts = krawczyk_options())
+{
+	std::vector<root_inclusion<Interval<double>>> res(candidates.size());
+	int top = pol.degree();
+	while (top > 0 && pol.get_coefficient(top) == 0.0)
+		--top;
+	std::vector<double> c(std::size_t(top) + 1);
+	for (int i = 0; i <= top; ++i)
+		c[i] = pol.get_coefficient(i);
+	if (top < 1)
+	{
+		for (std::size_t k = 0; k < candidates.size(); ++k)
+			res[k] = root_inclusion<Interval<double>>{ Interval<double>(candidates[k]), Interval<double>(candidates[k]), root_status::rejected };
+		return res;
+	}
+	const krawczyk::derivative_form<double> df(c.data(), c.size());
+	parallel::for_each_index(candidates.size(), opts.threads, [&](const std::size_t k)
+	{
+		res[k] = krawczyk::verify(c.data(), c.size(), df, candidates[k], opts);
+	}, 4);
+	krawczyk::mark_duplicates(res);
+	return res;
+}
+
+#endif
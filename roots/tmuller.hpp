@@ -0,0 +1,105 @@
+#ifndef _FHP_TMULLER_HPP_INCLUDED_
+#define _FHP_TMULLER_HPP_INCLUDED_
+
+#include <cmath>
+#include <complex>
+
+
+/** settings for muller() */
+struct muller_options
+{
+	/** stop once |f(x)| drops below this value, or below the error bound that f reports (see muller()) */
+	double tolerance = 1.0e-10;
+	/** stop once a step is at most step_tolerance*|x| (0: only the residual test applies) */
+	double step_tolerance = 0.0;
+	unsigned int max_iterations = 100;
+};
+
+template <typename _ty> struct muller_result
+{
+	_ty root;
+	/** f(root) */
+	_ty residual;
+	/** bound on the rounding error of residual as reported by f, 0 if f reports none */
+	double residual_bound;
+	unsigned int iterations;
+	/** number of calls to f, three for the starting points plus one per iteration */
+	unsigned int evaluations;
+	/** whether the residual test or the step test was met; a degenerate parabola, a stalled step or running out of iterations leave it false */
+	bool converged;
+};
+
+
+namespace muller_detail
+{
+
+	/** f(x, &bound) for an f that reports a bound on the rounding error of its value, f(x) with a zero bound otherwise */
+	template <typename _ty, typename _fn> inline auto evaluate(_fn& f, const _ty& x, double& bound, int) -> decltype(f(x, &bound))
+	{
+		return f(x, &bound);
+	}
+	template <typename _ty, typename _fn> inline _ty evaluate(_fn& f, const _ty& x, double& bound, long)
+	{
+		bound = 0.0;
+		return f(x);
+	}
+
+}
+
+
+/**
+ * Muller's method: fits a parabola through the last three iterates and steps to its root closest to the newest one.
+ * The iterates and their function values live in a three-slot ring buffer, so every iteration evaluates f exactly
+ * once. _ty has to be a complex type (std::complex or Complex), as the parabola may have no real root.
+ * If f can be called as f(x, double* bound) and stores a bound on the rounding error of f(x) there (as
+ * Polynomial::compensatedAt does), the iteration also stops once |f(x)| is within that bound: the residual is then
+ * indistinguishable from zero, and opts.tolerance may be set to 0 to rely on the bound alone.
+ */
+template <typename _ty, typename _fn> inline muller_result<_ty> muller(_fn&& f, const _ty x0, const _ty x1, const _ty x2, const muller_options& opts = muller_options())
+{
+	using std::abs;
+	using std::sqrt;
+	_ty x[3] = { x0, x1, x2 };
+	double bound[3];
+	_ty y[3] = { muller_detail::evaluate(f, x0, bound[0], 0), muller_detail::evaluate(f, x1, bound[1], 0), muller_detail::evaluate(f, x2, bound[2], 0) };
+	muller_result<_ty> res;
+	res.iterations = 0;
+	res.evaluations = 3;
+	// slot of the newest point; the oldest one is overwritten next
+	unsigned int k = 2;
+	// set when the last step met opts.step_tolerance; a step that is zero or lost in rounding does not count
+	bool small_step = false;
+	while (abs(y[k]) >= opts.tolerance && abs(y[k]) > bound[k] && res.iterations < opts.max_iterations)
+	{
+		const unsigned int i1 = (k + 1) % 3, i2 = (k + 2) % 3, i3 = k;
+		const _ty d13 = x[i1] - x[i3], d23 = x[i2] - x[i3];
+		const _ty e13 = y[i1] - y[i3], e23 = y[i2] - y[i3];
+		const _ty a = (e13 * d23 - e23 * d13) / (d13 * d23 * (x[i1] - x[i2]));
+		const _ty b = e13 / d13 - a * d13;
+		const _ty c = y[i3];
+		// the sign follows Re(b), to avoid cancellation in the denominator
+		const _ty s = sqrt(b * b - _ty(4) * a * c);
+		const _ty den = (b.real() < 0) ? (b - s) : (b + s);
+		const _ty step = (abs(den) == 0) ? (_ty(0)) : (_ty(2) * c / den);
+		k = i1;
+		x[k] = x[i3] - step;
+		y[k] = muller_detail::evaluate(f, x[k], bound[k], 0);
+		++res.evaluations;
+		++res.iterations;
+		// a degenerate parabola (zero step) or a step lost in rounding ends the iteration, but is no convergence
+		if (abs(step) == 0 || x[k] == x[i3])
+			break;
+		if (abs(step) <= opts.step_tolerance * abs(x[k]))
+		{
+			small_step = true;
+			break;
+		}
+	}
+	res.root = x[k];
+	res.residual = y[k];
+	res.residual_bound = bound[k];
+	res.converged = (abs(y[k]) < opts.tolerance) || (abs(y[k]) <= bound[k]) || small_step;
+	return res;
+}
+
+#endif
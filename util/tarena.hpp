@@ -0,0 +1,181 @@
+#ifndef _FHP_TARENA_HPP_INCLUDED_
+#define _FHP_TARENA_HPP_INCLUDED_
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <type_traits>
+
+
+namespace memory
+{
+
+	/**
+	 * Monotonic arena: allocations bump a pointer through a list of chunks and deallocation is a no-op (except for the
+	 * most recent block, which is given back so a growing vector can reuse its space). reset() releases everything at
+	 * once in O(1) and keeps the chunks for the next batch. Not thread-safe; use one arena per thread (thread_arena()).
+	 */
+	class arena
+	{
+	protected:
+		struct chunk
+		{
+			char* begin;
+			std::size_t size;
+		};
+		std::vector<chunk> chunks;
+		/** chunk currently bumped and the offset in it */
+		std::size_t current, offset;
+		std::size_t first_size;
+		/** bytes handed out since the last reset, and the high-water mark over all batches */
+		std::size_t used, peak;
+
+		/** moves on to the next chunk that can hold bytes (aligned), allocating a new one if needed */
+		inline bool next_chunk(const std::size_t bytes, const std::size_t align)
+		{
+			const std::size_t need = bytes + align;
+			for (std::size_t i = current + 1; i < chunks.size(); ++i)
+				if (chunks[i].size >= need)
+				{
+					current = i;
+					offset = 0;
+					return true;
+				}
+			std::size_t size = (chunks.empty()) ? (first_size) : (2 * chunks.back().size);
+			if (size < need)
+				size = need;
+			char* p = static_cast<char*>(std::malloc(size));
+			if (p == nullptr)
+				return false;
+			chunks.push_back(chunk{ p, size });
+			current = chunks.size() - 1;
+			offset = 0;
+			return true;
+		}
+
+	public:
+		/** the first chunk gets initial bytes, every further one twice the size of the previous */
+		inline explicit arena(const std::size_t initial = 64 * 1024) : current(0), offset(0), first_size((initial < 64) ? (64) : (initial)), used(0), peak(0) {}
+		arena(const arena&) = delete;
+		arena& operator=(const arena&) = delete;
+		inline ~arena()
+		{
+			for (const chunk& c : chunks)
+				std::free(c.begin);
+		}
+
+		/** align has to be a power of two; it may exceed that of malloc(), the padding then comes out of the chunk */
+		inline void* allocate(const std::size_t bytes, const std::size_t align = alignof(std::max_align_t))
+		{
+			if (!chunks.empty())
+			{
+				// the address is aligned, not the offset: the chunk itself is only aligned for max_align_t
+				const std::uintptr_t base = reinterpret_cast<std::uintptr_t>(chunks[current].begin);
+				const std::size_t pos = std::size_t(((base + offset + align - 1) & ~std::uintptr_t(align - 1)) - base);
+				if (pos + bytes <= chunks[current].size)
+				{
+					offset = pos + bytes;
+					used += bytes;
+					return chunks[current].begin + pos;
+				}
+			}
+			if (!next_chunk(bytes, align))
+				throw std::bad_alloc();
+			return allocate(bytes, align);
+		}
+		/** only the most recent allocation is reclaimed */
+		inline void deallocate(void* p, const std::size_t bytes)
+		{
+			if (!chunks.empty() && static_cast<char*>(p) + bytes == chunks[current].begin + offset)
+			{
+				offset -= bytes;
+				used -= bytes;
+			}
+		}
+		/** releases all allocations at once; everything allocated from the arena must be dead by then */
+		inline void reset()
+		{
+			if (used > peak)
+				peak = used;
+			current = 0;
+			offset = 0;
+			used = 0;
+		}
+
+		/** bytes handed out since the last reset */
+		inline std::size_t bytes_used() const { return used; }
+		/** largest bytes_used() seen at a reset (or now) */
+		inline std::size_t bytes_peak() const { return (used > peak) ? (used) : (peak); }
+		/** bytes held from the system */
+		inline std::size_t bytes_reserved() const
+		{
+			std::size_t s = 0;
+			for (const chunk& c : chunks)
+				s += c.size;
+			return s;
+		}
+	};
+
+	/** arena of the calling thread */
+	inline arena& thread_arena()
+	{
+		static thread_local arena a;
+		return a;
+	}
+
+	/** resets thread_arena() when it goes out of scope, so one batch of temporaries is released in O(1) */
+	class arena_scope
+	{
+	protected:
+		arena& a;
+
+	public:
+		inline explicit arena_scope(arena& which = thread_arena()) : a(which) {}
+		arena_scope(const arena_scope&) = delete;
+		arena_scope& operator=(const arena_scope&) = delete;
+		inline ~arena_scope() { a.reset(); }
+	};
+
+
+	/**
+	 * Standard allocator drawing from an arena, which has to be named explicitly (there is no default constructor, so
+	 * a container cannot silently bind to whichever thread's arena happens to construct it). The arena is not
+	 * thread-safe and copies of the allocator share it: all containers using one arena have to be grown and shrunk by one
+	 * thread at a time, typically by giving each thread its own (thread_arena()). Containers using it must not outlive
+	 * the arena's next reset(). Moves carry the arena along.
+	 */
+	template <typename _ty> class arena_allocator
+	{
+		template <typename> friend class arena_allocator;
+
+	protected:
+		arena* a;
+
+	public:
+		typedef _ty value_type;
+		typedef std::true_type propagate_on_container_move_assignment;
+		typedef std::true_type propagate_on_container_swap;
+		typedef std::false_type is_always_equal;
+
+		inline explicit arena_allocator(arena& which) noexcept : a(&which) {}
+		template <typename aux> inline arena_allocator(const arena_allocator<aux>& other) noexcept : a(other.a) {}
+
+		inline _ty* allocate(const std::size_t n)
+		{
+			return static_cast<_ty*>(a->allocate(n * sizeof(_ty), alignof(_ty)));
+		}
+		inline void deallocate(_ty* p, const std::size_t n) noexcept
+		{
+			a->deallocate(p, n * sizeof(_ty));
+		}
+		inline arena& resource() const { return *a; }
+
+		template <typename aux> inline bool operator==(const arena_allocator<aux>& other) const { return a == other.a; }
+		template <typename aux> inline bool operator!=(const arena_allocator<aux>& other) const { return a != other.a; }
+	};
+
+}
+
+#endif
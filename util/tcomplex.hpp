@@ -367,17 +367,20 @@ public:
 	/** The complex number, raised to the power of the argument */
 	inline Complex<_ty> pow(const _ty x) const
 	{
-		return Complex<_ty>(::pow(abs(), x), arg()*x, CXPOLAR);
+		using std::pow;
+		return Complex<_ty>(pow(abs(), x), arg()*x, CXPOLAR);
 	}
 	/** Square root of the complx number */
 	inline Complex<_ty> sqrt() const
 	{
-		return Complex<_ty>(::sqrt(abs()), arg() / 2, CXPOLAR);
+		using std::sqrt;
+		return Complex<_ty>(sqrt(abs()), arg() / 2, CXPOLAR);
 	}
 	/** x-th root of the complx number */
 	inline Complex<_ty> root(const _ty x) const
 	{
-		return Complex<_ty>(::pow(abs(), 1 / x), arg() / x, CXPOLAR);
+		using std::pow;
+		return Complex<_ty>(pow(abs(), 1 / x), arg() / x, CXPOLAR);
 	}
 
 	/// direct access
@@ -402,8 +405,10 @@ public:
 		}
 		else
 		{
-			res[0] = ::sqrt(re*re + im*im);
-			res[1] = ::atan2(im, re);
+			using std::sqrt;
+			using std::atan2;
+			res[0] = sqrt(re*re + im*im);
+			res[1] = atan2(im, re);
 		}
 		return res;
 	}
@@ -438,12 +443,14 @@ public:
 	/** absolute value */
 	inline _ty abs() const
 	{
-		return ::sqrt(re*re + im*im);
+		using std::sqrt;
+		return sqrt(re*re + im*im);
 	}
 	/** complex argument */
 	inline _ty arg() const
 	{
-		return ::atan2(im, re);
+		using std::atan2;
+		return atan2(im, re);
 	}
 	/** square of the absolute value */
 	inline _ty norm() const
@@ -510,11 +517,13 @@ template <typename _ty> inline Complex<_ty> operator/(const _ty a, const Complex
 
 template <typename _ty> inline _ty abs(const Complex<_ty>& z)
 {
-	return ::sqrt(z.real()*z.real() + z.imag()*z.imag());
+	using std::sqrt;
+	return sqrt(z.real()*z.real() + z.imag()*z.imag());
 }
 template <typename _ty> inline _ty arg(const Complex<_ty>& z)
 {
-	return ::atan2(z.imag(), z.real());
+	using std::atan2;
+	return atan2(z.imag(), z.real());
 }
 template <typename _ty> inline _ty norm(const Complex<_ty>& z)
 {
@@ -530,7 +539,8 @@ template <typename _ty> inline _ty _imag(const Complex<_ty>& z)
 }
 template <typename _ty> inline Complex<_ty> pow(const Complex<_ty>& z, const _ty x)
 {
-	return Complex<_ty>(::pow(abs(z), x), arg(z)*x, CXPOLAR);
+	using std::pow;
+	return Complex<_ty>(pow(abs(z), x), arg(z)*x, CXPOLAR);
 }
 template <typename _ty> inline Complex<_ty> sqr(const Complex<_ty>& z)
 {
@@ -538,11 +548,13 @@ template <typename _ty> inline Complex<_ty> sqr(const Complex<_ty>& z)
 }
 template <typename _ty> inline Complex<_ty> root(const Complex<_ty>& z, const _ty x)
 {
-	return Complex<_ty>(::pow(abs(z), 1.0/x), arg(z)/x, CXPOLAR);
+	using std::pow;
+	return Complex<_ty>(pow(abs(z), 1.0/x), arg(z)/x, CXPOLAR);
 }
 template <typename _ty> inline Complex<_ty> sqrt(const Complex<_ty>& z)
 {
-	return Complex<_ty>(::sqrt(abs(z)), arg(z) / 2, CXPOLAR);
+	using std::sqrt;
+	return Complex<_ty>(sqrt(abs(z)), arg(z) / 2, CXPOLAR);
 }
 template <typename _ty> inline int is_real(const Complex<_ty>& z)
 {
@@ -560,6 +572,54 @@ template <typename _ty> inline Complex<_ty> conj(const Complex<_ty>& z)
 {
 	return Complex<_ty>(z.real(), -(z.imag()), CXARITHMETIC);
 }
+/// elementary functions in cartesian form, so tiny imaginary parts (as in complex-step differentiation) stay accurate
+template <typename _ty> inline Complex<_ty> log(const Complex<_ty>& z)
+{
+	using std::log;
+	using std::hypot;
+	using std::atan2;
+	return Complex<_ty>(log(hypot(z.real(), z.imag())), atan2(z.imag(), z.real()), CXARITHMETIC);
+}
+template <typename _ty> inline Complex<_ty> sin(const Complex<_ty>& z)
+{
+	using std::sin;
+	using std::cos;
+	using std::sinh;
+	using std::cosh;
+	return Complex<_ty>(sin(z.real()) * cosh(z.imag()), cos(z.real()) * sinh(z.imag()), CXARITHMETIC);
+}
+template <typename _ty> inline Complex<_ty> cos(const Complex<_ty>& z)
+{
+	using std::sin;
+	using std::cos;
+	using std::sinh;
+	using std::cosh;
+	return Complex<_ty>(cos(z.real()) * cosh(z.imag()), -sin(z.real()) * sinh(z.imag()), CXARITHMETIC);
+}
+template <typename _ty> inline Complex<_ty> tan(const Complex<_ty>& z)
+{
+	return sin(z) / cos(z);
+}
+template <typename _ty> inline Complex<_ty> sinh(const Complex<_ty>& z)
+{
+	using std::sin;
+	using std::cos;
+	using std::sinh;
+	using std::cosh;
+	return Complex<_ty>(sinh(z.real()) * cos(z.imag()), cosh(z.real()) * sin(z.imag()), CXARITHMETIC);
+}
+template <typename _ty> inline Complex<_ty> cosh(const Complex<_ty>& z)
+{
+	using std::sin;
+	using std::cos;
+	using std::sinh;
+	using std::cosh;
+	return Complex<_ty>(cosh(z.real()) * cos(z.imag()), sinh(z.real()) * sin(z.imag()), CXARITHMETIC);
+}
+template <typename _ty> inline Complex<_ty> tanh(const Complex<_ty>& z)
+{
+	return sinh(z) / cosh(z);
+}
 
 #ifdef _STD_OSTREAM_INCLUDED_
 /// output override
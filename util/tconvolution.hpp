@@ -0,0 +1,398 @@
+#ifndef _FHP_TCONVOLUTION_HPP_INCLUDED_
+#define _FHP_TCONVOLUTION_HPP_INCLUDED_
+
+#include <complex>
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <type_traits>
+
+
+namespace convolution
+{
+
+	/// tunable crossover points
+	/** length of the shorter factor, below which the schoolbook product is used */
+	inline std::size_t& karatsuba_threshold() { static std::size_t t = 48; return t; }
+	/** length of the shorter factor, from which on the FFT product is used (if the coefficient type supports it) */
+	inline std::size_t& fft_threshold() { static std::size_t t = 384; return t; }
+
+
+	/// FFT support for coefficient types
+	/** float and double, the types a transform in double carries without losing precision (long double would) */
+	template <typename _ty> struct fft_real : std::integral_constant<bool, std::is_same<_ty, float>::value || std::is_same<_ty, double>::value> {};
+
+	/** maps a coefficient type onto std::complex<double> and back; kind is 0 (no FFT), 1 (real) or 2 (complex) */
+	template <typename _ty> struct fft_traits
+	{
+		static const int kind = fft_real<_ty>::value ? 1 : 0;
+		static inline std::complex<double> to(const _ty& x) { return std::complex<double>(static_cast<double>(x), 0.0); }
+		static inline _ty from(const std::complex<double>& z) { return static_cast<_ty>(z.real()); }
+	};
+	template <typename _cbty> struct fft_traits<std::complex<_cbty>>
+	{
+		static const int kind = fft_real<_cbty>::value ? 2 : 0;
+		static inline std::complex<double> to(const std::complex<_cbty>& x) { return std::complex<double>(static_cast<double>(x.real()), static_cast<double>(x.imag())); }
+		static inline std::complex<_cbty> from(const std::complex<double>& z) { return std::complex<_cbty>(static_cast<_cbty>(z.real()), static_cast<_cbty>(z.imag())); }
+	};
+#ifdef _FHP_TCOMPLEX_HPP_INCLUDED_
+	template <typename _cbty> struct fft_traits<Complex<_cbty>>
+	{
+		static const int kind = fft_real<_cbty>::value ? 2 : 0;
+		static inline std::complex<double> to(const Complex<_cbty>& x) { return std::complex<double>(static_cast<double>(x.real()), static_cast<double>(x.imag())); }
+		static inline Complex<_cbty> from(const std::complex<double>& z) { return Complex<_cbty>(static_cast<_cbty>(z.real()), static_cast<_cbty>(z.imag())); }
+	};
+#endif
+
+
+	/// kernels
+	/** res[0..na+nb-2] = a*b, O(na*nb) */
+	template <typename _ty> inline void schoolbook(const _ty* a, const std::size_t na, const _ty* b, const std::size_t nb, _ty* res)
+	{
+		for (std::size_t k = 0; k < na + nb - 1; ++k)
+			res[k] = _ty(0);
+		for (std::size_t i = 0; i < na; ++i)
+		{
+			const _ty ai = a[i];
+			_ty* r = res + i;
+			for (std::size_t j = 0; j < nb; ++j)
+				r[j] += ai * b[j];
+		}
+	}
+
+	/** number of scratch elements needed by karatsuba_square() for two factors of length n */
+	inline std::size_t karatsuba_scratch(const std::size_t n)
+	{
+		std::size_t res = 0;
+		for (std::size_t k = n; k >= karatsuba_threshold() && k > 1; k -= k / 2)
+			res += 4 * (k - k / 2);
+		return res;
+	}
+
+	/** res[0..2n-2] = a*b for two factors of equal length n, using scratch of karatsuba_scratch(n) elements */
+	template <typename _ty> inline void karatsuba_square(const _ty* a, const _ty* b, const std::size_t n, _ty* res, _ty* scratch)
+	{
+		if (n < karatsuba_threshold() || n < 2)
+		{
+			schoolbook(a, n, b, n, res);
+			return;
+		}
+		const std::size_t m = n / 2, h = n - m;
+		// z0 = a0*b0 and z2 = a1*b1 go straight into the result
+		karatsuba_square(a, b, m, res, scratch);
+		res[2 * m - 1] = _ty(0);
+		karatsuba_square(a + m, b + m, h, res + 2 * m, scratch);
+		// z1 = (a0+a1)*(b0+b1) - z0 - z2
+		_ty* sa = scratch;
+		_ty* sb = scratch + h;
+		_ty* z1 = scratch + 2 * h;
+		for (std::size_t i = 0; i < m; ++i)
+		{
+			sa[i] = a[i] + a[m + i];
+			sb[i] = b[i] + b[m + i];
+		}
+		if (h > m)
+		{
+			sa[m] = a[m + m];
+			sb[m] = b[m + m];
+		}
+		karatsuba_square(sa, sb, h, z1, scratch + 4 * h);
+		for (std::size_t i = 0; i < 2 * m - 1; ++i)
+			z1[i] -= res[i];
+		for (std::size_t i = 0; i < 2 * h - 1; ++i)
+			z1[i] -= res[2 * m + i];
+		for (std::size_t i = 0; i < 2 * h - 1; ++i)
+			res[m + i] += z1[i];
+	}
+
+	/** res[0..na+nb-2] = a*b with Karatsuba; the longer factor is cut into slices of the shorter one's length */
+	template <typename _ty> inline void karatsuba(const _ty* a, std::size_t na, const _ty* b, std::size_t nb, _ty* res)
+	{
+		if (na < nb)
+		{
+			std::swap(a, b);
+			std::swap(na, nb);
+		}
+		std::vector<_ty> buf(3 * nb + karatsuba_scratch(nb));
+		_ty* slice = buf.data();
+		_ty* prod = slice + nb;
+		_ty* scratch = prod + 2 * nb;
+		for (std::size_t k = 0; k < na + nb - 1; ++k)
+			res[k] = _ty(0);
+		for (std::size_t off = 0; off < na; off += nb)
+		{
+			const std::size_t len = (na - off < nb) ? (na - off) : (nb);
+			const _ty* src = a + off;
+			if (len < nb)
+			{
+				for (std::size_t i = 0; i < len; ++i)
+					slice[i] = a[off + i];
+				for (std::size_t i = len; i < nb; ++i)
+					slice[i] = _ty(0);
+				src = slice;
+			}
+			karatsuba_square(src, b, nb, prod, scratch);
+			for (std::size_t i = 0; i < len + nb - 1; ++i)
+				res[off + i] += prod[i];
+		}
+	}
+
+	/**
+	 * the twiddle factors e^(-2 pi i k/m), k = 0..m/2, for the longest transform m done so far on this thread; the
+	 * table serves every shorter power of two n with a stride of m/n, so it is only rebuilt when a transform is longer
+	 */
+	inline const std::complex<double>* fft_twiddles(const std::size_t n, std::size_t& stride)
+	{
+		static thread_local std::vector<std::complex<double>> w;
+		static thread_local std::size_t m = 0;
+		if (n > m)
+		{
+			const double pi = 3.14159265358979323846;
+			w.resize(n / 2 + 1);
+			for (std::size_t k = 0; k <= n / 2; ++k)
+			{
+				// direct evaluation instead of repeated multiplication keeps the twiddles accurate
+				const double phi = -2.0 * pi * double(k) / double(n);
+				w[k] = std::complex<double>(std::cos(phi), std::sin(phi));
+			}
+			m = n;
+		}
+		stride = m / n;
+		return w.data();
+	}
+
+	/** in-place iterative radix-2 FFT of length n (a power of two); inverse transforms are not normalized */
+	inline void fft(std::complex<double>* data, const std::size_t n, const bool inverse)
+	{
+		for (std::size_t i = 1, j = 0; i < n; ++i)
+		{
+			std::size_t bit = n >> 1;
+			for (; j & bit; bit >>= 1)
+				j ^= bit;
+			j ^= bit;
+			if (i < j)
+				std::swap(data[i], data[j]);
+		}
+		std::size_t stride;
+		const std::complex<double>* w = fft_twiddles(n, stride);
+		for (std::size_t len = 2; len <= n; len <<= 1)
+		{
+			const std::size_t half = len >> 1, step = stride * (n / len);
+			for (std::size_t i = 0; i < n; i += len)
+			{
+				for (std::size_t k = 0; k < half; ++k)
+				{
+					// the inverse transform uses the conjugate twiddles
+					const std::complex<double> t = (inverse) ? (std::conj(w[k * step])) : (w[k * step]);
+					const std::complex<double> u = data[i + k];
+					const std::complex<double> v = data[i + k + half] * t;
+					data[i + k] = u + v;
+					data[i + k + half] = u - v;
+				}
+			}
+		}
+	}
+
+	/** res[0..na+nb-2] = a*b via FFT; real factors are packed into one complex transform */
+	template <typename _ty> inline void fft_product(const _ty* a, const std::size_t na, const _ty* b, const std::size_t nb, _ty* res)
+	{
+		typedef fft_traits<_ty> tr;
+		const std::size_t nr = na + nb - 1;
+		std::size_t n = 1;
+		while (n < nr)
+			n <<= 1;
+		if (tr::kind == 1)
+		{
+			// c = a + ib  =>  c*c = a*a - b*b + 2i*a*b
+			std::vector<std::complex<double>> c(n);
+			for (std::size_t i = 0; i < na; ++i)
+				c[i] = tr::to(a[i]);
+			for (std::size_t i = 0; i < nb; ++i)
+				c[i] += std::complex<double>(0.0, tr::to(b[i]).real());
+			fft(c.data(), n, false);
+			for (std::size_t i = 0; i < n; ++i)
+				c[i] *= c[i];
+			fft(c.data(), n, true);
+			const double scale = 0.5 / double(n);
+			for (std::size_t i = 0; i < nr; ++i)
+				res[i] = tr::from(std::complex<double>(c[i].imag() * scale, 0.0));
+		}
+		else
+		{
+			std::vector<std::complex<double>> c(2 * n);
+			std::complex<double>* fa = c.data();
+			std::complex<double>* fb = fa + n;
+			for (std::size_t i = 0; i < na; ++i)
+				fa[i] = tr::to(a[i]);
+			for (std::size_t i = 0; i < nb; ++i)
+				fb[i] = tr::to(b[i]);
+			fft(fa, n, false);
+			fft(fb, n, false);
+			for (std::size_t i = 0; i < n; ++i)
+				fa[i] *= fb[i];
+			fft(fa, n, true);
+			const double scale = 1.0 / double(n);
+			for (std::size_t i = 0; i < nr; ++i)
+				res[i] = tr::from(fa[i] * scale);
+		}
+	}
+
+	template <typename _ty> inline void fft_dispatch(const _ty* a, const std::size_t na, const _ty* b, const std::size_t nb, _ty* res, const std::true_type&)
+	{
+		fft_product(a, na, b, nb, res);
+	}
+	template <typename _ty> inline void fft_dispatch(const _ty* a, const std::size_t na, const _ty* b, const std::size_t nb, _ty* res, const std::false_type&)
+	{
+		karatsuba(a, na, b, nb, res);
+	}
+
+
+	/** res[0..na+nb-2] = a*b, choosing schoolbook, Karatsuba or FFT by the length of the shorter factor */
+	template <typename _ty> inline void multiply(const _ty* a, const std::size_t na, const _ty* b, const std::size_t nb, _ty* res)
+	{
+		const std::size_t n = (na < nb) ? (na) : (nb);
+		if (n < karatsuba_threshold())
+			schoolbook(a, na, b, nb, res);
+		else if (n >= fft_threshold())
+			fft_dispatch(a, na, b, nb, res, std::integral_constant<bool, (fft_traits<_ty>::kind != 0)>());
+		else
+			karatsuba(a, na, b, nb, res);
+	}
+
+
+	/// division
+	/** length of the quotient, below which division is done by the schoolbook method instead of Newton inversion */
+	inline std::size_t& division_threshold() { static std::size_t t = 64; return t; }
+
+	/** g[0..k-1] = 1/h mod x^k by Newton's iteration g <- g*(2 - h*g), doubling the precision each step; h[0] must not vanish */
+	template <typename _ty> inline void inverse_series(const _ty* h, const std::size_t nh, const std::size_t k, _ty* g)
+	{
+		if (k == 0)
+			return;
+		g[0] = _ty(1) / h[0];
+		std::vector<_ty> e(2 * k), f(3 * k);
+		for (std::size_t len = 1; len < k;)
+		{
+			const std::size_t next = (2 * len < k) ? (2 * len) : (k);
+			// e = h*g mod x^next, which is 1 + O(x^len); f = g*(e - 1)
+			const std::size_t m = (nh < next) ? (nh) : (next);
+			multiply(h, m, g, len, e.data());
+			for (std::size_t i = m + len - 1; i < next; ++i)
+				e[i] = _ty(0);
+			multiply(e.data() + len, next - len, g, next - len, f.data());
+			for (std::size_t i = len; i < next; ++i)
+				g[i] = -f[i - len];
+			len = next;
+		}
+	}
+
+	/**
+	 * a = q*b + r for a of length na >= nb and b of length nb with b[nb-1] != 0: q gets na-nb+1 coefficients, r nb-1.
+	 * binv may hold 1/rev(b) mod x^kinv for some kinv >= na-nb+1 (rev(b) being b's coefficients in reverse order),
+	 * which is then used instead of computing it; r may be the same array as a (whose upper part is then overwritten).
+	 */
+	template <typename _ty> inline void divide(const _ty* a, const std::size_t na, const _ty* b, const std::size_t nb, _ty* q, _ty* r, const _ty* binv = nullptr)
+	{
+		const std::size_t k = na - nb + 1;
+		if (k <= division_threshold() || nb <= division_threshold() / 4)
+		{
+			// eliminates in r itself when it is a (a is then overwritten), otherwise in a copy
+			std::vector<_ty> copy;
+			_ty* t = r;
+			if (r != a)
+			{
+				copy.assign(a, a + na);
+				t = copy.data();
+			}
+			const _ty lead = _ty(1) / b[nb - 1];
+			for (std::size_t i = k; i-- > 0;)
+			{
+				const _ty f = t[i + nb - 1] * lead;
+				q[i] = f;
+				for (std::size_t j = 0; j + 1 < nb; ++j)
+					t[i + j] -= f * b[j];
+			}
+			if (t != r)
+				for (std::size_t j = 0; j + 1 < nb; ++j)
+					r[j] = t[j];
+			return;
+		}
+		// rev(q) = rev(a) * 1/rev(b) mod x^k
+		std::vector<_ty> buf(3 * k + ((binv == nullptr) ? (k) : (0)));
+		_ty* ra = buf.data();
+		_ty* prod = ra + k;
+		if (binv == nullptr)
+		{
+			_ty* inv = prod + 2 * k;
+			std::vector<_ty> rb(b, b + nb);
+			std::reverse(rb.begin(), rb.end());
+			inverse_series(rb.data(), nb, k, inv);
+			binv = inv;
+		}
+		for (std::size_t i = 0; i < k; ++i)
+			ra[i] = a[na - 1 - i];
+		multiply(ra, k, binv, k, prod);
+		for (std::size_t i = 0; i < k; ++i)
+			q[i] = prod[k - 1 - i];
+		// r = a - q*b, of which only the low nb-1 coefficients are needed
+		if (nb > 1)
+		{
+			const std::size_t lq = (k < nb - 1) ? (k) : (nb - 1);
+			std::vector<_ty> qb(lq + nb - 2);
+			multiply(q, lq, b, nb - 1, qb.data());
+			for (std::size_t j = 0; j + 1 < nb; ++j)
+				r[j] = a[j] - qb[j];
+		}
+	}
+
+
+	/// Taylor shift
+	/** length below which p(x+a) is computed by the quadratic scheme */
+	inline std::size_t& taylor_shift_threshold() { static std::size_t t = 64; return t; }
+
+	/** res[0..n-1] = coefficients of p(x+a) for p = c[0..n-1], by n-1 passes of synthetic division, O(n^2) */
+	template <typename _ty> inline void taylor_shift_classic(const _ty* c, const std::size_t n, const _ty a, _ty* res)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			res[i] = c[i];
+		for (std::size_t i = 0; i + 1 < n; ++i)
+			for (std::size_t j = n - 1; j-- > i;)
+				res[j] += a * res[j + 1];
+	}
+
+	/**
+	 * res[0..n-1] = coefficients of p(x+a) for p = c[0..n-1] (res must not overlap c). Long polynomials are split,
+	 * p = lo + x^m*hi, and p(x+a) = lo(x+a) + (x+a)^m*hi(x+a) with (x+a)^m from the binomial theorem, so the cost is
+	 * O(M(n) log n) for a multiplication cost M(n). Binomial coefficients of high degree may overflow a double, and the
+	 * rounding errors of the fast products are not bounded coefficient by coefficient: where the error of every
+	 * coefficient has to stay within the same computation on absolute values, use taylor_shift_classic().
+	 */
+	template <typename _ty> inline void taylor_shift(const _ty* c, const std::size_t n, const _ty a, _ty* res)
+	{
+		if (n <= taylor_shift_threshold() || n < 4)
+		{
+			taylor_shift_classic(c, n, a, res);
+			return;
+		}
+		const std::size_t m = n / 2;
+		std::vector<_ty> buf((n - m) + (m + 1) + n);
+		_ty* hi = buf.data();
+		_ty* pw = hi + (n - m);
+		_ty* prod = pw + (m + 1);
+		taylor_shift(c, m, a, res);
+		taylor_shift(c + m, n - m, a, hi);
+		// pw[k] = binomial(m, k) * a^(m-k), from the top down
+		pw[m] = _ty(1);
+		for (std::size_t k = m; k > 0; --k)
+			pw[k - 1] = pw[k] * a * _ty(double(k)) / _ty(double(m - k + 1));
+		multiply(hi, n - m, pw, m + 1, prod);
+		for (std::size_t i = 0; i < m; ++i)
+			res[i] += prod[i];
+		for (std::size_t i = m; i < n; ++i)
+			res[i] = prod[i];
+	}
+
+}
+
+#endif
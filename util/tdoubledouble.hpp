@@ -0,0 +1,839 @@
+#ifndef _FHP_TDOUBLEDOUBLE_HPP_INCLUDED_
+#define _FHP_TDOUBLEDOUBLE_HPP_INCLUDED_
+
+#if defined(__GNUC__) || defined(__clang__)
+#  include <iostream>
+#  include <string>
+#  define _STD_OSTREAM_INCLUDED_ 1
+#  define _STD_STRING_INCLUDED_ 1
+#endif
+#ifdef _STD_STRING_INCLUDED_
+#  include <sstream>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <limits>
+#include <type_traits>
+#include "teft.hpp"
+
+
+/**
+ * Unevaluated sum of N doubles c[0] + c[1] + ... with |c[i+1]| <= ulp(c[i])/2, so the precision is about N times
+ * that of double at the exponent range of double. N = 2 (DoubleDouble, 31 digits) and N = 4 (QuadDouble, 62 digits)
+ * are the useful sizes. The operations collect the partial results by order of magnitude: terms of the orders that
+ * the result keeps are added with two_sum and multiplied with two_prod, so only the last order is rounded.
+ * Works as the coefficient type of Polynomial and as the component type of Complex, Vector and Dual; the elementary
+ * functions below are found by argument-dependent lookup, the way the library calls them.
+ */
+template <unsigned int N> class MultiDouble
+{
+	static_assert(N >= 1 && N <= 8, "MultiDouble needs between one and eight components");
+
+protected:
+	double c[N];
+
+public:
+	enum { parts = N };
+
+	/// constructor
+	/** zero */
+	inline MultiDouble()
+	{
+		for (unsigned int i = 0; i < N; ++i)
+			c[i] = 0.0;
+	}
+	inline MultiDouble(const double x)
+	{
+		c[0] = x;
+		for (unsigned int i = 1; i < N; ++i)
+			c[i] = 0.0;
+	}
+	/** the exact sum hi + lo */
+	inline MultiDouble(const double hi, const double lo) : MultiDouble()
+	{
+		c[0] = eft::two_sum(hi, lo, c[(N > 1) ? (1) : (0)]);
+	}
+	/** a long double, split so that an extended significand is kept */
+	inline MultiDouble(const long double x) : MultiDouble(static_cast<double>(x), static_cast<double>(x - static_cast<long double>(static_cast<double>(x)))) {}
+	/** other arithmetic types, so that _ty(0) and expressions like 2 * x keep working */
+	template <typename aux, typename = typename std::enable_if<std::is_arithmetic<aux>::value>::type> inline MultiDouble(const aux x) : MultiDouble(static_cast<double>(x)) {}
+
+	/// direct access
+	inline double operator[](const unsigned int i) const { return c[i]; }
+	inline const double* data() const { return c; }
+	inline double* data() { return c; }
+	inline double to_double() const { return c[0]; }
+	inline explicit operator double() const { return c[0]; }
+	inline long double to_long_double() const
+	{
+		long double res = 0.0L;
+		for (unsigned int i = N; i-- > 0;)
+			res += c[i];
+		return res;
+	}
+
+	/// constants
+	static inline MultiDouble<N> pi()
+	{
+		static const double p[] = { 3.141592653589793, 1.2246467991473532e-16, -2.9947698097183397e-33, 1.1124542208633653e-49 };
+		return from_table(p);
+	}
+	static inline MultiDouble<N> ln2()
+	{
+		static const double p[] = { 0.6931471805599453, 2.3190468138462996e-17, 5.707708438416212e-34, -3.5824322106018114e-50 };
+		return from_table(p);
+	}
+	/** 2^(-52 N), the spacing of the values near 1 */
+	static inline MultiDouble<N> epsilon()
+	{
+		return MultiDouble<N>(std::ldexp(1.0, -52 * int(N)));
+	}
+
+	/// assignment operators
+	inline MultiDouble<N>& operator+=(const MultiDouble<N>& other);
+	inline MultiDouble<N>& operator-=(const MultiDouble<N>& other);
+	inline MultiDouble<N>& operator*=(const MultiDouble<N>& other);
+	inline MultiDouble<N>& operator/=(const MultiDouble<N>& other);
+	inline MultiDouble<N>& operator+=(const double x);
+	inline MultiDouble<N>& operator-=(const double x);
+	inline MultiDouble<N>& operator*=(const double x);
+	inline MultiDouble<N>& operator/=(const double x);
+
+	inline MultiDouble<N> operator-() const
+	{
+		MultiDouble<N> res;
+		for (unsigned int i = 0; i < N; ++i)
+			res.c[i] = -c[i];
+		return res;
+	}
+	inline MultiDouble<N> operator+() const
+	{
+		return *this;
+	}
+
+#ifdef _STD_STRING_INCLUDED_
+	/** decimal representation with the given number of significant digits, in the style of %g */
+	inline std::string to_string(int digits = std::numeric_limits<MultiDouble<N>>::digits10) const;
+#endif
+
+private:
+	static inline MultiDouble<N> from_table(const double* p)
+	{
+		MultiDouble<N> res;
+		for (unsigned int i = 0; i < N && i < 4; ++i)
+			res.c[i] = p[i];
+		return res;
+	}
+};
+
+typedef MultiDouble<2> DoubleDouble;
+typedef MultiDouble<4> QuadDouble;
+
+
+namespace std
+{
+
+	template <unsigned int N> class numeric_limits<MultiDouble<N>>
+	{
+	public:
+		static constexpr bool is_specialized = true;
+		static constexpr bool is_signed = true;
+		static constexpr bool is_integer = false;
+		static constexpr bool is_exact = false;
+		static constexpr bool has_infinity = true;
+		static constexpr bool has_quiet_NaN = true;
+		static constexpr int radix = 2;
+		static constexpr int digits = 52 * int(N) + 1;
+		static constexpr int digits10 = int((digits - 1) * 0.30102999566398120);
+		static constexpr int max_digits10 = digits10 + 2;
+		static constexpr int min_exponent = DBL_MIN_EXP + 53 * (int(N) - 1);
+		static constexpr int max_exponent = DBL_MAX_EXP;
+		/** the smallest value whose components are all normal */
+		static inline MultiDouble<N> min() { return MultiDouble<N>(std::ldexp(1.0, min_exponent - 1)); }
+		static inline MultiDouble<N> max() { return MultiDouble<N>(DBL_MAX); }
+		static inline MultiDouble<N> lowest() { return MultiDouble<N>(-DBL_MAX); }
+		static inline MultiDouble<N> epsilon() { return MultiDouble<N>::epsilon(); }
+		static inline MultiDouble<N> round_error() { return MultiDouble<N>(0.5); }
+		static inline MultiDouble<N> infinity() { return MultiDouble<N>(std::numeric_limits<double>::infinity()); }
+		static inline MultiDouble<N> quiet_NaN() { return MultiDouble<N>(std::numeric_limits<double>::quiet_NaN()); }
+		static inline MultiDouble<N> denorm_min() { return min(); }
+	};
+
+}
+
+
+namespace multidouble
+{
+
+	/**
+	 * r = a + b for a with na and b with nb components (nb = 1 adds a double). The terms are summed order by order
+	 * with two_sum, each order passing its errors on to the next; only the errors below the last kept order are
+	 * added with rounding. r may alias a or b.
+	 */
+	template <unsigned int N, unsigned int na, unsigned int nb> inline void add(const double* a, const double* b, double* r)
+	{
+		// the errors of order k are t[first, last); those of order k + 1 are appended behind them
+		double s[N + 1], t[(N + 1) * (N + 2) / 2];
+		unsigned int first = 0, last = 0;
+		for (unsigned int k = 0; k < N; ++k)
+		{
+			unsigned int end = last;
+			double sum = (k < na) ? (a[k]) : (0.0);
+			if (k < nb)
+				sum = eft::two_sum(sum, b[k], t[end++]);
+			for (unsigned int i = first; i < last; ++i)
+				sum = eft::two_sum(sum, t[i], t[end++]);
+			s[k] = sum;
+			first = last;
+			last = end;
+		}
+		s[N] = 0.0;
+		for (unsigned int i = first; i < last; ++i)
+			s[N] += t[i];
+		eft::renormalize<N + 1, N>(s, r);
+	}
+
+	/**
+	 * r = a * b for a with na and b with nb components. The products of order k = i + j below N - 1 are split with
+	 * two_prod and summed with two_sum; the last kept order is summed with rounding and the higher ones are dropped,
+	 * which costs a relative error of a few units of epsilon. r may alias a or b.
+	 */
+	template <unsigned int N, unsigned int na, unsigned int nb> inline void mul(const double* a, const double* b, double* r)
+	{
+		double s[N], t[2 * N * N * N];
+		unsigned int first = 0, last = 0;
+		for (unsigned int k = 0; k < N; ++k)
+		{
+			const bool exact = (k + 1 < N);
+			unsigned int end = last, terms = 0;
+			double sum = 0.0;
+			for (unsigned int i = 0; i <= k; ++i)
+			{
+				const unsigned int j = k - i;
+				if (i >= na || j >= nb)
+					continue;
+				const double p = (exact) ? (eft::two_prod(a[i], b[j], t[end++])) : (a[i] * b[j]);
+				if (terms++ == 0)
+					sum = p;
+				else
+					sum = (exact) ? (eft::two_sum(sum, p, t[end++])) : (sum + p);
+			}
+			for (unsigned int i = first; i < last; ++i)
+				sum = (exact) ? (eft::two_sum(sum, t[i], t[end++])) : (sum + t[i]);
+			s[k] = sum;
+			first = last;
+			last = end;
+		}
+		eft::renormalize<N, N>(s, r);
+	}
+
+	/// the double-double cases written out, as in the classic algorithms
+	template <> inline void add<2, 2, 2>(const double* a, const double* b, double* r)
+	{
+		double e, f;
+		const double s = eft::two_sum(a[0], b[0], e);
+		const double t = eft::two_sum(a[1], b[1], f);
+		if (!std::isfinite(s))
+		{
+			r[0] = s;
+			r[1] = 0.0;
+			return;
+		}
+		e += t;
+		const double u = eft::quick_two_sum(s, e, e);
+		e += f;
+		r[0] = eft::quick_two_sum(u, e, r[1]);
+	}
+	template <> inline void add<2, 2, 1>(const double* a, const double* b, double* r)
+	{
+		double e;
+		const double s = eft::two_sum(a[0], b[0], e);
+		if (!std::isfinite(s))
+		{
+			r[0] = s;
+			r[1] = 0.0;
+			return;
+		}
+		e += a[1];
+		r[0] = eft::quick_two_sum(s, e, r[1]);
+	}
+	template <> inline void mul<2, 2, 2>(const double* a, const double* b, double* r)
+	{
+		double e;
+		const double p = eft::two_prod(a[0], b[0], e);
+		if (!std::isfinite(p))
+		{
+			r[0] = p;
+			r[1] = 0.0;
+			return;
+		}
+		e += a[0] * b[1] + a[1] * b[0];
+		r[0] = eft::quick_two_sum(p, e, r[1]);
+	}
+	template <> inline void mul<2, 2, 1>(const double* a, const double* b, double* r)
+	{
+		double e;
+		const double p = eft::two_prod(a[0], b[0], e);
+		if (!std::isfinite(p))
+		{
+			r[0] = p;
+			r[1] = 0.0;
+			return;
+		}
+		e += a[1] * b[0];
+		r[0] = eft::quick_two_sum(p, e, r[1]);
+	}
+
+	/// the quad-double cases written out, with the sums of each order taken pairwise to shorten the dependency chains
+	template <> inline void add<4, 4, 4>(const double* a, const double* b, double* r)
+	{
+		double s[5], e0, e1, e2, e3, f1, x, y, z, u, v;
+		s[0] = eft::two_sum(a[0], b[0], e0);
+		s[1] = eft::two_sum(a[1], b[1], e1);
+		s[2] = eft::two_sum(a[2], b[2], e2);
+		s[3] = eft::two_sum(a[3], b[3], e3);
+		s[1] = eft::two_sum(s[1], e0, f1);
+		const double t2 = eft::two_sum(e1, f1, x);
+		s[2] = eft::two_sum(s[2], t2, y);
+		const double t3 = eft::two_sum(e2, x, z);
+		s[3] = eft::two_sum(s[3], t3, u);
+		s[3] = eft::two_sum(s[3], y, v);
+		s[4] = (e3 + z) + (u + v);
+		eft::renormalize<5, 4>(s, r);
+	}
+	template <> inline void add<4, 4, 1>(const double* a, const double* b, double* r)
+	{
+		double s[5], e;
+		s[0] = eft::two_sum(a[0], b[0], e);
+		s[1] = eft::two_sum(a[1], e, e);
+		s[2] = eft::two_sum(a[2], e, e);
+		s[3] = eft::two_sum(a[3], e, s[4]);
+		eft::renormalize<5, 4>(s, r);
+	}
+	template <> inline void mul<4, 4, 4>(const double* a, const double* b, double* r)
+	{
+		double s[4], q00, q01, q10, q02, q11, q20, x1, y1, ea, eb, ec, ed, ee, ef;
+		s[0] = eft::two_prod(a[0], b[0], q00);
+		const double p01 = eft::two_prod(a[0], b[1], q01), p10 = eft::two_prod(a[1], b[0], q10);
+		const double p02 = eft::two_prod(a[0], b[2], q02), p11 = eft::two_prod(a[1], b[1], q11), p20 = eft::two_prod(a[2], b[0], q20);
+		s[1] = eft::two_sum(p01, p10, x1);
+		s[1] = eft::two_sum(s[1], q00, y1);
+		const double sa = eft::two_sum(p02, p11, ea), sb = eft::two_sum(p20, q01, eb), sc = eft::two_sum(q10, x1, ec);
+		const double sd = eft::two_sum(sa, sb, ed), se = eft::two_sum(sc, y1, ee);
+		s[2] = eft::two_sum(sd, se, ef);
+		s[3] = ((a[0] * b[3] + a[1] * b[2]) + (a[2] * b[1] + a[3] * b[0])) + ((q02 + q11) + (q20 + ea)) + ((eb + ec) + (ed + ee + ef));
+		eft::renormalize<4, 4>(s, r);
+	}
+	template <> inline void mul<4, 4, 1>(const double* a, const double* b, double* r)
+	{
+		double s[4], q0, q1, q2, x1, y, z;
+		s[0] = eft::two_prod(a[0], b[0], q0);
+		const double p1 = eft::two_prod(a[1], b[0], q1), p2 = eft::two_prod(a[2], b[0], q2);
+		s[1] = eft::two_sum(p1, q0, x1);
+		s[2] = eft::two_sum(p2, q1, y);
+		s[2] = eft::two_sum(s[2], x1, z);
+		s[3] = a[3] * b[0] + (q2 + (y + z));
+		eft::renormalize<4, 4>(s, r);
+	}
+
+	/** r = a / b by long division: N + 1 quotient digits, each taken from the leading components of the remainder */
+	template <unsigned int N, unsigned int nb> inline void div(const double* a, const double* b, double* r)
+	{
+		double q[N + 1], rem[N], p[N];
+		for (unsigned int i = 0; i < N; ++i)
+			rem[i] = a[i];
+		for (unsigned int k = 0; k <= N; ++k)
+		{
+			q[k] = rem[0] / b[0];
+			if (k == N)
+				break;
+			mul<N, nb, 1>(b, q + k, p);
+			for (unsigned int i = 0; i < N; ++i)
+				p[i] = -p[i];
+			add<N, N, N>(rem, p, rem);
+		}
+		if (!std::isfinite(q[0]))
+		{
+			r[0] = a[0] / b[0];
+			for (unsigned int i = 1; i < N; ++i)
+				r[i] = 0.0;
+			return;
+		}
+		eft::renormalize<N + 1, N>(q, r);
+	}
+
+	/** -1, 0 or 1 as a compares to b, lexicographically by components (NaNs compare as unordered, i.e. 2) */
+	template <unsigned int N> inline int compare(const double* a, const double* b)
+	{
+		for (unsigned int i = 0; i < N; ++i)
+		{
+			if (a[i] < b[i])
+				return -1;
+			if (a[i] > b[i])
+				return 1;
+			if (a[i] != b[i])
+				return 2;
+		}
+		return 0;
+	}
+
+	/** number of Newton steps from a double start to full precision, each doubling the correct digits */
+	template <unsigned int N> inline unsigned int newton_steps()
+	{
+		unsigned int steps = 0;
+		for (unsigned int k = 1; k < N; k *= 2)
+			++steps;
+		return steps;
+	}
+
+}
+
+
+/// assignment operators
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator+=(const MultiDouble<N>& other)
+{
+	multidouble::add<N, N, N>(c, other.c, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator-=(const MultiDouble<N>& other)
+{
+	const MultiDouble<N> neg = -other;
+	multidouble::add<N, N, N>(c, neg.c, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator*=(const MultiDouble<N>& other)
+{
+	multidouble::mul<N, N, N>(c, other.c, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator/=(const MultiDouble<N>& other)
+{
+	multidouble::div<N, N>(c, other.c, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator+=(const double x)
+{
+	multidouble::add<N, N, 1>(c, &x, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator-=(const double x)
+{
+	const double neg = -x;
+	multidouble::add<N, N, 1>(c, &neg, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator*=(const double x)
+{
+	multidouble::mul<N, N, 1>(c, &x, c);
+	return *this;
+}
+template <unsigned int N> inline MultiDouble<N>& MultiDouble<N>::operator/=(const double x)
+{
+	multidouble::div<N, 1>(c, &x, c);
+	return *this;
+}
+
+/// arithmetic operators
+template <unsigned int N> inline MultiDouble<N> operator+(MultiDouble<N> a, const MultiDouble<N>& b) { return a += b; }
+template <unsigned int N> inline MultiDouble<N> operator-(MultiDouble<N> a, const MultiDouble<N>& b) { return a -= b; }
+template <unsigned int N> inline MultiDouble<N> operator*(MultiDouble<N> a, const MultiDouble<N>& b) { return a *= b; }
+template <unsigned int N> inline MultiDouble<N> operator/(MultiDouble<N> a, const MultiDouble<N>& b) { return a /= b; }
+template <unsigned int N> inline MultiDouble<N> operator+(MultiDouble<N> a, const double b) { return a += b; }
+template <unsigned int N> inline MultiDouble<N> operator-(MultiDouble<N> a, const double b) { return a -= b; }
+template <unsigned int N> inline MultiDouble<N> operator*(MultiDouble<N> a, const double b) { return a *= b; }
+template <unsigned int N> inline MultiDouble<N> operator/(MultiDouble<N> a, const double b) { return a /= b; }
+template <unsigned int N> inline MultiDouble<N> operator+(const double a, MultiDouble<N> b) { return b += a; }
+template <unsigned int N> inline MultiDouble<N> operator-(const double a, const MultiDouble<N>& b) { return (-b) += a; }
+template <unsigned int N> inline MultiDouble<N> operator*(const double a, MultiDouble<N> b) { return b *= a; }
+template <unsigned int N> inline MultiDouble<N> operator/(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) /= b; }
+
+/// comparison operators
+template <unsigned int N> inline bool operator==(const MultiDouble<N>& a, const MultiDouble<N>& b) { return multidouble::compare<N>(a.data(), b.data()) == 0; }
+template <unsigned int N> inline bool operator!=(const MultiDouble<N>& a, const MultiDouble<N>& b) { return multidouble::compare<N>(a.data(), b.data()) != 0; }
+template <unsigned int N> inline bool operator<(const MultiDouble<N>& a, const MultiDouble<N>& b) { return multidouble::compare<N>(a.data(), b.data()) == -1; }
+template <unsigned int N> inline bool operator>(const MultiDouble<N>& a, const MultiDouble<N>& b) { return multidouble::compare<N>(a.data(), b.data()) == 1; }
+template <unsigned int N> inline bool operator<=(const MultiDouble<N>& a, const MultiDouble<N>& b) { const int t = multidouble::compare<N>(a.data(), b.data()); return t == -1 || t == 0; }
+template <unsigned int N> inline bool operator>=(const MultiDouble<N>& a, const MultiDouble<N>& b) { const int t = multidouble::compare<N>(a.data(), b.data()); return t == 1 || t == 0; }
+template <unsigned int N> inline bool operator==(const MultiDouble<N>& a, const double b) { return a == MultiDouble<N>(b); }
+template <unsigned int N> inline bool operator!=(const MultiDouble<N>& a, const double b) { return a != MultiDouble<N>(b); }
+template <unsigned int N> inline bool operator<(const MultiDouble<N>& a, const double b) { return a < MultiDouble<N>(b); }
+template <unsigned int N> inline bool operator>(const MultiDouble<N>& a, const double b) { return a > MultiDouble<N>(b); }
+template <unsigned int N> inline bool operator<=(const MultiDouble<N>& a, const double b) { return a <= MultiDouble<N>(b); }
+template <unsigned int N> inline bool operator>=(const MultiDouble<N>& a, const double b) { return a >= MultiDouble<N>(b); }
+template <unsigned int N> inline bool operator==(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) == b; }
+template <unsigned int N> inline bool operator!=(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) != b; }
+template <unsigned int N> inline bool operator<(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) < b; }
+template <unsigned int N> inline bool operator>(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) > b; }
+template <unsigned int N> inline bool operator<=(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) <= b; }
+template <unsigned int N> inline bool operator>=(const double a, const MultiDouble<N>& b) { return MultiDouble<N>(a) >= b; }
+
+/// elementary functions
+template <unsigned int N> inline bool isnan(const MultiDouble<N>& a) { return std::isnan(a[0]); }
+template <unsigned int N> inline bool isinf(const MultiDouble<N>& a) { return std::isinf(a[0]); }
+template <unsigned int N> inline bool isfinite(const MultiDouble<N>& a) { return std::isfinite(a[0]); }
+template <unsigned int N> inline MultiDouble<N> abs(const MultiDouble<N>& a) { return (a[0] < 0.0) ? (-a) : (a); }
+template <unsigned int N> inline MultiDouble<N> fabs(const MultiDouble<N>& a) { return abs(a); }
+/** a * 2^e, exact unless a component under- or overflows */
+template <unsigned int N> inline MultiDouble<N> ldexp(const MultiDouble<N>& a, const int e)
+{
+	MultiDouble<N> res;
+	for (unsigned int i = 0; i < N; ++i)
+		res.data()[i] = std::ldexp(a[i], e);
+	return res;
+}
+template <unsigned int N> inline MultiDouble<N> floor(const MultiDouble<N>& a)
+{
+	double f[N];
+	unsigned int i = 0;
+	for (; i < N; ++i)
+	{
+		f[i] = std::floor(a[i]);
+		if (f[i] != a[i])
+			break;
+	}
+	for (++i; i < N; ++i)
+		f[i] = 0.0;
+	MultiDouble<N> res;
+	eft::renormalize<N, N>(f, res.data());
+	return res;
+}
+template <unsigned int N> inline MultiDouble<N> ceil(const MultiDouble<N>& a)
+{
+	return -floor(-a);
+}
+
+/**
+ * corrections y <- y + (a - y^2) / (2 y0) from the double square root y0: no division, and each step gains the 53
+ * bits to which 1 / (2 y0) is known
+ */
+template <unsigned int N> inline MultiDouble<N> sqrt(const MultiDouble<N>& a)
+{
+	if (!(a[0] > 0.0))
+		return (a[0] == 0.0) ? (a) : (MultiDouble<N>(std::numeric_limits<double>::quiet_NaN()));
+	if (std::isinf(a[0]))
+		return a;
+	MultiDouble<N> y(std::sqrt(a[0]));
+	const double h = 0.5 / y[0];
+	for (unsigned int i = 1; i < N; ++i)
+		y += (a - y * y) * h;
+	return y;
+}
+
+/** sqrt(a^2 + b^2), scaled by a power of two against over- and underflow */
+template <unsigned int N> inline MultiDouble<N> hypot(const MultiDouble<N>& a, const MultiDouble<N>& b)
+{
+	const double m = std::max(std::abs(a[0]), std::abs(b[0]));
+	if (m == 0.0 || !std::isfinite(m))
+		return MultiDouble<N>(m);
+	const int e = std::ilogb(m);
+	const MultiDouble<N> x = ldexp(a, -e), y = ldexp(b, -e);
+	return ldexp(sqrt(x * x + y * y), e);
+}
+
+namespace multidouble
+{
+
+	/** 1/k! for k < 64, the coefficients of the Taylor series below, computed once per precision */
+	template <unsigned int N> inline const MultiDouble<N>* inverse_factorials()
+	{
+		static const struct table
+		{
+			MultiDouble<N> f[64];
+			table()
+			{
+				f[0] = MultiDouble<N>(1.0);
+				for (unsigned int k = 1; k < 64; ++k)
+					f[k] = f[k - 1] / double(k);
+			}
+		} t;
+		return t.f;
+	}
+
+}
+
+/**
+ * e^a = 2^k e^r with r = a - k ln 2; e^r - 1 is summed as a Taylor series at r / 2^10 and brought back by ten steps
+ * of s <- 2s + s^2, which keeps the series short and avoids cancellation near zero
+ */
+template <unsigned int N> inline MultiDouble<N> exp(const MultiDouble<N>& a)
+{
+	const int squarings = 10;
+	if (a[0] > 709.79)
+		return MultiDouble<N>(std::numeric_limits<double>::infinity());
+	if (a[0] < -745.2)
+		return MultiDouble<N>(0.0);
+	if (std::isnan(a[0]))
+		return a;
+	const double k = std::floor(a[0] / MultiDouble<N>::ln2()[0] + 0.5);
+	const MultiDouble<N> r = ldexp(a - MultiDouble<N>::ln2() * k, -squarings);
+	const double eps = MultiDouble<N>::epsilon()[0] / 1024.0;
+	const MultiDouble<N>* f = multidouble::inverse_factorials<N>();
+	MultiDouble<N> s = r, power = r, term = r;
+	for (unsigned int i = 2; i < 64 && std::abs(term[0]) > eps * std::abs(s[0]); ++i)
+	{
+		power *= r;
+		term = power * f[i];
+		s += term;
+	}
+	for (int i = 0; i < squarings; ++i)
+		s = ldexp(s, 1) + s * s;
+	return ldexp(s + 1.0, int(k));
+}
+
+/** Newton's iteration x <- x + a e^-x - 1 from the double logarithm */
+template <unsigned int N> inline MultiDouble<N> log(const MultiDouble<N>& a)
+{
+	if (!(a[0] > 0.0))
+		return MultiDouble<N>((a[0] == 0.0) ? (-std::numeric_limits<double>::infinity()) : (std::numeric_limits<double>::quiet_NaN()));
+	if (std::isinf(a[0]))
+		return a;
+	MultiDouble<N> x(std::log(a[0]));
+	for (unsigned int i = multidouble::newton_steps<N>(); i > 0; --i)
+		x = x + a * exp(-x) - 1.0;
+	return x;
+}
+
+namespace multidouble
+{
+
+	/** Taylor series of sin t and cos t for |t| <= pi/4 */
+	template <unsigned int N> inline void sincos_taylor(const MultiDouble<N>& t, MultiDouble<N>& s, MultiDouble<N>& c)
+	{
+		const double eps = MultiDouble<N>::epsilon()[0] * 0.5;
+		const MultiDouble<N>* f = inverse_factorials<N>();
+		const MultiDouble<N> t2 = -(t * t);
+		s = t;
+		c = MultiDouble<N>(1.0);
+		MultiDouble<N> power(1.0), ts = t, tc(1.0);
+		for (unsigned int i = 1; 2 * i + 1 < 64 && (std::abs(tc[0]) > eps || std::abs(ts[0]) > eps * std::abs(t[0])); ++i)
+		{
+			// (-1)^i t^(2i)
+			power *= t2;
+			tc = power * f[2 * i];
+			ts = t * (power * f[2 * i + 1]);
+			c += tc;
+			s += ts;
+		}
+	}
+
+	/** sin a and cos a: reduction modulo 2 pi, then to the quadrant around the nearest multiple of pi/2 */
+	template <unsigned int N> inline void sincos(const MultiDouble<N>& a, MultiDouble<N>& s, MultiDouble<N>& c)
+	{
+		if (!std::isfinite(a[0]))
+		{
+			s = c = MultiDouble<N>(std::numeric_limits<double>::quiet_NaN());
+			return;
+		}
+		const MultiDouble<N> two_pi = ldexp(MultiDouble<N>::pi(), 1), half_pi = ldexp(MultiDouble<N>::pi(), -1);
+		const MultiDouble<N> r = a - two_pi * floor(a / two_pi + 0.5);
+		const int j = int(std::floor(r[0] / half_pi[0] + 0.5));
+		MultiDouble<N> ts, tc;
+		sincos_taylor(r - half_pi * double(j), ts, tc);
+		switch (j)
+		{
+		case 0: s = ts; c = tc; break;
+		case 1: s = tc; c = -ts; break;
+		case -1: s = -tc; c = ts; break;
+		default: s = -ts; c = -tc; break;
+		}
+	}
+
+}
+
+template <unsigned int N> inline MultiDouble<N> sin(const MultiDouble<N>& a)
+{
+	MultiDouble<N> s, c;
+	multidouble::sincos(a, s, c);
+	return s;
+}
+template <unsigned int N> inline MultiDouble<N> cos(const MultiDouble<N>& a)
+{
+	MultiDouble<N> s, c;
+	multidouble::sincos(a, s, c);
+	return c;
+}
+template <unsigned int N> inline MultiDouble<N> tan(const MultiDouble<N>& a)
+{
+	MultiDouble<N> s, c;
+	multidouble::sincos(a, s, c);
+	return s / c;
+}
+
+/** Newton's iteration on the angle whose sine and cosine match the normalized (x, y), from the double atan2 */
+template <unsigned int N> inline MultiDouble<N> atan2(const MultiDouble<N>& y, const MultiDouble<N>& x)
+{
+	if (x[0] == 0.0 || y[0] == 0.0 || !std::isfinite(x[0]) || !std::isfinite(y[0]))
+	{
+		if (x[0] == 0.0 && y[0] != 0.0 && std::isfinite(y[0]))
+			return (y[0] > 0.0) ? (ldexp(MultiDouble<N>::pi(), -1)) : (-ldexp(MultiDouble<N>::pi(), -1));
+		if (y[0] == 0.0 && x[0] < 0.0)
+			return std::signbit(y[0]) ? (-MultiDouble<N>::pi()) : (MultiDouble<N>::pi());
+		return MultiDouble<N>(std::atan2(y[0], x[0]));
+	}
+	const MultiDouble<N> r = hypot(x, y), xx = x / r, yy = y / r;
+	MultiDouble<N> z(std::atan2(y[0], x[0])), s, c;
+	for (unsigned int i = multidouble::newton_steps<N>(); i > 0; --i)
+	{
+		multidouble::sincos(z, s, c);
+		if (std::abs(xx[0]) > std::abs(yy[0]))
+			z += (yy - s) / c;
+		else
+			z -= (xx - c) / s;
+	}
+	return z;
+}
+template <unsigned int N> inline MultiDouble<N> atan(const MultiDouble<N>& a)
+{
+	return atan2(a, MultiDouble<N>(1.0));
+}
+
+/** sinh by its Taylor series for |a| < 1/2, where e^a - e^-a would cancel */
+template <unsigned int N> inline MultiDouble<N> sinh(const MultiDouble<N>& a)
+{
+	if (std::abs(a[0]) < 0.5)
+	{
+		const double eps = MultiDouble<N>::epsilon()[0] * 0.5;
+		const MultiDouble<N> a2 = a * a;
+		const MultiDouble<N>* f = multidouble::inverse_factorials<N>();
+		MultiDouble<N> s = a, power = a, term = a;
+		for (unsigned int i = 1; 2 * i + 1 < 64 && std::abs(term[0]) > eps * std::abs(s[0]); ++i)
+		{
+			power *= a2;
+			term = power * f[2 * i + 1];
+			s += term;
+		}
+		return s;
+	}
+	const MultiDouble<N> e = exp(a);
+	return ldexp(e - 1.0 / e, -1);
+}
+template <unsigned int N> inline MultiDouble<N> cosh(const MultiDouble<N>& a)
+{
+	const MultiDouble<N> e = exp(abs(a));
+	return ldexp(e + 1.0 / e, -1);
+}
+template <unsigned int N> inline MultiDouble<N> tanh(const MultiDouble<N>& a)
+{
+	// beyond this e^-2|a| is below epsilon
+	if (std::abs(a[0]) > 37.0 * double(N))
+		return MultiDouble<N>((a[0] > 0.0) ? (1.0) : (-1.0));
+	return sinh(a) / cosh(a);
+}
+
+/** a^n by repeated squaring */
+template <unsigned int N> inline MultiDouble<N> pow(const MultiDouble<N>& a, const int n)
+{
+	MultiDouble<N> res(1.0), base = a;
+	for (unsigned int m = (n < 0) ? (0u - unsigned(n)) : (unsigned(n)); m > 0; m >>= 1)
+	{
+		if (m & 1u)
+			res *= base;
+		if (m > 1u)
+			base *= base;
+	}
+	return (n < 0) ? (1.0 / res) : (res);
+}
+/** a^b, by repeated squaring for integral b and as e^(b log a) otherwise (a > 0) */
+template <unsigned int N> inline MultiDouble<N> pow(const MultiDouble<N>& a, const MultiDouble<N>& b)
+{
+	if (floor(b) == b && std::abs(b[0]) < 2147483648.0)
+		return pow(a, int(b[0]));
+	return exp(b * log(a));
+}
+template <unsigned int N> inline MultiDouble<N> pow(const MultiDouble<N>& a, const double b)
+{
+	return pow(a, MultiDouble<N>(b));
+}
+
+#ifdef _STD_STRING_INCLUDED_
+template <unsigned int N> inline std::string MultiDouble<N>::to_string(int digits) const
+{
+	if (std::isnan(c[0]))
+		return "nan";
+	if (std::isinf(c[0]))
+		return (c[0] < 0.0) ? ("-inf") : ("inf");
+	std::string res = (c[0] < 0.0 || (c[0] == 0.0 && std::signbit(c[0]))) ? ("-") : ("");
+	if (c[0] == 0.0)
+		return res + "0";
+	digits = std::max(1, std::min(digits, std::numeric_limits<MultiDouble<N>>::max_digits10));
+	// scale to [1, 10) and peel off one digit more than requested, for rounding
+	MultiDouble<N> x = abs(*this);
+	int e = int(std::floor(std::log10(x[0])));
+	x = (e >= 0) ? (x / pow(MultiDouble<N>(10.0), e)) : (x * pow(MultiDouble<N>(10.0), -e));
+	if (x < 1.0)
+	{
+		x *= 10.0;
+		--e;
+	}
+	else if (x >= 10.0)
+	{
+		x /= 10.0;
+		++e;
+	}
+	std::string d(digits + 1, '0');
+	for (int i = 0; i <= digits; ++i)
+	{
+		const int digit = std::max(0, std::min(9, int(floor(x)[0])));
+		d[i] = char('0' + digit);
+		x = (x - double(digit)) * 10.0;
+	}
+	const bool up = (d[digits] >= '5');
+	d.resize(digits);
+	for (int i = digits - 1; up && i >= 0; --i)
+	{
+		if (d[i] == '9')
+			d[i] = '0';
+		else
+		{
+			++d[i];
+			break;
+		}
+		if (i == 0)
+		{
+			d.insert(d.begin(), '1');
+			d.resize(digits);
+			++e;
+		}
+	}
+	if (e >= -4 && e < digits)
+	{
+		if (e < 0)
+			d = "0." + std::string(-e - 1, '0') + d;
+		else if (e + 1 < digits)
+			d.insert(d.begin() + e + 1, '.');
+	}
+	else
+	{
+		d.insert(d.begin() + 1, '.');
+		std::ostringstream sstr;
+		sstr << "e" << ((e < 0) ? ("-") : ("+")) << ((std::abs(e) < 10) ? ("0") : ("")) << std::abs(e);
+		d += sstr.str();
+	}
+	// strip trailing zeros of the fraction, as %g does
+	const std::size_t point = d.find('.');
+	if (point != std::string::npos)
+	{
+		const std::size_t exponent = d.find('e');
+		const std::size_t end = (exponent == std::string::npos) ? (d.size()) : (exponent);
+		std::size_t last = end;
+		while (last > point + 1 && d[last - 1] == '0')
+			--last;
+		if (last == point + 1)
+			--last;
+		d.erase(last, end - last);
+	}
+	return res + d;
+}
+#endif
+
+#ifdef _STD_OSTREAM_INCLUDED_
+/// output override, with the stream's precision as the number of significant digits
+template <unsigned int N> inline std::ostream& operator<<(std::ostream& ostr, const MultiDouble<N>& a)
+{
+	return (ostr << a.to_string(int(ostr.precision())));
+}
+#endif
+
+#endif
@@ -0,0 +1,325 @@
+#ifndef _FHP_TDUAL_HPP_INCLUDED_
+#define _FHP_TDUAL_HPP_INCLUDED_
+
+#if defined(__GNUC__) || defined(__clang__)
+#  include <iostream>
+#  define _STD_OSTREAM_INCLUDED_ 1
+#endif
+
+#include <cmath>
+#include <cstddef>
+#include <type_traits>
+#include "tvector.hpp"
+
+
+/**
+ * Forward-mode dual number with N tangent lanes: x = v + sum d[i]*e_i with e_i*e_j = 0, so every operation carries
+ * the derivatives along N directions at once. Seeding the inputs of a function with the unit directions (see
+ * seed()) yields N columns of its Jacobian from one evaluation. The lanes are a plain array updated in loops of
+ * fixed length N, which the compiler unrolls and vectorizes.
+ * Works as the coefficient type of Polynomial and as the component type of Complex and Vector; comparisons look at
+ * the value only.
+ */
+template <typename _ty, unsigned int N> class Dual
+{
+protected:
+	_ty v;
+	_ty d[N];
+
+public:
+	typedef _ty value_type;
+	enum { lanes = N };
+
+	/// constructor
+	/** zero */
+	inline Dual() : v(_ty(0))
+	{
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] = _ty(0);
+	}
+	/** a constant */
+	inline Dual(const _ty x) : v(x)
+	{
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] = _ty(0);
+	}
+	/** constants of other arithmetic types, so that expressions like 2 * x keep working */
+	template <typename aux, typename = typename std::enable_if<std::is_arithmetic<aux>::value>::type> inline Dual(const aux x) : Dual(static_cast<_ty>(x)) {}
+	/** a variable with derivative 1 in lane `lane` */
+	inline Dual(const _ty x, const unsigned int lane) : Dual(x)
+	{
+		d[lane] = _ty(1);
+	}
+
+	/// direct access
+	inline _ty value() const { return v; }
+	inline _ty tangent(const unsigned int i) const { return d[i]; }
+	inline const _ty* tangents() const { return d; }
+	inline _ty* tangents() { return d; }
+	inline Dual<_ty, N>& set_value(const _ty x)
+	{
+		v = x;
+		return *this;
+	}
+	inline Dual<_ty, N>& set_tangent(const unsigned int i, const _ty x)
+	{
+		d[i] = x;
+		return *this;
+	}
+
+	/// chain rule: the result with value fx and derivative df times the tangents of *this
+	inline Dual<_ty, N> apply(const _ty fx, const _ty df) const
+	{
+		Dual<_ty, N> res(fx);
+		for (unsigned int i = 0; i < N; ++i)
+			res.d[i] = df * d[i];
+		return res;
+	}
+
+	/// indirect assignment operators
+	inline Dual<_ty, N>& operator+=(const Dual<_ty, N>& o)
+	{
+		v += o.v;
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] += o.d[i];
+		return *this;
+	}
+	inline Dual<_ty, N>& operator-=(const Dual<_ty, N>& o)
+	{
+		v -= o.v;
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] -= o.d[i];
+		return *this;
+	}
+	inline Dual<_ty, N>& operator*=(const Dual<_ty, N>& o)
+	{
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] = d[i] * o.v + v * o.d[i];
+		v *= o.v;
+		return *this;
+	}
+	inline Dual<_ty, N>& operator/=(const Dual<_ty, N>& o)
+	{
+		const _ty r = _ty(1) / o.v, q = v * r;
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] = (d[i] - q * o.d[i]) * r;
+		v = q;
+		return *this;
+	}
+	inline Dual<_ty, N>& operator+=(const _ty x)
+	{
+		v += x;
+		return *this;
+	}
+	inline Dual<_ty, N>& operator-=(const _ty x)
+	{
+		v -= x;
+		return *this;
+	}
+	inline Dual<_ty, N>& operator*=(const _ty x)
+	{
+		v *= x;
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] *= x;
+		return *this;
+	}
+	inline Dual<_ty, N>& operator/=(const _ty x)
+	{
+		const _ty r = _ty(1) / x;
+		v *= r;
+		for (unsigned int i = 0; i < N; ++i)
+			d[i] *= r;
+		return *this;
+	}
+
+	/// arithmetic operators
+	inline Dual<_ty, N> operator-() const
+	{
+		Dual<_ty, N> res(-v);
+		for (unsigned int i = 0; i < N; ++i)
+			res.d[i] = -d[i];
+		return res;
+	}
+	inline Dual<_ty, N> operator+(const Dual<_ty, N>& o) const { return Dual<_ty, N>(*this) += o; }
+	inline Dual<_ty, N> operator-(const Dual<_ty, N>& o) const { return Dual<_ty, N>(*this) -= o; }
+	inline Dual<_ty, N> operator*(const Dual<_ty, N>& o) const { return Dual<_ty, N>(*this) *= o; }
+	inline Dual<_ty, N> operator/(const Dual<_ty, N>& o) const { return Dual<_ty, N>(*this) /= o; }
+	inline Dual<_ty, N> operator+(const _ty x) const { return Dual<_ty, N>(*this) += x; }
+	inline Dual<_ty, N> operator-(const _ty x) const { return Dual<_ty, N>(*this) -= x; }
+	inline Dual<_ty, N> operator*(const _ty x) const { return Dual<_ty, N>(*this) *= x; }
+	inline Dual<_ty, N> operator/(const _ty x) const { return Dual<_ty, N>(*this) /= x; }
+
+	/// comparison of the values
+	inline bool operator==(const Dual<_ty, N>& o) const { return v == o.v; }
+	inline bool operator!=(const Dual<_ty, N>& o) const { return v != o.v; }
+	inline bool operator<(const Dual<_ty, N>& o) const { return v < o.v; }
+	inline bool operator>(const Dual<_ty, N>& o) const { return v > o.v; }
+	inline bool operator<=(const Dual<_ty, N>& o) const { return v <= o.v; }
+	inline bool operator>=(const Dual<_ty, N>& o) const { return v >= o.v; }
+};
+/// arithmetic operators, with the primitive data type as first operand
+template <typename _ty, unsigned int N> inline Dual<_ty, N> operator+(const _ty a, const Dual<_ty, N>& x)
+{
+	return x + a;
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> operator-(const _ty a, const Dual<_ty, N>& x)
+{
+	return -x + a;
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> operator*(const _ty a, const Dual<_ty, N>& x)
+{
+	return x * a;
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> operator/(const _ty a, const Dual<_ty, N>& x)
+{
+	return x.apply(a / x.value(), -a / (x.value() * x.value()));
+}
+
+/// elementary functions
+template <typename _ty, unsigned int N> inline Dual<_ty, N> sqrt(const Dual<_ty, N>& x)
+{
+	using std::sqrt;
+	const _ty s = sqrt(x.value());
+	return x.apply(s, _ty(0.5) / s);
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> exp(const Dual<_ty, N>& x)
+{
+	using std::exp;
+	const _ty e = exp(x.value());
+	return x.apply(e, e);
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> log(const Dual<_ty, N>& x)
+{
+	using std::log;
+	return x.apply(log(x.value()), _ty(1) / x.value());
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> sin(const Dual<_ty, N>& x)
+{
+	using std::sin;
+	using std::cos;
+	return x.apply(sin(x.value()), cos(x.value()));
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> cos(const Dual<_ty, N>& x)
+{
+	using std::sin;
+	using std::cos;
+	return x.apply(cos(x.value()), -sin(x.value()));
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> tan(const Dual<_ty, N>& x)
+{
+	using std::tan;
+	const _ty t = tan(x.value());
+	return x.apply(t, _ty(1) + t * t);
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> atan(const Dual<_ty, N>& x)
+{
+	using std::atan;
+	return x.apply(atan(x.value()), _ty(1) / (_ty(1) + x.value() * x.value()));
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> sinh(const Dual<_ty, N>& x)
+{
+	using std::sinh;
+	using std::cosh;
+	return x.apply(sinh(x.value()), cosh(x.value()));
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> cosh(const Dual<_ty, N>& x)
+{
+	using std::sinh;
+	using std::cosh;
+	return x.apply(cosh(x.value()), sinh(x.value()));
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> tanh(const Dual<_ty, N>& x)
+{
+	using std::tanh;
+	const _ty t = tanh(x.value());
+	return x.apply(t, _ty(1) - t * t);
+}
+/** |x|, with derivative sign(x) (0 at 0) */
+template <typename _ty, unsigned int N> inline Dual<_ty, N> abs(const Dual<_ty, N>& x)
+{
+	using std::abs;
+	return x.apply(abs(x.value()), (x.value() > _ty(0)) ? (_ty(1)) : ((x.value() < _ty(0)) ? (_ty(-1)) : (_ty(0))));
+}
+template <typename _ty, unsigned int N> inline Dual<_ty, N> pow(const Dual<_ty, N>& x, const _ty p)
+{
+	using std::pow;
+	const _ty xp = pow(x.value(), p - _ty(1));
+	return x.apply(xp * x.value(), p * xp);
+}
+/** x^y = exp(y log x), for x > 0 */
+template <typename _ty, unsigned int N> inline Dual<_ty, N> pow(const Dual<_ty, N>& x, const Dual<_ty, N>& y)
+{
+	return exp(y * log(x));
+}
+
+#ifdef _STD_OSTREAM_INCLUDED_
+/// output override: value[d0, d1, ...]
+template <typename _ty, unsigned int N> inline std::ostream& operator<<(std::ostream& ostr, const Dual<_ty, N>& x)
+{
+	ostr << x.value() << "[";
+	for (unsigned int i = 0; i < N; ++i)
+		ostr << ((i > 0) ? (", ") : ("")) << x.tangent(i);
+	return (ostr << "]");
+}
+#endif
+
+
+namespace dual
+{
+
+	/**
+	 * x as dual numbers whose lanes are the unit directions of the components first .. first+N-1 (those beyond dim
+	 * stay unseeded); evaluating f on it gives the Jacobian columns first .. first+N-1 in the tangents
+	 */
+	template <unsigned int N, unsigned int dim, typename base_t> inline Vector<dim, Dual<base_t, N>> seed(const Vector<dim, base_t>& x, const unsigned int first = 0)
+	{
+		Vector<dim, Dual<base_t, N>> res;
+		for (unsigned int i = 0; i < dim; ++i)
+			res.set(i, (i >= first && i - first < N) ? (Dual<base_t, N>(x.get(i), i - first)) : (Dual<base_t, N>(x.get(i))));
+		return res;
+	}
+
+	/** the values of a dual vector */
+	template <unsigned int dim, typename base_t, unsigned int N> inline Vector<dim, base_t> values(const Vector<dim, Dual<base_t, N>>& y)
+	{
+		Vector<dim, base_t> res;
+		for (unsigned int i = 0; i < dim; ++i)
+			res.set(i, y.get(i).value());
+		return res;
+	}
+
+	/**
+	 * Jacobian of f: Vector<dim, Dual<base_t, N>> -> Vector<m, Dual<base_t, N>> at x, in blocks of N columns, so
+	 * ceil(dim / N) evaluations; jac[i] is row i. value, if given, gets f(x).
+	 */
+	template <unsigned int N, unsigned int m, unsigned int dim, typename base_t, typename _fn> inline void jacobian(_fn&& f, const Vector<dim, base_t>& x, Vector<m, Vector<dim, base_t>>& jac, Vector<m, base_t>* value = nullptr)
+	{
+		for (unsigned int first = 0; first < dim; first += N)
+		{
+			const Vector<m, Dual<base_t, N>> y = f(seed<N>(x, first));
+			for (unsigned int i = 0; i < m; ++i)
+				for (unsigned int j = 0; j < N && first + j < dim; ++j)
+					jac[i][first + j] = y.get(i).tangent(j);
+			if (value && first == 0)
+				*value = values(y);
+		}
+	}
+
+	/** gradient of a scalar f: Vector<dim, Dual<base_t, N>> -> Dual<base_t, N> at x, ceil(dim / N) evaluations */
+	template <unsigned int N, unsigned int dim, typename base_t, typename _fn> inline Vector<dim, base_t> gradient(_fn&& f, const Vector<dim, base_t>& x, base_t* value = nullptr)
+	{
+		Vector<dim, base_t> g;
+		for (unsigned int first = 0; first < dim; first += N)
+		{
+			const Dual<base_t, N> y = f(seed<N>(x, first));
+			for (unsigned int j = 0; j < N && first + j < dim; ++j)
+				g.set(first + j, y.tangent(j));
+			if (value && first == 0)
+				*value = y.value();
+		}
+		return g;
+	}
+
+}
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef _FHP_TEFT_HPP_INCLUDED_
+#define _FHP_TEFT_HPP_INCLUDED_
+
+#include <cmath>
+
+
+/**
+ * Error-free transformations: the rounding error of a floating point sum or product is itself a double, so a + b and
+ * a * b can be split exactly into the rounded result and its error. MultiDouble and the compensated Horner scheme
+ * of polyeval are built on these.
+ */
+namespace eft
+{
+
+	/** s + e = a + b exactly, for any a and b (Knuth) */
+	inline double two_sum(const double a, const double b, double& e)
+	{
+		const double s = a + b;
+		const double bb = s - a;
+		e = (a - (s - bb)) + (b - bb);
+		return s;
+	}
+
+	/** s + e = a + b exactly, provided that |a| >= |b| or a is zero (Dekker) */
+	inline double quick_two_sum(const double a, const double b, double& e)
+	{
+		const double s = a + b;
+		e = b - (s - a);
+		return s;
+	}
+
+	/** hi + lo = a, both with at most 26 significant bits (Veltkamp) */
+	inline void split(const double a, double& hi, double& lo)
+	{
+		const double t = 134217729.0 * a;
+		hi = t - (t - a);
+		lo = a - hi;
+	}
+
+	/** p + e = a * b exactly: one fused multiply-add where the target has a fast one, Dekker's product otherwise */
+	inline double two_prod(const double a, const double b, double& e)
+	{
+		const double p = a * b;
+#ifdef FP_FAST_FMA
+		e = std::fma(a, b, -p);
+#else
+		double ah, al, bh, bl;
+		split(a, ah, al);
+		split(b, bh, bl);
+		e = ((ah * bh - p) + ah * bl + al * bh) + al * bl;
+#endif
+		return p;
+	}
+
+	/**
+	 * turns c[0..n-1], ordered by decreasing magnitude but possibly overlapping, into m nonoverlapping components:
+	 * a sweep from the bottom up carries the low parts into the leading ones, a sweep from the top down then emits
+	 * every nonzero error as the next component. c is overwritten.
+	 */
+	template <unsigned int n, unsigned int m> inline void renormalize(double* c, double* out)
+	{
+		if (!std::isfinite(c[0]))
+		{
+			out[0] = c[0];
+			for (unsigned int i = 1; i < m; ++i)
+				out[i] = 0.0;
+			return;
+		}
+		double s = c[n - 1], t;
+		for (unsigned int i = n - 1; i-- > 0;)
+		{
+			s = quick_two_sum(c[i], s, t);
+			c[i + 1] = t;
+		}
+		c[0] = s;
+		unsigned int k = 0;
+		for (unsigned int i = 1; i < n && k < m; ++i)
+		{
+			s = quick_two_sum(s, c[i], t);
+			if (t != 0.0)
+			{
+				out[k++] = s;
+				s = t;
+			}
+		}
+		if (k < m)
+			out[k++] = s;
+		while (k < m)
+			out[k++] = 0.0;
+	}
+
+}
+
+#endif
@@ -0,0 +1,618 @@
+#ifndef _FHP_TINTERVAL_HPP_INCLUDED_
+#define _FHP_TINTERVAL_HPP_INCLUDED_
+
+#if defined(__GNUC__) || defined(__clang__)
+#  include <iostream>
+#  define _STD_OSTREAM_INCLUDED_ 1
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include "teft.hpp"
+#include "tcomplex.hpp"
+
+
+/**
+ * Directed rounding without switching the rounding mode of the floating point unit, so it is thread-safe and costs no
+ * pipeline flushes. Every operation is rounded to nearest as usual and then moved one ulp outward if needed. For
+ * double, the error-free transformations give the exact error, so the result only moves if it actually lies on the
+ * wrong side of the exact value; other types always move. Needs round to nearest and no x87 excess precision.
+ */
+namespace rounding
+{
+
+	template <typename _ty> inline _ty down(const _ty x) { return std::nextafter(x, -std::numeric_limits<_ty>::infinity()); }
+	template <typename _ty> inline _ty up(const _ty x) { return std::nextafter(x, std::numeric_limits<_ty>::infinity()); }
+	/** the neighbours of a double by stepping its bit pattern, which the compiler inlines unlike the library call */
+	template <> inline double up(const double x)
+	{
+		if (!(x < std::numeric_limits<double>::infinity()))
+			return x;
+		if (x == 0.0)
+			return std::numeric_limits<double>::denorm_min();
+		std::uint64_t bits;
+		std::memcpy(&bits, &x, sizeof(bits));
+		bits = (x > 0.0) ? (bits + 1) : (bits - 1);
+		double res;
+		std::memcpy(&res, &bits, sizeof(res));
+		return res;
+	}
+	template <> inline double down(const double x) { return -up(-x); }
+
+	/** lower and upper bounds of + - * / and sqrt: rounded to nearest, then one ulp outward */
+	template <typename _ty> struct directed
+	{
+		static inline _ty add_down(const _ty a, const _ty b) { return down(a + b); }
+		static inline _ty add_up(const _ty a, const _ty b) { return up(a + b); }
+		static inline _ty sub_down(const _ty a, const _ty b) { return down(a - b); }
+		static inline _ty sub_up(const _ty a, const _ty b) { return up(a - b); }
+		static inline _ty mul_down(const _ty a, const _ty b) { return down(a * b); }
+		static inline _ty mul_up(const _ty a, const _ty b) { return up(a * b); }
+		static inline _ty div_down(const _ty a, const _ty b) { return down(a / b); }
+		static inline _ty div_up(const _ty a, const _ty b) { return up(a / b); }
+		static inline _ty sqrt_down(const _ty a) { using std::sqrt; return (a > _ty(0)) ? (down(sqrt(a))) : (sqrt(a)); }
+		static inline _ty sqrt_up(const _ty a) { using std::sqrt; return up(sqrt(a)); }
+	};
+
+	/**
+	 * double: the sign of the exact error decides. A NaN error (overflow inside Dekker's split, infinite operands)
+	 * and results near the underflow threshold, where the error itself may not be representable, always move.
+	 */
+	template <> struct directed<double>
+	{
+		/** below 2^-969 the error of a product is no longer exact */
+		static inline double tiny() { return DBL_MIN * 9007199254740992.0; }
+		/** s with exact error e (exact value s + e) */
+		static inline double settle_down(const double s, const double e) { return (e >= 0.0) ? (s) : (down(s)); }
+		static inline double settle_up(const double s, const double e) { return (e <= 0.0) ? (s) : (up(s)); }
+
+		static inline double add_down(const double a, const double b)
+		{
+			double e;
+			const double s = eft::two_sum(a, b, e);
+			return settle_down(s, e);
+		}
+		static inline double add_up(const double a, const double b)
+		{
+			double e;
+			const double s = eft::two_sum(a, b, e);
+			return settle_up(s, e);
+		}
+		static inline double sub_down(const double a, const double b) { return add_down(a, -b); }
+		static inline double sub_up(const double a, const double b) { return add_up(a, -b); }
+		static inline double mul_down(const double a, const double b)
+		{
+			double e;
+			const double p = eft::two_prod(a, b, e);
+			if (!(std::fabs(p) >= tiny()))
+				return (a == 0.0 || b == 0.0) ? (p) : (down(p));
+			return settle_down(p, e);
+		}
+		static inline double mul_up(const double a, const double b)
+		{
+			double e;
+			const double p = eft::two_prod(a, b, e);
+			if (!(std::fabs(p) >= tiny()))
+				return (a == 0.0 || b == 0.0) ? (p) : (up(p));
+			return settle_up(p, e);
+		}
+		/** a/b = q + r/b with the remainder r = a - q*b, which two_prod gives exactly; its sign relative to b decides */
+		static inline double division_remainder(const double a, const double b, const double q)
+		{
+			if (!(std::fabs(q) >= tiny() && std::fabs(a) >= tiny() && std::fabs(q) <= DBL_MAX))
+				return std::numeric_limits<double>::quiet_NaN();
+			double e;
+			const double p = eft::two_prod(q, b, e);
+			return ((a - p) - e) * ((b < 0.0) ? (-1.0) : (1.0));
+		}
+		static inline double div_down(const double a, const double b)
+		{
+			const double q = a / b;
+			if (a == 0.0 && b != 0.0)
+				return q;
+			const double r = division_remainder(a, b, q);
+			return (r >= 0.0) ? (q) : (down(q));
+		}
+		static inline double div_up(const double a, const double b)
+		{
+			const double q = a / b;
+			if (a == 0.0 && b != 0.0)
+				return q;
+			const double r = division_remainder(a, b, q);
+			return (r <= 0.0) ? (q) : (up(q));
+		}
+		/** a - s^2 exactly, NaN where that is not available */
+		static inline double sqrt_remainder(const double a, const double s)
+		{
+			if (!(a >= tiny() && a <= DBL_MAX))
+				return std::numeric_limits<double>::quiet_NaN();
+			double e;
+			const double p = eft::two_prod(s, s, e);
+			return (a - p) - e;
+		}
+		static inline double sqrt_down(const double a)
+		{
+			const double s = std::sqrt(a);
+			if (a == 0.0 || a == std::numeric_limits<double>::infinity())
+				return s;
+			const double r = sqrt_remainder(a, s);
+			return (r >= 0.0) ? (s) : ((s > 0.0) ? (down(s)) : (s));
+		}
+		static inline double sqrt_up(const double a)
+		{
+			const double s = std::sqrt(a);
+			if (a == 0.0 || a == std::numeric_limits<double>::infinity())
+				return s;
+			const double r = sqrt_remainder(a, s);
+			return (r <= 0.0) ? (s) : (up(s));
+		}
+	};
+
+	/** upper bound of sqrt(a^2 + b^2) */
+	template <typename _ty> inline _ty hypot_up(const _ty a, const _ty b)
+	{
+		typedef directed<_ty> R;
+		return R::sqrt_up(R::add_up(R::mul_up(a, a), R::mul_up(b, b)));
+	}
+	/** lower bound of sqrt(a^2 + b^2) */
+	template <typename _ty> inline _ty hypot_down(const _ty a, const _ty b)
+	{
+		typedef directed<_ty> R;
+		using std::abs;
+		const _ty aa = abs(a), ab = abs(b);
+		return R::sqrt_down(R::add_down(R::mul_down(aa, aa), R::mul_down(ab, ab)));
+	}
+
+}
+
+
+/**
+ * Closed interval [lower, upper] of _ty with outward rounding (see namespace rounding), so the result of every
+ * operation contains all results of the operation on points of the operands. Division by an interval containing zero
+ * gives the whole line. Works as the coefficient type of Polynomial, where evaluation encloses the range of the
+ * polynomial, and as the component type of Complex (ComplexRectangle below).
+ * The comparisons are certain relations: a < b if every point of a is below every point of b, == is equality of the
+ * bounds.
+ */
+template <typename _ty> class Interval
+{
+protected:
+	_ty lo, hi;
+	typedef rounding::directed<_ty> R;
+
+	/** products of bounds where 0 times an infinite bound counts as 0 */
+	static inline _ty mul_lo(const _ty a, const _ty b) { return (a == _ty(0) || b == _ty(0)) ? (_ty(0)) : (R::mul_down(a, b)); }
+	static inline _ty mul_hi(const _ty a, const _ty b) { return (a == _ty(0) || b == _ty(0)) ? (_ty(0)) : (R::mul_up(a, b)); }
+
+public:
+	typedef _ty value_type;
+
+	/// constructor
+	/** [0, 0] */
+	inline Interval() : lo(_ty(0)), hi(_ty(0)) {}
+	/** the point x */
+	inline Interval(const _ty x) : lo(x), hi(x) {}
+	/** [l, h]; l <= h is the caller's responsibility */
+	inline Interval(const _ty l, const _ty h) : lo(l), hi(h) {}
+	/** constants of other arithmetic types, enclosed if _ty cannot represent them */
+	template <typename aux, typename = typename std::enable_if<std::is_arithmetic<aux>::value>::type> inline Interval(const aux x) : lo(static_cast<_ty>(x)), hi(lo)
+	{
+		using std::abs;
+		const bool exact = (std::is_integral<aux>::value) ? (abs(lo) <= _ty(2) / std::numeric_limits<_ty>::epsilon()) : (static_cast<aux>(lo) == x || x != x);
+		if (!exact)
+		{
+			lo = rounding::down(lo);
+			hi = rounding::up(hi);
+		}
+	}
+	/** (-inf, inf) */
+	static inline Interval<_ty> entire() { return Interval<_ty>(-std::numeric_limits<_ty>::infinity(), std::numeric_limits<_ty>::infinity()); }
+
+	/// direct access
+	inline _ty lower() const { return lo; }
+	inline _ty upper() const { return hi; }
+	/** a point of the interval near its centre (finite also for unbounded intervals) */
+	inline _ty mid() const
+	{
+		if (lo == -hi)
+			return _ty(0);
+		if (lo == -std::numeric_limits<_ty>::infinity())
+			return -std::numeric_limits<_ty>::max();
+		if (hi == std::numeric_limits<_ty>::infinity())
+			return std::numeric_limits<_ty>::max();
+		const _ty m = lo / _ty(2) + hi / _ty(2);
+		return std::min(std::max(m, lo), hi);
+	}
+	/** upper bound of the largest distance from mid() to a point of the interval */
+	inline _ty rad() const
+	{
+		const _ty m = mid();
+		return std::max(R::sub_up(hi, m), R::sub_up(m, lo));
+	}
+	/** upper bound of upper - lower */
+	inline _ty width() const { return R::sub_up(hi, lo); }
+	/** largest |x| in the interval */
+	inline _ty mag() const
+	{
+		using std::abs;
+		return std::max(abs(lo), abs(hi));
+	}
+	/** smallest |x| in the interval */
+	inline _ty mig() const
+	{
+		return (lo > _ty(0)) ? (lo) : ((hi < _ty(0)) ? (-hi) : (_ty(0)));
+	}
+	inline bool contains(const _ty x) const { return lo <= x && x <= hi; }
+	inline bool contains(const Interval<_ty>& o) const { return lo <= o.lo && o.hi <= hi; }
+
+	/// indirect assignment operators
+	inline Interval<_ty>& operator+=(const Interval<_ty>& o)
+	{
+		lo = R::add_down(lo, o.lo);
+		hi = R::add_up(hi, o.hi);
+		return *this;
+	}
+	inline Interval<_ty>& operator-=(const Interval<_ty>& o)
+	{
+		const _ty l = R::sub_down(lo, o.hi);
+		hi = R::sub_up(hi, o.lo);
+		lo = l;
+		return *this;
+	}
+	inline Interval<_ty>& operator*=(const Interval<_ty>& o) { return (*this = *this * o); }
+	inline Interval<_ty>& operator/=(const Interval<_ty>& o) { return (*this = *this / o); }
+
+	/// arithmetic operators
+	inline Interval<_ty> operator-() const { return Interval<_ty>(-hi, -lo); }
+	inline Interval<_ty> operator+(const Interval<_ty>& o) const { return Interval<_ty>(R::add_down(lo, o.lo), R::add_up(hi, o.hi)); }
+	inline Interval<_ty> operator-(const Interval<_ty>& o) const { return Interval<_ty>(R::sub_down(lo, o.hi), R::sub_up(hi, o.lo)); }
+	/** by the signs of the bounds: two products unless both operands contain zero in their interior */
+	inline Interval<_ty> operator*(const Interval<_ty>& o) const
+	{
+		const _ty al = lo, ah = hi, bl = o.lo, bh = o.hi;
+		if (al >= _ty(0))
+		{
+			if (bl >= _ty(0))
+				return Interval<_ty>(mul_lo(al, bl), mul_hi(ah, bh));
+			if (bh <= _ty(0))
+				return Interval<_ty>(mul_lo(ah, bl), mul_hi(al, bh));
+			return Interval<_ty>(mul_lo(ah, bl), mul_hi(ah, bh));
+		}
+		if (ah <= _ty(0))
+		{
+			if (bl >= _ty(0))
+				return Interval<_ty>(mul_lo(al, bh), mul_hi(ah, bl));
+			if (bh <= _ty(0))
+				return Interval<_ty>(mul_lo(ah, bh), mul_hi(al, bl));
+			return Interval<_ty>(mul_lo(al, bh), mul_hi(al, bl));
+		}
+		if (bl >= _ty(0))
+			return Interval<_ty>(mul_lo(al, bh), mul_hi(ah, bh));
+		if (bh <= _ty(0))
+			return Interval<_ty>(mul_lo(ah, bl), mul_hi(al, bl));
+		return Interval<_ty>(std::min(mul_lo(al, bh), mul_lo(ah, bl)), std::max(mul_hi(al, bl), mul_hi(ah, bh)));
+	}
+	/** the whole line if o contains zero */
+	inline Interval<_ty> operator/(const Interval<_ty>& o) const
+	{
+		const _ty al = lo, ah = hi, bl = o.lo, bh = o.hi;
+		if (bl > _ty(0))
+		{
+			if (al >= _ty(0))
+				return Interval<_ty>(R::div_down(al, bh), R::div_up(ah, bl));
+			if (ah <= _ty(0))
+				return Interval<_ty>(R::div_down(al, bl), R::div_up(ah, bh));
+			return Interval<_ty>(R::div_down(al, bl), R::div_up(ah, bl));
+		}
+		if (bh < _ty(0))
+		{
+			if (al >= _ty(0))
+				return Interval<_ty>(R::div_down(ah, bh), R::div_up(al, bl));
+			if (ah <= _ty(0))
+				return Interval<_ty>(R::div_down(ah, bl), R::div_up(al, bh));
+			return Interval<_ty>(R::div_down(ah, bh), R::div_up(al, bh));
+		}
+		return entire();
+	}
+
+	/// certain comparisons
+	inline bool operator==(const Interval<_ty>& o) const { return lo == o.lo && hi == o.hi; }
+	inline bool operator!=(const Interval<_ty>& o) const { return lo != o.lo || hi != o.hi; }
+	inline bool operator<(const Interval<_ty>& o) const { return hi < o.lo; }
+	inline bool operator>(const Interval<_ty>& o) const { return lo > o.hi; }
+	inline bool operator<=(const Interval<_ty>& o) const { return hi <= o.lo; }
+	inline bool operator>=(const Interval<_ty>& o) const { return lo >= o.hi; }
+};
+/// arithmetic operators, with the primitive data type as first operand
+template <typename _ty> inline Interval<_ty> operator+(const _ty a, const Interval<_ty>& x) { return Interval<_ty>(a) + x; }
+template <typename _ty> inline Interval<_ty> operator-(const _ty a, const Interval<_ty>& x) { return Interval<_ty>(a) - x; }
+template <typename _ty> inline Interval<_ty> operator*(const _ty a, const Interval<_ty>& x) { return Interval<_ty>(a) * x; }
+template <typename _ty> inline Interval<_ty> operator/(const _ty a, const Interval<_ty>& x) { return Interval<_ty>(a) / x; }
+
+/// set operations
+/** the smallest interval holding a and b */
+template <typename _ty> inline Interval<_ty> hull(const Interval<_ty>& a, const Interval<_ty>& b)
+{
+	return Interval<_ty>(std::min(a.lower(), b.lower()), std::max(a.upper(), b.upper()));
+}
+/** a and b intersected into *res; false if they are disjoint */
+template <typename _ty> inline bool intersect(const Interval<_ty>& a, const Interval<_ty>& b, Interval<_ty>* res)
+{
+	const _ty l = std::max(a.lower(), b.lower()), h = std::min(a.upper(), b.upper());
+	if (l > h)
+		return false;
+	if (res)
+		*res = Interval<_ty>(l, h);
+	return true;
+}
+/** whether inner lies in the interior of outer */
+template <typename _ty> inline bool in_interior(const Interval<_ty>& inner, const Interval<_ty>& outer)
+{
+	return outer.lower() < inner.lower() && inner.upper() < outer.upper();
+}
+
+/// elementary functions
+template <typename _ty> inline Interval<_ty> abs(const Interval<_ty>& x) { return Interval<_ty>(x.mig(), x.mag()); }
+template <typename _ty> inline Interval<_ty> fabs(const Interval<_ty>& x) { return abs(x); }
+/** x^2, tighter than x*x for intervals around zero */
+template <typename _ty> inline Interval<_ty> sqr(const Interval<_ty>& x)
+{
+	typedef rounding::directed<_ty> R;
+	const _ty m = x.mig(), M = x.mag();
+	return Interval<_ty>(R::mul_down(m, m), R::mul_up(M, M));
+}
+template <typename _ty> inline Interval<_ty> sqrt(const Interval<_ty>& x)
+{
+	typedef rounding::directed<_ty> R;
+	if (x.upper() < _ty(0))
+		return Interval<_ty>(std::numeric_limits<_ty>::quiet_NaN());
+	return Interval<_ty>(R::sqrt_down(std::max(x.lower(), _ty(0))), R::sqrt_up(x.upper()));
+}
+/** x^n for integer n: monotone in |x| for even n, in x for odd n */
+template <typename _ty> inline Interval<_ty> pow(const Interval<_ty>& x, const int n)
+{
+	typedef rounding::directed<_ty> R;
+	if (n == 0)
+		return Interval<_ty>(_ty(1));
+	if (n < 0)
+		return Interval<_ty>(_ty(1)) / pow(x, -n);
+	// a^n for a >= 0, rounded down or up
+	auto power = [](const _ty a, int k, const bool upward)
+	{
+		_ty r = _ty(1), b = a;
+		while (true)
+		{
+			if (k & 1)
+				r = (upward) ? (R::mul_up(r, b)) : (R::mul_down(r, b));
+			k >>= 1;
+			if (k == 0)
+				return r;
+			b = (upward) ? (R::mul_up(b, b)) : (R::mul_down(b, b));
+		}
+	};
+	if (n % 2 == 0)
+		return Interval<_ty>(power(x.mig(), n, false), power(x.mag(), n, true));
+	const _ty l = (x.lower() >= _ty(0)) ? (power(x.lower(), n, false)) : (-power(-x.lower(), n, true));
+	const _ty h = (x.upper() >= _ty(0)) ? (power(x.upper(), n, true)) : (-power(-x.upper(), n, false));
+	return Interval<_ty>(l, h);
+}
+
+/**
+ * exp, log, sin and cos trust the C library to within one ulp (true of glibc for double) and step two ulps outward;
+ * sin and cos add the extrema at multiples of pi/2 inside the interval
+ */
+template <typename _ty> inline Interval<_ty> exp(const Interval<_ty>& x)
+{
+	using std::exp;
+	using rounding::down;
+	using rounding::up;
+	return Interval<_ty>(std::max(_ty(0), down(down(exp(x.lower())))), up(up(exp(x.upper()))));
+}
+/** the logarithm of the positive part of x */
+template <typename _ty> inline Interval<_ty> log(const Interval<_ty>& x)
+{
+	using std::log;
+	using rounding::down;
+	using rounding::up;
+	if (x.upper() < _ty(0))
+		return Interval<_ty>(std::numeric_limits<_ty>::quiet_NaN());
+	const _ty l = (x.lower() > _ty(0)) ? (down(down(log(x.lower())))) : (-std::numeric_limits<_ty>::infinity());
+	return Interval<_ty>(l, up(up(log(x.upper()))));
+}
+namespace interval_detail
+{
+
+	/** range of a function with maxima 1 at (2k + shift)*pi and minima -1 at (2k + 1 + shift)*pi, from its endpoint values */
+	template <typename _ty> inline Interval<_ty> periodic_range(const Interval<_ty>& x, const _ty fl, const _ty fh, const _ty shift)
+	{
+		using std::abs;
+		using std::floor;
+		using std::ceil;
+		using std::fmod;
+		using rounding::down;
+		using rounding::up;
+		const _ty one = _ty(1);
+		if (!(x.upper() - x.lower() < _ty(6)) || !(x.mag() < _ty(1125899906842624.0)))
+			return Interval<_ty>(-one, one);
+		const _ty pi = _ty(3.14159265358979323846264338327950288L);
+		const _ty tl = x.lower() / pi - shift, th = x.upper() / pi - shift;
+		const _ty slack = _ty(8) * std::numeric_limits<_ty>::epsilon() * (abs(tl) + abs(th) + one);
+		_ty l = std::min(down(down(fl)), down(down(fh))), h = std::max(up(up(fl)), up(up(fh)));
+		for (_ty k = ceil(tl - slack); k <= floor(th + slack); k += one)
+		{
+			if (fmod(k, _ty(2)) == _ty(0))
+				h = one;
+			else
+				l = -one;
+		}
+		return Interval<_ty>(std::max(l, -one), std::min(h, one));
+	}
+
+}
+
+template <typename _ty> inline Interval<_ty> cos(const Interval<_ty>& x)
+{
+	using std::cos;
+	return interval_detail::periodic_range(x, _ty(cos(x.lower())), _ty(cos(x.upper())), _ty(0));
+}
+template <typename _ty> inline Interval<_ty> sin(const Interval<_ty>& x)
+{
+	using std::sin;
+	return interval_detail::periodic_range(x, _ty(sin(x.lower())), _ty(sin(x.upper())), _ty(0.5));
+}
+
+#ifdef _STD_OSTREAM_INCLUDED_
+/// output override: [lower, upper]
+template <typename _ty> inline std::ostream& operator<<(std::ostream& ostr, const Interval<_ty>& x)
+{
+	return (ostr << "[" << x.lower() << ", " << x.upper() << "]");
+}
+#endif
+
+
+/** rectangular complex interval: Complex arithmetic on interval components encloses every result */
+template <typename _ty> using ComplexRectangle = Complex<Interval<_ty>>;
+
+
+/**
+ * Closed complex disc {z : |z - center| <= radius} in circular arithmetic (Gargantini and Henrici): the centre is
+ * computed on interval components and every rounding, together with the spread of the exact operation, goes into the
+ * radius, rounded upward. Products and quotients stay much tighter than rectangles when the operands are not aligned
+ * with the axes, which is what root inclusions need. 1/D is the whole plane (infinite radius) unless D certainly
+ * excludes zero. Works as the coefficient type of Polynomial.
+ */
+template <typename _ty> class ComplexDisc
+{
+protected:
+	Complex<_ty> c;
+	_ty r;
+	typedef rounding::directed<_ty> R;
+	typedef Interval<_ty> I;
+
+	/**
+	 * the disc around the box re x im, widened by rr; the half-diagonal of the box is bounded by the sum of its half
+	 * sides, as these are only rounding errors and a square root per operation would dominate the cost
+	 */
+	static inline ComplexDisc<_ty> around(const I& re, const I& im, const _ty rr)
+	{
+		return ComplexDisc<_ty>(Complex<_ty>(re.mid(), im.mid()), R::add_up(rr, R::add_up(re.rad(), im.rad())));
+	}
+
+public:
+	typedef _ty value_type;
+
+	/// constructor
+	/** the point 0 */
+	inline ComplexDisc() : c(), r(_ty(0)) {}
+	/** the disc around center; a negative radius is the caller's responsibility */
+	inline ComplexDisc(const Complex<_ty>& center, const _ty radius = _ty(0)) : c(center), r(radius) {}
+	/** a real constant, enclosed if _ty cannot represent it */
+	template <typename aux, typename = typename std::enable_if<std::is_arithmetic<aux>::value>::type> inline ComplexDisc(const aux x)
+	{
+		const I e(x);
+		*this = around(e, I(_ty(0)), _ty(0));
+	}
+#ifdef _STD_COMPLEX_INCLUDED_
+	inline ComplexDisc(const std::complex<_ty>& center, const _ty radius = _ty(0)) : c(center), r(radius) {}
+#endif
+	/** the disc around a rectangle */
+	inline ComplexDisc(const ComplexRectangle<_ty>& box) : ComplexDisc(around(box.real(), box.imag(), _ty(0))) {}
+
+	/// direct access
+	inline Complex<_ty> center() const { return c; }
+	inline _ty radius() const { return r; }
+	/** upper bound of |z - center| */
+	inline _ty distance_up(const Complex<_ty>& z) const
+	{
+		const I dr = I(z.real()) - I(c.real()), di = I(z.imag()) - I(c.imag());
+		return rounding::hypot_up(dr.mag(), di.mag());
+	}
+	/** whether z certainly lies in the disc */
+	inline bool contains(const Complex<_ty>& z) const { return distance_up(z) <= r; }
+	/** the rectangle around the disc */
+	inline ComplexRectangle<_ty> rectangle() const
+	{
+		return ComplexRectangle<_ty>(I(R::sub_down(c.real(), r), R::add_up(c.real(), r)), I(R::sub_down(c.imag(), r), R::add_up(c.imag(), r)));
+	}
+	/** upper bound of |center| + radius */
+	inline _ty mag() const { return R::add_up(rounding::hypot_up(c.real(), c.imag()), r); }
+
+	/// arithmetic operators
+	inline ComplexDisc<_ty> operator-() const { return ComplexDisc<_ty>(-c, r); }
+	inline ComplexDisc<_ty> operator+(const ComplexDisc<_ty>& o) const
+	{
+		return around(I(c.real()) + I(o.c.real()), I(c.imag()) + I(o.c.imag()), R::add_up(r, o.r));
+	}
+	inline ComplexDisc<_ty> operator-(const ComplexDisc<_ty>& o) const
+	{
+		return around(I(c.real()) - I(o.c.real()), I(c.imag()) - I(o.c.imag()), R::add_up(r, o.r));
+	}
+	/** D(a, r) * D(b, s) = D(ab, |a| s + |b| r + r s) */
+	inline ComplexDisc<_ty> operator*(const ComplexDisc<_ty>& o) const
+	{
+		const I ar(c.real()), ai(c.imag()), br(o.c.real()), bi(o.c.imag());
+		_ty rr = _ty(0);
+		if (r != _ty(0) || o.r != _ty(0))
+		{
+			const _ty ma = rounding::hypot_up(c.real(), c.imag()), mb = rounding::hypot_up(o.c.real(), o.c.imag());
+			rr = R::add_up(R::add_up(R::mul_up(ma, o.r), R::mul_up(mb, r)), R::mul_up(r, o.r));
+		}
+		return around(ar * br - ai * bi, ar * bi + ai * br, rr);
+	}
+	/** 1/D(a, r) = D(conj(a), r) / (|a|^2 - r^2) if |a| > r */
+	inline ComplexDisc<_ty> reciprocal() const
+	{
+		const I ar(c.real()), ai(c.imag());
+		const I den = (sqr(ar) + sqr(ai)) - sqr(I(r));
+		if (!(den.lower() > _ty(0)))
+			return ComplexDisc<_ty>(Complex<_ty>(_ty(0)), std::numeric_limits<_ty>::infinity());
+		return around(ar / den, -ai / den, (I(r) / den).upper());
+	}
+	inline ComplexDisc<_ty> operator/(const ComplexDisc<_ty>& o) const { return *this * o.reciprocal(); }
+
+	/// indirect assignment operators
+	inline ComplexDisc<_ty>& operator+=(const ComplexDisc<_ty>& o) { return (*this = *this + o); }
+	inline ComplexDisc<_ty>& operator-=(const ComplexDisc<_ty>& o) { return (*this = *this - o); }
+	inline ComplexDisc<_ty>& operator*=(const ComplexDisc<_ty>& o) { return (*this = *this * o); }
+	inline ComplexDisc<_ty>& operator/=(const ComplexDisc<_ty>& o) { return (*this = *this / o); }
+
+	/// comparison: the same centre and radius
+	inline bool operator==(const ComplexDisc<_ty>& o) const { return c == o.c && r == o.r; }
+	inline bool operator!=(const ComplexDisc<_ty>& o) const { return !(*this == o); }
+};
+
+/** the range of |z| over the disc */
+template <typename _ty> inline Interval<_ty> abs(const ComplexDisc<_ty>& d)
+{
+	typedef rounding::directed<_ty> R;
+	const Complex<_ty> c = d.center();
+	return Interval<_ty>(std::max(_ty(0), R::sub_down(rounding::hypot_down(c.real(), c.imag()), d.radius())), d.mag());
+}
+/** whether inner lies in the interior of outer: |c_inner - c_outer| + r_inner < r_outer, rounded upward */
+template <typename _ty> inline bool in_interior(const ComplexDisc<_ty>& inner, const ComplexDisc<_ty>& outer)
+{
+	return rounding::directed<_ty>::add_up(outer.distance_up(inner.center()), inner.radius()) < outer.radius();
+}
+/** whether the discs certainly have no point in common */
+template <typename _ty> inline bool disjoint(const ComplexDisc<_ty>& a, const ComplexDisc<_ty>& b)
+{
+	typedef rounding::directed<_ty> R;
+	const Complex<_ty> ca = a.center(), cb = b.center();
+	const Interval<_ty> dr = Interval<_ty>(ca.real()) - Interval<_ty>(cb.real()), di = Interval<_ty>(ca.imag()) - Interval<_ty>(cb.imag());
+	return rounding::hypot_down(dr.mig(), di.mig()) > R::add_up(a.radius(), b.radius());
+}
+
+#ifdef _STD_OSTREAM_INCLUDED_
+/// output override: (center +/- radius)
+template <typename _ty> inline std::ostream& operator<<(std::ostream& ostr, const ComplexDisc<_ty>& d)
+{
+	return (ostr << "(" << d.center() << " +/- " << d.radius() << ")");
+}
+#endif
+
+#endif
@@ -0,0 +1,166 @@
+#ifndef _FHP_TPARALLEL_HPP_INCLUDED_
+#define _FHP_TPARALLEL_HPP_INCLUDED_
+
+#include <cstddef>
+#include <thread>
+#include <vector>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
+
+
+namespace parallel
+{
+
+	/** number of threads to use for a requested count; 0 means one per hardware thread */
+	inline unsigned int resolve_threads(const unsigned int threads)
+	{
+		if (threads != 0)
+			return threads;
+		const unsigned int hw = std::thread::hardware_concurrency();
+		return (hw == 0) ? (1u) : (hw);
+	}
+
+	/** length of the ranges for_ranges() splits [0,n) into, or 0 if it runs on the calling thread only */
+	inline std::size_t range_chunk(const std::size_t n, const std::size_t threads, const std::size_t grain)
+	{
+		std::size_t t = threads;
+		const std::size_t g = (grain == 0) ? (1) : (grain);
+		if (t > (n + g - 1) / g)
+			t = (n + g - 1) / g;
+		if (t <= 1)
+			return 0;
+		// chunk boundaries are kept on multiples of the grain
+		return ((n / t + g - 1) / g) * g;
+	}
+
+	/** splits [0,n) into at most `threads` contiguous ranges of at least `grain` elements and calls fn(begin, end) on each, the first one on the calling thread */
+	template <typename _fn> inline void for_ranges(const std::size_t n, const unsigned int threads, _fn&& fn, const std::size_t grain = 1)
+	{
+		const std::size_t chunk = range_chunk(n, resolve_threads(threads), grain);
+		if (chunk == 0)
+		{
+			if (n > 0)
+				fn(std::size_t(0), n);
+			return;
+		}
+		const std::size_t t = (n + chunk - 1) / chunk;
+		std::vector<std::thread> workers;
+		workers.reserve(t - 1);
+		for (std::size_t begin = chunk; begin < n; begin += chunk)
+		{
+			const std::size_t end = (begin + chunk < n) ? (begin + chunk) : (n);
+			workers.push_back(std::thread([&fn, begin, end]() { fn(begin, end); }));
+		}
+		fn(std::size_t(0), (chunk < n) ? (chunk) : (n));
+		for (std::thread& w : workers)
+			w.join();
+	}
+
+	/**
+	 * Threads that are started once and reused, for loops that call for_ranges() many times in a row: a call wakes
+	 * the workers instead of creating them. The ranges are the same as those of parallel::for_ranges(), the first
+	 * again on the calling thread. Only one thread may call for_ranges() at a time.
+	 */
+	class pool
+	{
+	public:
+		explicit pool(const unsigned int threads) : size(resolve_threads(threads)), generation(0), pending(0), stop(false), call(nullptr), context(nullptr), n(0), chunk(0)
+		{
+			workers.reserve(size - 1);
+			for (std::size_t w = 1; w < size; ++w)
+				workers.push_back(std::thread([this, w]() { work(w); }));
+		}
+
+		pool(const pool&) = delete;
+		pool& operator=(const pool&) = delete;
+
+		~pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			wake.notify_all();
+			for (std::thread& w : workers)
+				w.join();
+		}
+
+		std::size_t threads() const { return size; }
+
+		template <typename _fn> void for_ranges(const std::size_t count, _fn&& fn, const std::size_t grain = 1)
+		{
+			const std::size_t c = range_chunk(count, size, grain);
+			if (c == 0)
+			{
+				if (count > 0)
+					fn(std::size_t(0), count);
+				return;
+			}
+			typedef typename std::remove_reference<_fn>::type fn_type;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				call = [](void* ctx, const std::size_t begin, const std::size_t end) { (*static_cast<fn_type*>(ctx))(begin, end); };
+				context = const_cast<void*>(static_cast<const void*>(&fn));
+				n = count;
+				chunk = c;
+				pending = size - 1;
+				++generation;
+			}
+			wake.notify_all();
+			fn(std::size_t(0), (c < count) ? (c) : (count));
+			std::unique_lock<std::mutex> lock(mutex);
+			done.wait(lock, [this]() { return pending == 0; });
+		}
+
+	private:
+		/** worker w takes the w-th range of every call, if there is one */
+		void work(const std::size_t w)
+		{
+			unsigned long seen = 0;
+			std::unique_lock<std::mutex> lock(mutex);
+			for (;;)
+			{
+				wake.wait(lock, [this, seen]() { return stop || generation != seen; });
+				if (stop)
+					return;
+				seen = generation;
+				const std::size_t begin = w * chunk, end = (begin + chunk < n) ? (begin + chunk) : (n);
+				if (begin < n)
+				{
+					void (*const f)(void*, std::size_t, std::size_t) = call;
+					void* const ctx = context;
+					lock.unlock();
+					f(ctx, begin, end);
+					lock.lock();
+				}
+				if (--pending == 0)
+					done.notify_one();
+			}
+		}
+
+		const std::size_t size;
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable wake, done;
+		unsigned long generation;
+		std::size_t pending;
+		bool stop;
+		void (*call)(void*, std::size_t, std::size_t);
+		void* context;
+		std::size_t n, chunk;
+	};
+
+	/** calls fn(i) for every i in [0,n), distributed like for_ranges() */
+	template <typename _fn> inline void for_each_index(const std::size_t n, const unsigned int threads, _fn&& fn, const std::size_t grain = 1)
+	{
+		for_ranges(n, threads, [&fn](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t i = begin; i < end; ++i)
+				fn(i);
+		}, grain);
+	}
+
+}
+
+#endif
@@ -0,0 +1,639 @@
+#ifndef _FHP_TPOLYEVAL_HPP_INCLUDED_
+#define _FHP_TPOLYEVAL_HPP_INCLUDED_
+
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <type_traits>
+#include "teft.hpp"
+
+#if !defined(_FHP_NO_SIMD_)
+#  if defined(__AVX512F__)
+#    define _FHP_POLYEVAL_AVX512_ 1
+#  elif defined(__AVX2__) && defined(__FMA__)
+#    define _FHP_POLYEVAL_AVX2_ 1
+#  elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define _FHP_POLYEVAL_SSE2_ 1
+#  endif
+#endif
+#if defined(_FHP_POLYEVAL_AVX512_) || defined(_FHP_POLYEVAL_AVX2_) || defined(_FHP_POLYEVAL_SSE2_)
+#  include <immintrin.h>
+#  define _FHP_POLYEVAL_SIMD_ 1
+#endif
+
+
+namespace polyeval
+{
+
+	/// generic kernels: four interleaved Horner chains, so consecutive points do not wait on each other
+	/** ys[k] = sum c[i]*xs[k]^i for k < n; c holds nc >= 1 coefficients, lowest first */
+	template <typename _ty> inline void horner(const _ty* c, const std::size_t nc, const _ty* xs, _ty* ys, const std::size_t n)
+	{
+		std::size_t k = 0;
+		for (; k + 4 <= n; k += 4)
+		{
+			const _ty x0 = xs[k], x1 = xs[k + 1], x2 = xs[k + 2], x3 = xs[k + 3];
+			_ty r0 = c[nc - 1], r1 = c[nc - 1], r2 = c[nc - 1], r3 = c[nc - 1];
+			for (std::size_t i = nc - 1; i-- > 0;)
+			{
+				r0 = r0 * x0 + c[i];
+				r1 = r1 * x1 + c[i];
+				r2 = r2 * x2 + c[i];
+				r3 = r3 * x3 + c[i];
+			}
+			ys[k] = r0;
+			ys[k + 1] = r1;
+			ys[k + 2] = r2;
+			ys[k + 3] = r3;
+		}
+		for (; k < n; ++k)
+		{
+			const _ty x = xs[k];
+			_ty r = c[nc - 1];
+			for (std::size_t i = nc - 1; i-- > 0;)
+				r = r * x + c[i];
+			ys[k] = r;
+		}
+	}
+
+	/** ys[k] = p(xs[k]) and dys[k] = p'(xs[k]); either output may be null */
+	template <typename _ty> inline void horner_derivative(const _ty* c, const std::size_t nc, const _ty* xs, _ty* ys, _ty* dys, const std::size_t n)
+	{
+		std::size_t k = 0;
+		for (; k + 4 <= n; k += 4)
+		{
+			const _ty x0 = xs[k], x1 = xs[k + 1], x2 = xs[k + 2], x3 = xs[k + 3];
+			_ty r0 = c[nc - 1], r1 = c[nc - 1], r2 = c[nc - 1], r3 = c[nc - 1];
+			_ty d0 = _ty(0), d1 = _ty(0), d2 = _ty(0), d3 = _ty(0);
+			for (std::size_t i = nc - 1; i-- > 0;)
+			{
+				d0 = d0 * x0 + r0;
+				d1 = d1 * x1 + r1;
+				d2 = d2 * x2 + r2;
+				d3 = d3 * x3 + r3;
+				r0 = r0 * x0 + c[i];
+				r1 = r1 * x1 + c[i];
+				r2 = r2 * x2 + c[i];
+				r3 = r3 * x3 + c[i];
+			}
+			if (ys)
+			{
+				ys[k] = r0;
+				ys[k + 1] = r1;
+				ys[k + 2] = r2;
+				ys[k + 3] = r3;
+			}
+			if (dys)
+			{
+				dys[k] = d0;
+				dys[k + 1] = d1;
+				dys[k + 2] = d2;
+				dys[k + 3] = d3;
+			}
+		}
+		for (; k < n; ++k)
+		{
+			const _ty x = xs[k];
+			_ty r = c[nc - 1], d = _ty(0);
+			for (std::size_t i = nc - 1; i-- > 0;)
+			{
+				d = d * x + r;
+				r = r * x + c[i];
+			}
+			if (ys)
+				ys[k] = r;
+			if (dys)
+				dys[k] = d;
+		}
+	}
+
+
+#ifdef _FHP_POLYEVAL_SIMD_
+	/// vector lanes for double; fmadd(a, b, c) = a*b + c, prod_error(a, b, p) = a*b - p exactly for p = fl(a*b)
+#  if defined(_FHP_POLYEVAL_AVX512_)
+	struct simd_double
+	{
+		typedef __m512d reg;
+		enum { width = 8 };
+		static inline reg set1(const double x) { return _mm512_set1_pd(x); }
+		static inline reg load(const double* p) { return _mm512_loadu_pd(p); }
+		static inline void store(double* p, const reg r) { _mm512_storeu_pd(p, r); }
+		static inline reg fmadd(const reg a, const reg b, const reg c) { return _mm512_fmadd_pd(a, b, c); }
+		static inline reg add(const reg a, const reg b) { return _mm512_add_pd(a, b); }
+		static inline reg sub(const reg a, const reg b) { return _mm512_sub_pd(a, b); }
+		static inline reg mul(const reg a, const reg b) { return _mm512_mul_pd(a, b); }
+		static inline reg div(const reg a, const reg b) { return _mm512_div_pd(a, b); }
+		static inline reg abs(const reg a) { return _mm512_abs_pd(a); }
+		static inline reg prod_error(const reg a, const reg b, const reg p) { return _mm512_fmsub_pd(a, b, p); }
+		static inline double sum(const reg a)
+		{
+			double t[8];
+			_mm512_storeu_pd(t, a);
+			return ((t[0] + t[4]) + (t[2] + t[6])) + ((t[1] + t[5]) + (t[3] + t[7]));
+		}
+	};
+#  elif defined(_FHP_POLYEVAL_AVX2_)
+	struct simd_double
+	{
+		typedef __m256d reg;
+		enum { width = 4 };
+		static inline reg set1(const double x) { return _mm256_set1_pd(x); }
+		static inline reg load(const double* p) { return _mm256_loadu_pd(p); }
+		static inline void store(double* p, const reg r) { _mm256_storeu_pd(p, r); }
+		static inline reg fmadd(const reg a, const reg b, const reg c) { return _mm256_fmadd_pd(a, b, c); }
+		static inline reg add(const reg a, const reg b) { return _mm256_add_pd(a, b); }
+		static inline reg sub(const reg a, const reg b) { return _mm256_sub_pd(a, b); }
+		static inline reg mul(const reg a, const reg b) { return _mm256_mul_pd(a, b); }
+		static inline reg div(const reg a, const reg b) { return _mm256_div_pd(a, b); }
+		static inline reg abs(const reg a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+		static inline reg prod_error(const reg a, const reg b, const reg p) { return _mm256_fmsub_pd(a, b, p); }
+		static inline double sum(const reg a)
+		{
+			const __m128d h = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+			return _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+		}
+	};
+#  else
+	struct simd_double
+	{
+		typedef __m128d reg;
+		enum { width = 2 };
+		static inline reg set1(const double x) { return _mm_set1_pd(x); }
+		static inline reg load(const double* p) { return _mm_loadu_pd(p); }
+		static inline void store(double* p, const reg r) { _mm_storeu_pd(p, r); }
+		static inline reg fmadd(const reg a, const reg b, const reg c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+		static inline reg add(const reg a, const reg b) { return _mm_add_pd(a, b); }
+		static inline reg sub(const reg a, const reg b) { return _mm_sub_pd(a, b); }
+		static inline reg mul(const reg a, const reg b) { return _mm_mul_pd(a, b); }
+		static inline reg div(const reg a, const reg b) { return _mm_div_pd(a, b); }
+		static inline reg abs(const reg a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+		/** Dekker's product on Veltkamp halves, as eft::two_prod does without a fused multiply-add */
+		static inline reg prod_error(const reg a, const reg b, const reg p)
+		{
+			const reg f = _mm_set1_pd(134217729.0);
+			reg t = mul(f, a);
+			const reg ah = sub(t, sub(t, a)), al = sub(a, ah);
+			t = mul(f, b);
+			const reg bh = sub(t, sub(t, b)), bl = sub(b, bh);
+			return add(add(add(sub(mul(ah, bh), p), mul(ah, bl)), mul(al, bh)), mul(al, bl));
+		}
+		static inline double sum(const reg a) { return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a))); }
+	};
+#  endif
+
+	/** Horner over blocks of 2 registers of points; the remainder goes through the generic kernel */
+	inline void horner_simd(const double* c, const std::size_t nc, const double* xs, double* ys, const std::size_t n)
+	{
+		typedef simd_double v;
+		const std::size_t w = v::width;
+		std::size_t k = 0;
+		for (; k + 2 * w <= n; k += 2 * w)
+		{
+			const v::reg x0 = v::load(xs + k), x1 = v::load(xs + k + w);
+			v::reg r0 = v::set1(c[nc - 1]), r1 = r0;
+			for (std::size_t i = nc - 1; i-- > 0;)
+			{
+				const v::reg ci = v::set1(c[i]);
+				r0 = v::fmadd(r0, x0, ci);
+				r1 = v::fmadd(r1, x1, ci);
+			}
+			v::store(ys + k, r0);
+			v::store(ys + k + w, r1);
+		}
+		horner(c, nc, xs + k, ys + k, n - k);
+	}
+
+	/** p and p' over blocks of 2 registers of points */
+	inline void horner_derivative_simd(const double* c, const std::size_t nc, const double* xs, double* ys, double* dys, const std::size_t n)
+	{
+		typedef simd_double v;
+		const std::size_t w = v::width;
+		std::size_t k = 0;
+		for (; k + 2 * w <= n; k += 2 * w)
+		{
+			const v::reg x0 = v::load(xs + k), x1 = v::load(xs + k + w);
+			v::reg r0 = v::set1(c[nc - 1]), r1 = r0;
+			v::reg d0 = v::set1(0.0), d1 = d0;
+			for (std::size_t i = nc - 1; i-- > 0;)
+			{
+				const v::reg ci = v::set1(c[i]);
+				d0 = v::fmadd(d0, x0, r0);
+				d1 = v::fmadd(d1, x1, r1);
+				r0 = v::fmadd(r0, x0, ci);
+				r1 = v::fmadd(r1, x1, ci);
+			}
+			if (ys)
+			{
+				v::store(ys + k, r0);
+				v::store(ys + k + w, r1);
+			}
+			if (dys)
+			{
+				v::store(dys + k, d0);
+				v::store(dys + k + w, d1);
+			}
+		}
+		horner_derivative(c, nc, xs + k, (ys) ? (ys + k) : (ys), (dys) ? (dys + k) : (dys), n - k);
+	}
+#endif
+
+
+	/// single-point schemes with shorter dependency chains than Horner
+	enum class scheme { horner, second_order_horner, estrin, automatic };
+
+	/** degree from which scheme::automatic switches from Horner to Estrin */
+	inline unsigned int& estrin_threshold() { static unsigned int t = 12; return t; }
+
+	/** coefficient sources: the coefficients themselves, or those of the first derivative (i+1)*c[i+1] */
+	template <typename _ty> struct coefficients
+	{
+		const _ty* c;
+		inline _ty operator[](const std::size_t i) const { return c[i]; }
+	};
+	template <typename _ty> struct derivative_coefficients
+	{
+		const _ty* c;
+		inline _ty operator[](const std::size_t i) const { return _ty(i + 1) * c[i + 1]; }
+	};
+
+	template <typename _ty, typename _src> inline _ty horner_at(const _src& c, const std::size_t n, const _ty x)
+	{
+		_ty r = c[n - 1];
+		for (std::size_t i = n - 1; i-- > 0;)
+			r = r * x + c[i];
+		return r;
+	}
+
+	/** even and odd coefficients as two independent Horner chains in x^2 */
+	template <typename _ty, typename _src> inline _ty second_order_horner_at(const _src& c, const std::size_t n, const _ty x)
+	{
+		if (n < 2)
+			return c[0];
+		const _ty x2 = x * x;
+		std::size_t ie = (n - 1) & ~std::size_t(1), io = ((n - 2) | std::size_t(1));
+		_ty re = c[ie], ro = c[io];
+		while (ie >= 2)
+		{
+			ie -= 2;
+			re = re * x2 + c[ie];
+			if (io >= 3)
+			{
+				io -= 2;
+				ro = ro * x2 + c[io];
+			}
+		}
+		return re + x * ro;
+	}
+
+	/** eight coefficients starting at lo, Estrin style: three multiply-add levels deep */
+	template <typename _ty, typename _src> inline _ty estrin8(const _src& c, const std::size_t lo, const _ty x, const _ty x2, const _ty x4)
+	{
+		return ((c[lo] + c[lo + 1] * x) + (c[lo + 2] + c[lo + 3] * x) * x2) + ((c[lo + 4] + c[lo + 5] * x) + (c[lo + 6] + c[lo + 7] * x) * x2) * x4;
+	}
+	/** up to 512 coefficients starting at lo: blocks of eight, combined pairwise in x^8, x^16, ... */
+	template <typename _ty, typename _src> inline _ty estrin_tree(const _src& c, const std::size_t lo, const std::size_t n, const _ty x, const _ty x2, const _ty x4, const _ty x8)
+	{
+		_ty b[64];
+		std::size_t nb = n / 8;
+		for (std::size_t i = 0; i < nb; ++i)
+			b[i] = estrin8(c, lo + 8 * i, x, x2, x4);
+		if (n % 8 != 0)
+		{
+			// short tail block
+			std::size_t i = n;
+			_ty r = c[lo + --i];
+			while (i > 8 * nb)
+				r = r * x + c[lo + --i];
+			b[nb++] = r;
+		}
+		_ty pw = x8;
+		while (nb > 1)
+		{
+			for (std::size_t i = 0; i < nb / 2; ++i)
+				b[i] = b[2 * i] + b[2 * i + 1] * pw;
+			if (nb % 2 != 0)
+				b[nb / 2] = b[nb - 1];
+			nb = (nb + 1) / 2;
+			pw = pw * pw;
+		}
+		return b[0];
+	}
+	/** Estrin's scheme: the powers x^2, x^4, x^8 are computed once, the tree depth is logarithmic in the degree (up to 512 coefficients; longer ones are chained in x^512) */
+	template <typename _ty, typename _src> inline _ty estrin_at(const _src& c, const std::size_t n, const _ty x)
+	{
+		const _ty x2 = x * x, x4 = x2 * x2, x8 = x4 * x4;
+		if (n <= 512)
+			return estrin_tree(c, 0, n, x, x2, x4, x8);
+		_ty x512 = x8;
+		for (unsigned int k = 0; k < 6; ++k)
+			x512 = x512 * x512;
+		std::size_t lo = ((n - 1) / 512) * 512;
+		_ty r = estrin_tree(c, lo, n - lo, x, x2, x4, x8);
+		while (lo > 0)
+		{
+			lo -= 512;
+			r = r * x512 + estrin_tree(c, lo, 512, x, x2, x4, x8);
+		}
+		return r;
+	}
+
+	/** value of the polynomial with coefficient source c (n >= 1 coefficients) at x, using scheme s */
+	template <typename _ty, typename _src> inline _ty evaluate_at(const _src& c, const std::size_t n, const _ty x, const scheme s)
+	{
+		switch (s)
+		{
+		case scheme::second_order_horner:
+			return second_order_horner_at(c, n, x);
+		case scheme::estrin:
+			return estrin_at(c, n, x);
+		case scheme::automatic:
+			return (n > estrin_threshold()) ? (estrin_at(c, n, x)) : (horner_at(c, n, x));
+		default:
+			return horner_at(c, n, x);
+		}
+	}
+
+
+	/** res[j] = p^(j)(x) for j <= k in one pass: the Taylor coefficients at x by repeated synthetic division, then scaled by j! */
+	template <typename _ty> inline void derivatives_at(const _ty* c, const std::size_t nc, const _ty x, _ty* res, const std::size_t k)
+	{
+		for (std::size_t j = 0; j <= k; ++j)
+			res[j] = _ty(0);
+		if (nc == 0)
+			return;
+		res[0] = c[nc - 1];
+		for (std::size_t i = nc - 1; i-- > 0;)
+		{
+			const std::size_t top = (k < nc - 1 - i) ? (k) : (nc - 1 - i);
+			for (std::size_t j = top; j > 0; --j)
+				res[j] = res[j] * x + res[j - 1];
+			res[0] = res[0] * x + c[i];
+		}
+		_ty f = _ty(1);
+		for (std::size_t j = 2; j <= k; ++j)
+		{
+			f *= _ty(j);
+			res[j] *= f;
+		}
+	}
+
+
+	/// compensated Horner for double (Graillat, Langlois and Louvet)
+	/**
+	 * two_prod and two_sum split off the rounding error of every step exactly; the errors are evaluated as a second
+	 * polynomial and added at the end, so the result is as accurate as Horner in twice the working precision. The
+	 * magnitudes of the same errors give an a-posteriori bound on what is left, valid as long as nothing underflows.
+	 * This needs double rounding to double: x87 builds without SSE2 do not qualify.
+	 */
+
+	/** gamma_k = k*u/(1 - k*u), the relative error of k roundings with unit roundoff u = 2^-53 */
+	inline double gamma(const std::size_t k)
+	{
+		const double u = 0.5 * std::numeric_limits<double>::epsilon();
+		return (double(k) * u) / (1.0 - double(k) * u);
+	}
+
+	/** bound on |r - p(x)| for the compensated result r, b the Horner sum of the error magnitudes, k roundings per term */
+	inline double compensated_bound(const double r, const double b, const std::size_t k)
+	{
+		const double u = 0.5 * std::numeric_limits<double>::epsilon();
+		return (u * std::fabs(r) + (gamma(k) * b + 2.0 * u * u * std::fabs(r))) / (1.0 - 2.0 * u);
+	}
+
+	/** one step s = s*x + c: the rounding errors go into the correction e, their magnitudes into b (ax = |x|) */
+	inline void compensated_step(double& s, double& e, double& b, const double x, const double ax, const double c)
+	{
+		double pe, se;
+		const double p = eft::two_prod(s, x, pe);
+		s = eft::two_sum(p, c, se);
+		e = e * x + (pe + se);
+		b = b * ax + (std::fabs(pe) + std::fabs(se));
+	}
+
+	/** p(x) by compensated Horner; *bound, if given, gets a bound on the error of the result */
+	inline double compensated_horner(const double* c, const std::size_t nc, const double x, double* bound = nullptr)
+	{
+		if (nc == 0)
+		{
+			if (bound)
+				*bound = 0.0;
+			return 0.0;
+		}
+		const double ax = std::fabs(x);
+		double s = c[nc - 1], e = 0.0, b = 0.0;
+		for (std::size_t i = nc - 1; i-- > 0;)
+			compensated_step(s, e, b, x, ax, c[i]);
+		const double r = s + e;
+		if (bound)
+			*bound = compensated_bound(r, b, 4 * (nc - 1) + 2);
+		return r;
+	}
+
+	/**
+	 * p'(x) by compensated Horner: the derivative chain d = d*x + s is split the same way, and its correction also
+	 * takes the correction of s.
+	 *
+	 * The bound, with n = nc - 1 steps: d + (pe + se) = p + s exactly at every step, and s differs from the exact
+	 * Horner value by the error that e approximates, so p'(x) = d + DE where DE runs the recurrence of de in exact
+	 * arithmetic with the exact error of s in place of e. An error split off the value chain at step j reaches de
+	 * at a later step i: two roundings entering e, two per step in e until i, two joining de ((pe + se) + e and the
+	 * sum), two per remaining step, 2(n - j) + 2 <= 2n for j >= 1. An error of the derivative chain takes three
+	 * roundings to enter de and two per remaining step, at most 2n + 1. Every term of |de - DE| is thus covered by
+	 * gamma(2n + 1) times its magnitude, and db computes the sum of those magnitudes through the same number of
+	 * roundings. compensated_horner has paths of at most 2n roundings and counts 4n + 2; the same argument on
+	 * paths of 2n + 1 gives 4n + 4.
+	 */
+	inline double compensated_horner_derivative(const double* c, const std::size_t nc, const double x, double* bound = nullptr)
+	{
+		if (nc < 2)
+		{
+			if (bound)
+				*bound = 0.0;
+			return 0.0;
+		}
+		const double ax = std::fabs(x);
+		double s = c[nc - 1], e = 0.0, b = 0.0;
+		double d = 0.0, de = 0.0, db = 0.0;
+		for (std::size_t i = nc - 1; i-- > 0;)
+		{
+			double pe, se;
+			const double p = eft::two_prod(d, x, pe);
+			d = eft::two_sum(p, s, se);
+			de = de * x + ((pe + se) + e);
+			db = db * ax + ((std::fabs(pe) + std::fabs(se)) + b);
+			compensated_step(s, e, b, x, ax, c[i]);
+		}
+		const double r = d + de;
+		if (bound)
+			*bound = compensated_bound(r, db, 4 * (nc - 1) + 4);
+		return r;
+	}
+
+	/**
+	 * p(x) by compensated Horner for complex double coefficients and x (std::complex or Complex): the real and
+	 * imaginary parts of every product and sum are split componentwise, eight errors per step. The bound counts
+	 * twice the roundings of the real case, which covers the complex product in the correction.
+	 */
+	template <typename _cty> inline _cty compensated_horner(const _cty* c, const std::size_t nc, const _cty x, double* bound = nullptr)
+	{
+		if (nc == 0)
+		{
+			if (bound)
+				*bound = 0.0;
+			return _cty(0);
+		}
+		const double xr = x.real(), xi = x.imag(), ax = std::hypot(xr, xi);
+		double sr = c[nc - 1].real(), si = c[nc - 1].imag();
+		_cty e = _cty(0);
+		double b = 0.0;
+		for (std::size_t i = nc - 1; i-- > 0;)
+		{
+			double e1, e2, e3, e4, e5, e6, e7, e8;
+			const double p1 = eft::two_prod(sr, xr, e1), p2 = eft::two_prod(si, xi, e2);
+			const double p3 = eft::two_prod(sr, xi, e3), p4 = eft::two_prod(si, xr, e4);
+			sr = eft::two_sum(eft::two_sum(p1, -p2, e5), c[i].real(), e7);
+			si = eft::two_sum(eft::two_sum(p3, p4, e6), c[i].imag(), e8);
+			e = e * x + _cty(((e1 - e2) + (e5 + e7)), ((e3 + e4) + (e6 + e8)));
+			b = b * ax + (((std::fabs(e1) + std::fabs(e2)) + (std::fabs(e5) + std::fabs(e7))) + ((std::fabs(e3) + std::fabs(e4)) + (std::fabs(e6) + std::fabs(e8))));
+		}
+		const _cty r = _cty(sr, si) + e;
+		if (bound)
+			*bound = compensated_bound(std::hypot(r.real(), r.imag()), b, 8 * (nc - 1) + 4);
+		return r;
+	}
+
+	/** ys[k] = p(xs[k]) by compensated Horner for k < n, and bounds[k] its error bound if bounds is not null; four interleaved chains */
+	inline void compensated_horner(const double* c, const std::size_t nc, const double* xs, double* ys, const std::size_t n, double* bounds = nullptr)
+	{
+		std::size_t k = 0;
+		for (; nc > 0 && k + 4 <= n; k += 4)
+		{
+			double x[4], ax[4], s[4], e[4], b[4];
+			for (unsigned int j = 0; j < 4; ++j)
+			{
+				x[j] = xs[k + j];
+				ax[j] = std::fabs(x[j]);
+				s[j] = c[nc - 1];
+				e[j] = b[j] = 0.0;
+			}
+			for (std::size_t i = nc - 1; i-- > 0;)
+				for (unsigned int j = 0; j < 4; ++j)
+					compensated_step(s[j], e[j], b[j], x[j], ax[j], c[i]);
+			for (unsigned int j = 0; j < 4; ++j)
+			{
+				ys[k + j] = s[j] + e[j];
+				if (bounds)
+					bounds[k + j] = compensated_bound(ys[k + j], b[j], 4 * (nc - 1) + 2);
+			}
+		}
+		for (; k < n; ++k)
+			ys[k] = compensated_horner(c, nc, xs[k], (bounds) ? (bounds + k) : (bounds));
+	}
+
+#ifdef _FHP_POLYEVAL_SIMD_
+	/** compensated Horner over blocks of 2 registers of points, with the splits done lane by lane */
+	inline void compensated_horner_simd(const double* c, const std::size_t nc, const double* xs, double* ys, const std::size_t n, double* bounds = nullptr)
+	{
+		typedef simd_double v;
+		const std::size_t w = v::width;
+		std::size_t k = 0;
+		for (; nc > 0 && k + 2 * w <= n; k += 2 * w)
+		{
+			const v::reg x0 = v::load(xs + k), x1 = v::load(xs + k + w);
+			const v::reg ax0 = v::abs(x0), ax1 = v::abs(x1);
+			v::reg s0 = v::set1(c[nc - 1]), s1 = s0;
+			v::reg e0 = v::set1(0.0), e1 = e0, b0 = e0, b1 = e0;
+			for (std::size_t i = nc - 1; i-- > 0;)
+			{
+				const v::reg ci = v::set1(c[i]);
+				const v::reg p0 = v::mul(s0, x0), p1 = v::mul(s1, x1);
+				const v::reg pe0 = v::prod_error(s0, x0, p0), pe1 = v::prod_error(s1, x1, p1);
+				s0 = v::add(p0, ci);
+				s1 = v::add(p1, ci);
+				const v::reg t0 = v::sub(s0, p0), t1 = v::sub(s1, p1);
+				const v::reg se0 = v::add(v::sub(p0, v::sub(s0, t0)), v::sub(ci, t0));
+				const v::reg se1 = v::add(v::sub(p1, v::sub(s1, t1)), v::sub(ci, t1));
+				e0 = v::fmadd(e0, x0, v::add(pe0, se0));
+				e1 = v::fmadd(e1, x1, v::add(pe1, se1));
+				b0 = v::fmadd(b0, ax0, v::add(v::abs(pe0), v::abs(se0)));
+				b1 = v::fmadd(b1, ax1, v::add(v::abs(pe1), v::abs(se1)));
+			}
+			v::store(ys + k, v::add(s0, e0));
+			v::store(ys + k + w, v::add(s1, e1));
+			if (bounds)
+			{
+				v::store(bounds + k, b0);
+				v::store(bounds + k + w, b1);
+				for (std::size_t j = k; j < k + 2 * w; ++j)
+					bounds[j] = compensated_bound(ys[j], bounds[j], 4 * (nc - 1) + 2);
+			}
+		}
+		compensated_horner(c, nc, xs + k, ys + k, n - k, (bounds) ? (bounds + k) : (bounds));
+	}
+#endif
+
+	/** ys[k] = p(xs[k]) by compensated Horner for k < n, through the vector kernel when available; bounds may be null */
+	inline void evaluate_compensated(const double* c, const std::size_t nc, const double* xs, double* ys, const std::size_t n, double* bounds = nullptr)
+	{
+#ifdef _FHP_POLYEVAL_SIMD_
+		compensated_horner_simd(c, nc, xs, ys, n, bounds);
+#else
+		compensated_horner(c, nc, xs, ys, n, bounds);
+#endif
+	}
+
+
+	/// dispatch: double goes through the vector kernels when available
+	template <typename _ty> inline void evaluate(const _ty* c, const std::size_t nc, const _ty* xs, _ty* ys, const std::size_t n, const std::false_type&)
+	{
+		horner(c, nc, xs, ys, n);
+	}
+	template <typename _ty> inline void evaluate_derivative(const _ty* c, const std::size_t nc, const _ty* xs, _ty* ys, _ty* dys, const std::size_t n, const std::false_type&)
+	{
+		horner_derivative(c, nc, xs, ys, dys, n);
+	}
+#ifdef _FHP_POLYEVAL_SIMD_
+	inline void evaluate(const double* c, const std::size_t nc, const double* xs, double* ys, const std::size_t n, const std::true_type&)
+	{
+		horner_simd(c, nc, xs, ys, n);
+	}
+	inline void evaluate_derivative(const double* c, const std::size_t nc, const double* xs, double* ys, double* dys, const std::size_t n, const std::true_type&)
+	{
+		horner_derivative_simd(c, nc, xs, ys, dys, n);
+	}
+	template <typename _ty> struct use_simd : std::is_same<_ty, double> {};
+#else
+	template <typename _ty> struct use_simd : std::false_type {};
+#endif
+
+	/** ys[k] = p(xs[k]) for k < n, picking the widest kernel for _ty */
+	template <typename _ty> inline void evaluate(const _ty* c, const std::size_t nc, const _ty* xs, _ty* ys, const std::size_t n)
+	{
+		if (nc == 0)
+		{
+			for (std::size_t k = 0; k < n; ++k)
+				ys[k] = _ty(0);
+			return;
+		}
+		evaluate(c, nc, xs, ys, n, use_simd<_ty>());
+	}
+	/** ys[k] = p(xs[k]) and dys[k] = p'(xs[k]) for k < n; either output may be null */
+	template <typename _ty> inline void evaluate_derivative(const _ty* c, const std::size_t nc, const _ty* xs, _ty* ys, _ty* dys, const std::size_t n)
+	{
+		if (nc == 0)
+		{
+			for (std::size_t k = 0; k < n; ++k)
+			{
+				if (ys)
+					ys[k] = _ty(0);
+				if (dys)
+					dys[k] = _ty(0);
+			}
+			return;
+		}
+		evaluate_derivative(c, nc, xs, ys, dys, n, use_simd<_ty>());
+	}
+
+}
+
+#endif
@@ -0,0 +1,213 @@
+#ifndef _FHP_TPOLYEXPR_HPP_INCLUDED_
+#define _FHP_TPOLYEXPR_HPP_INCLUDED_
+
+#include <cstddef>
+#include <type_traits>
+#include <memory>
+#include <utility>
+
+/** the allocator's default lives here, with the first declaration */
+template <typename _ty, typename _alloc = std::allocator<_ty>> class Polynomial;
+
+
+/**
+ * Lazy expression templates for linear combinations, scaling and differentiation of Polynomials. The operators of
+ * Polynomial itself stay eager; an expression starts at lazy(p) or derivative(p), and everything combined with it
+ * is lazy too: lazy(p)*a + q - derivative(r)*b builds a small tree of nodes, and assigning it to a Polynomial runs
+ * one fused loop over the coefficients into a single allocation. A Polynomial passed as an lvalue is referred to,
+ * and read only when the expression is evaluated, so `auto e = lazy(p)*2.0;` sees later changes to p and must not
+ * outlive it; a temporary Polynomial is moved into the expression. Expressions can also be evaluated at a point and
+ * report their degree; for anything else, construct a Polynomial from them.
+ */
+namespace polyexpr
+{
+
+	/** base of all expression nodes (CRTP); an expression has value_type, size() and operator[](i), which is 0 for i >= size() */
+	template <typename _ex> struct expression
+	{
+		inline const _ex& self() const { return static_cast<const _ex&>(*this); }
+		/** as Polynomial::degree(), size() - 1 */
+		inline int degree() const { return int(self().size()) - 1; }
+		/** the value at x by Horner's scheme, without materialising the coefficients */
+		template <typename aux, typename _ey = _ex> inline auto operator()(const aux x) const -> typename _ey::value_type
+		{
+			typedef typename _ey::value_type value_type;
+			const _ex& e = self();
+			const value_type xv = value_type(x);
+			value_type res = value_type(0);
+			for (std::size_t i = e.size(); i-- > 0;)
+				res = res * xv + e[i];
+			return res;
+		}
+	};
+
+	template <typename _ty> struct is_expression : std::is_base_of<expression<_ty>, _ty> {};
+	/** anything that can take part in an expression: expression nodes and Polynomials (cv and reference qualifiers are ignored) */
+	template <typename _ty> struct is_operand_type : is_expression<_ty> {};
+	template <typename _ty, typename _alloc> struct is_operand_type<Polynomial<_ty, _alloc>> : std::true_type {};
+	template <typename _ty> struct is_operand : is_operand_type<typename std::decay<_ty>::type> {};
+
+
+	/// nodes
+	/** the coefficients of a Polynomial that lives elsewhere */
+	template <typename _ty, typename _alloc> struct terminal : expression<terminal<_ty, _alloc>>
+	{
+		typedef _ty value_type;
+		const Polynomial<_ty, _alloc>* p;
+		inline explicit terminal(const Polynomial<_ty, _alloc>& pol) : p(&pol) {}
+		inline std::size_t size() const { return p->coefficients().size(); }
+		inline _ty operator[](const std::size_t i) const { return (i < p->coefficients().size()) ? (p->coefficients()[i]) : (_ty(0)); }
+	};
+
+	/** the coefficients of a temporary Polynomial, moved into the expression */
+	template <typename _ty, typename _alloc> struct owned : expression<owned<_ty, _alloc>>
+	{
+		typedef _ty value_type;
+		Polynomial<_ty, _alloc> p;
+		inline explicit owned(Polynomial<_ty, _alloc>&& pol) : p(std::move(pol)) {}
+		inline std::size_t size() const { return p.coefficients().size(); }
+		inline _ty operator[](const std::size_t i) const { return (i < p.coefficients().size()) ? (p.coefficients()[i]) : (_ty(0)); }
+	};
+
+	/** l + r, or l - r if subtract */
+	template <typename _l, typename _r, bool subtract> struct sum : expression<sum<_l, _r, subtract>>
+	{
+		typedef typename _l::value_type value_type;
+		_l l;
+		_r r;
+		inline sum(_l a, _r b) : l(std::move(a)), r(std::move(b)) {}
+		inline std::size_t size() const { return (l.size() > r.size()) ? (l.size()) : (r.size()); }
+		inline value_type operator[](const std::size_t i) const { return (subtract) ? (l[i] - r[i]) : (l[i] + r[i]); }
+	};
+
+	/** e * s for a scalar s, or e / s if divide (coefficient by coefficient, so integer types divide as they do) */
+	template <typename _e, bool divide> struct scaled : expression<scaled<_e, divide>>
+	{
+		typedef typename _e::value_type value_type;
+		_e e;
+		value_type s;
+		inline scaled(_e a, const value_type& b) : e(std::move(a)), s(b) {}
+		inline std::size_t size() const { return e.size(); }
+		inline value_type operator[](const std::size_t i) const { return (divide) ? (e[i] / s) : (e[i] * s); }
+	};
+
+	/** -e */
+	template <typename _e> struct negated : expression<negated<_e>>
+	{
+		typedef typename _e::value_type value_type;
+		_e e;
+		inline explicit negated(_e a) : e(std::move(a)) {}
+		inline std::size_t size() const { return e.size(); }
+		inline value_type operator[](const std::size_t i) const { return -e[i]; }
+	};
+
+	/** e', coefficient i being (i+1)*e[i+1] */
+	template <typename _e> struct differentiated : expression<differentiated<_e>>
+	{
+		typedef typename _e::value_type value_type;
+		_e e;
+		inline explicit differentiated(_e a) : e(std::move(a)) {}
+		inline std::size_t size() const { return (e.size() > 1) ? (e.size() - 1) : (1); }
+		inline value_type operator[](const std::size_t i) const { return e[i + 1] * value_type(i + 1); }
+	};
+
+
+	/// operands are stored by value: nodes as they are, Polynomials as terminals, temporary Polynomials as owned
+	template <typename _ty, typename _alloc> inline terminal<_ty, _alloc> wrap(const Polynomial<_ty, _alloc>& p)
+	{
+		return terminal<_ty, _alloc>(p);
+	}
+	template <typename _ty, typename _alloc> inline owned<_ty, _alloc> wrap(Polynomial<_ty, _alloc>&& p)
+	{
+		return owned<_ty, _alloc>(std::move(p));
+	}
+	template <typename _ty, typename _alloc> inline owned<_ty, _alloc> wrap(const Polynomial<_ty, _alloc>&& p)
+	{
+		return owned<_ty, _alloc>(Polynomial<_ty, _alloc>(p));
+	}
+	template <typename _ex> inline _ex wrap(const expression<_ex>& e)
+	{
+		return e.self();
+	}
+	template <typename _ex> inline _ex wrap(expression<_ex>&& e)
+	{
+		return std::move(static_cast<_ex&>(e));
+	}
+	/** the node that stores an operand passed as _ty&& (_ty deduced by a forwarding reference); no type for non-operands */
+	template <typename _ty, bool = is_operand<_ty>::value> struct operand {};
+	template <typename _ty> struct operand<_ty, true>
+	{
+		typedef decltype(wrap(std::declval<_ty>())) type;
+	};
+
+	template <typename _ty> struct is_lazy : is_expression<typename std::decay<_ty>::type> {};
+	/** two operands of which at least one is an expression node; two Polynomials use the eager operators of Polynomial */
+	template <typename _l, typename _r> struct lazy_operands : std::integral_constant<bool, is_operand<_l>::value && is_operand<_r>::value && (is_lazy<_l>::value || is_lazy<_r>::value)> {};
+	/** an expression node and a scalar that converts to its coefficient type */
+	template <typename _e, typename _s, bool = is_lazy<_e>::value && !is_operand<_s>::value> struct lazy_and_scalar : std::false_type {};
+	template <typename _e, typename _s> struct lazy_and_scalar<_e, _s, true> : std::is_convertible<typename std::decay<_s>::type, typename std::decay<_e>::type::value_type> {};
+
+	/** writes the coefficients of e into res[0..e.size()-1], in increasing order */
+	template <typename _e, typename _ty> inline void assign(const _e& e, _ty* res, const std::size_t n)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			res[i] = e[i];
+	}
+
+}
+
+
+template <typename _l, typename _r> inline typename std::enable_if<polyexpr::lazy_operands<_l, _r>::value, polyexpr::sum<typename polyexpr::operand<_l>::type, typename polyexpr::operand<_r>::type, false>>::type
+operator+(_l&& l, _r&& r)
+{
+	return polyexpr::sum<typename polyexpr::operand<_l>::type, typename polyexpr::operand<_r>::type, false>(polyexpr::wrap(std::forward<_l>(l)), polyexpr::wrap(std::forward<_r>(r)));
+}
+template <typename _l, typename _r> inline typename std::enable_if<polyexpr::lazy_operands<_l, _r>::value, polyexpr::sum<typename polyexpr::operand<_l>::type, typename polyexpr::operand<_r>::type, true>>::type
+operator-(_l&& l, _r&& r)
+{
+	return polyexpr::sum<typename polyexpr::operand<_l>::type, typename polyexpr::operand<_r>::type, true>(polyexpr::wrap(std::forward<_l>(l)), polyexpr::wrap(std::forward<_r>(r)));
+}
+template <typename _e> inline typename std::enable_if<polyexpr::is_lazy<_e>::value, polyexpr::negated<typename polyexpr::operand<_e>::type>>::type
+operator-(_e&& e)
+{
+	return polyexpr::negated<typename polyexpr::operand<_e>::type>(polyexpr::wrap(std::forward<_e>(e)));
+}
+template <typename _e, typename _s> inline typename std::enable_if<polyexpr::lazy_and_scalar<_e, _s>::value, polyexpr::scaled<typename polyexpr::operand<_e>::type, false>>::type
+operator*(_e&& e, const _s& s)
+{
+	typedef typename polyexpr::operand<_e>::type node;
+	return polyexpr::scaled<node, false>(polyexpr::wrap(std::forward<_e>(e)), typename node::value_type(s));
+}
+template <typename _s, typename _e> inline typename std::enable_if<polyexpr::lazy_and_scalar<_e, _s>::value, polyexpr::scaled<typename polyexpr::operand<_e>::type, false>>::type
+operator*(const _s& s, _e&& e)
+{
+	typedef typename polyexpr::operand<_e>::type node;
+	return polyexpr::scaled<node, false>(polyexpr::wrap(std::forward<_e>(e)), typename node::value_type(s));
+}
+template <typename _e, typename _s> inline typename std::enable_if<polyexpr::lazy_and_scalar<_e, _s>::value, polyexpr::scaled<typename polyexpr::operand<_e>::type, true>>::type
+operator/(_e&& e, const _s& s)
+{
+	typedef typename polyexpr::operand<_e>::type node;
+	return polyexpr::scaled<node, true>(polyexpr::wrap(std::forward<_e>(e)), typename node::value_type(s));
+}
+/** product of two operands that are not both Polynomials (those use Polynomial::operator*): evaluated eagerly */
+template <typename _l, typename _r> inline typename std::enable_if<polyexpr::lazy_operands<_l, _r>::value, Polynomial<typename polyexpr::operand<_l>::type::value_type>>::type
+operator*(_l&& l, _r&& r)
+{
+	typedef Polynomial<typename polyexpr::operand<_l>::type::value_type> result;
+	return result(polyexpr::wrap(std::forward<_l>(l))) * result(polyexpr::wrap(std::forward<_r>(r)));
+}
+/** a Polynomial (or an expression) as the start of a lazy expression */
+template <typename _e> inline typename std::enable_if<polyexpr::is_operand<_e>::value, typename polyexpr::operand<_e>::type>::type
+lazy(_e&& e)
+{
+	return polyexpr::wrap(std::forward<_e>(e));
+}
+/** lazy first derivative of a Polynomial or an expression (Polynomial::derivative() is the eager one) */
+template <typename _e> inline typename std::enable_if<polyexpr::is_operand<_e>::value, polyexpr::differentiated<typename polyexpr::operand<_e>::type>>::type
+derivative(_e&& e)
+{
+	return polyexpr::differentiated<typename polyexpr::operand<_e>::type>(polyexpr::wrap(std::forward<_e>(e)));
+}
+
+#endif
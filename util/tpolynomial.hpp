@@ -26,8 +26,15 @@
 #endif
 
 #include <initializer_list>
+#include <cmath>
 #include <vector>
+#include <memory>
 #include "sfinae.hpp"
+#include "tconvolution.hpp"
+#include "tpolyeval.hpp"
+#include "tparallel.hpp"
+#include "tpolyexpr.hpp"
+#include "tsmallvector.hpp"
 
 #if _STD_OSTREAM_INCLUDED_
 template <typename _ty>
@@ -51,205 +58,283 @@ inline std::ostream& ostream_lshift(std::ostream& ostr, const _ty t, const unsig
 
 
 
-template <typename _ty> class Polynomial
+/** number of coefficients a Polynomial keeps inside the object before it allocates */
+#ifndef _FHP_POLYNOMIAL_INLINE_
+#  define _FHP_POLYNOMIAL_INLINE_ 8
+#endif
+
+/**
+ * dense polynomial sum coef[i]*x^i; coefficients beyond the inline ones are allocated through _alloc, which defaults to
+ * std::allocator<_ty> (declared in util/tpolyexpr.hpp). memory::arena_allocator (util/tarena.hpp) puts batches of
+ * short-lived polynomials into an arena that is released at once.
+ */
+template <typename _ty, typename _alloc> class Polynomial
 {
+public:
+	typedef _alloc allocator_type;
+	/** coefficient storage: up to _FHP_POLYNOMIAL_INLINE_ coefficients inline, more on the heap */
+	typedef SmallVector<_ty, _FHP_POLYNOMIAL_INLINE_, _alloc> storage_type;
+
 protected:
-	std::vector<_ty> coef;
+	storage_type coef;
+
+	/** coef += s*e, s being +1 or -1 */
+	template <typename _ex> inline Polynomial<_ty, _alloc>& accumulate(const _ex& e, const _ty s)
+	{
+		const std::size_t n = e.size();
+		if (n > coef.size())
+		{
+			storage_type res(n, _ty(0), coef.get_allocator());
+			for (std::size_t i = 0; i < n; ++i)
+				res[i] = get_coefficient(i) + s * e[i];
+			coef = std::move(res);
+		}
+		else
+		{
+			for (std::size_t i = 0; i < n; ++i)
+				coef[i] += s * e[i];
+		}
+		return *this;
+	}
 
 public:
 	typedef _ty value_type;
-	typedef typename std::vector<_ty>::const_iterator const_iterator;
-	typedef typename std::vector<_ty>::iterator iterator;
+	typedef typename storage_type::const_iterator const_iterator;
+	typedef typename storage_type::iterator iterator;
 	/** creates a new empty polynomial */
-	inline Polynomial() { coef = std::vector<_ty>(1,0); }
+	inline Polynomial() : coef(1, _ty(0)) {}
+	/** creates a new empty polynomial whose coefficients will be allocated through a */
+	inline explicit Polynomial(const _alloc& a) : coef(1, _ty(0), a) {}
 	/** creates a new polynomial with given coefficients */
-	template <typename aux> inline Polynomial(std::initializer_list<aux> list)
+	template <typename aux> inline Polynomial(std::initializer_list<aux> list, const _alloc& a = _alloc()) : coef(a)
 	{
-		coef = std::vector<_ty>(0);
+		coef.reserve(list.size());
 		for (aux x : list)
 			coef.push_back(_ty(x));
 	}
 	/** creates a new polynomial of i-th degree, and inserts a leading coefficient */
-	inline Polynomial(const unsigned int i, const _ty leading)
+	inline Polynomial(const unsigned int i, const _ty leading, const _alloc& a = _alloc()) : coef(i + 1, _ty(0), a)
 	{
-		coef = std::vector<_ty>(i + 1);
 		coef[i] = leading;
 	}
 	/** creates a new 0th degree polynomial, and inserts a coefficient as the constant value */
-	template <typename aux> inline Polynomial(const aux i)
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial(const aux i, const _alloc& a = _alloc()) : coef(1, _ty(i), a) {}
+	/** copy constructor */
+	inline Polynomial(const Polynomial<_ty, _alloc>& other) : coef(other.coef) {}
+	/** move constructor; the source is left as the zero polynomial */
+	inline Polynomial(Polynomial<_ty, _alloc>&& other) noexcept : coef(std::move(other.coef))
 	{
-		coef = std::vector<_ty>(1);
-		coef[0] = _ty(i);
+		other.coef.assign(1, _ty(0));
 	}
-	/** copy constructor */
-	inline Polynomial(const Polynomial<_ty>& other)
+	/** evaluates an expression of Polynomials (see util/tpolyexpr.hpp) in one loop into one allocation */
+	template <typename _ex> inline Polynomial(const polyexpr::expression<_ex>& e, const _alloc& a = _alloc()) : coef(a)
 	{
-		coef = std::vector<_ty>(other.coef.size());
-		for (unsigned int i = 0; i < coef.size(); ++i)
-			coef[i] = other.coef[i];
+		const _ex& ex = e.self();
+		coef.resize(ex.size());
+		polyexpr::assign(ex, coef.data(), coef.size());
 	}
 	/** destructor */
 	inline ~Polynomial() {}
 
-	template <typename aux> inline Polynomial<aux> cast() const
+	template <typename aux> inline Polynomial<aux, typename std::allocator_traits<_alloc>::template rebind_alloc<aux>> cast() const
 	{
-		Polynomial<aux> res = Polynomial<aux>();
+		typedef typename std::allocator_traits<_alloc>::template rebind_alloc<aux> rebound;
+		Polynomial<aux, rebound> res = Polynomial<aux, rebound>(rebound(coef.get_allocator()));
 		for (unsigned int i = 0; i < coef.size(); ++i)
 			res.set_coefficient(i, _ty(this->get_coefficient(i)));
 		return res;
 	}
 
-	inline Polynomial<_ty>& operator=(const Polynomial<_ty>& other)
+	inline Polynomial<_ty, _alloc>& operator=(const Polynomial<_ty, _alloc>& other)
 	{
-		coef.resize(other.coef.size());
-		for (unsigned int i = 0; i < coef.size(); ++i)
-			coef[i] = other.coef[i];
+		coef = other.coef;
+		return *this;
+	}
+	inline Polynomial<_ty, _alloc>& operator=(Polynomial<_ty, _alloc>&& other) noexcept
+	{
+		if (this != &other)
+		{
+			coef = std::move(other.coef);
+			other.coef.assign(1, _ty(0));
+		}
 		return *this;
 	}
-	template <typename aux> inline Polynomial<_ty>& operator=(std::initializer_list<aux> list)
+	template <typename aux> inline Polynomial<_ty, _alloc>& operator=(std::initializer_list<aux> list)
 	{
 		coef.resize(0);
 		for (aux x : list)
 			coef.push_back(_ty(x));
 		return *this;
 	}
-	template <typename aux> inline Polynomial<_ty>& operator=(const aux scalar)
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc>& operator=(const aux scalar)
 	{
 		coef.resize(1);
 		coef[0] = _ty(scalar);
 		return *this;
 	}
-
-	inline Polynomial<_ty> operator-() const
+	/** evaluates the expression into a new buffer, so it may refer to this polynomial itself */
+	template <typename _ex> inline Polynomial<_ty, _alloc>& operator=(const polyexpr::expression<_ex>& e)
 	{
-		Polynomial<_ty> res = Polynomial<_ty>();
-		for (unsigned int i = 0; i < coef.size(); ++i)
-			res[i] = _ty(-1)*coef[i];
-		return res;
+		const _ex& ex = e.self();
+		storage_type res(ex.size(), _ty(0), coef.get_allocator());
+		polyexpr::assign(ex, res.data(), res.size());
+		coef = std::move(res);
+		return *this;
 	}
 
-	inline Polynomial<_ty>& operator+=(const Polynomial<_ty>& other)
+	/// p += e and p -= e work in place unless p has to grow; an expression reads coefficient i (or above) only for result i, so it may refer to p
+	template <typename _ex> inline Polynomial<_ty, _alloc>& operator+=(const polyexpr::expression<_ex>& e)
 	{
-		for (unsigned int i = 0; i <= other.coef.size(); ++i)
-			this->operator[](i) += other.get_coefficient(i);
-		return *this;
+		return accumulate(e.self(), _ty(1));
 	}
-	template <typename aux> inline Polynomial<_ty>& operator+=(const aux scalar)
+	template <typename _ex> inline Polynomial<_ty, _alloc>& operator-=(const polyexpr::expression<_ex>& e)
+	{
+		return accumulate(e.self(), _ty(-1));
+	}
+	inline Polynomial<_ty, _alloc>& operator+=(const Polynomial<_ty, _alloc>& other)
+	{
+		return accumulate(polyexpr::wrap(other), _ty(1));
+	}
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc>& operator+=(const aux scalar)
 	{
 		this->coef[0] += _ty(scalar);
 		return *this;
 	}
 
-	inline Polynomial<_ty>& operator-=(const Polynomial<_ty>& other)
+	inline Polynomial<_ty, _alloc>& operator-=(const Polynomial<_ty, _alloc>& other)
 	{
-		for (unsigned int i = 0; i < other.coef.size(); ++i)
-			this->operator[](i) -= other.get_coefficient(i);
-		return *this;
+		return accumulate(polyexpr::wrap(other), _ty(-1));
 	}
-	template <typename aux> inline Polynomial<_ty>& operator-=(const aux scalar)
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc>& operator-=(const aux scalar)
 	{
 		this->coef[0] -= _ty(scalar);
 		return *this;
 	}
 
-	template <typename aux> inline Polynomial<_ty>& operator*=(const aux scalar)
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc>& operator*=(const aux scalar)
 	{
 		for (_ty& x : this->coef)
 			x *= _ty(scalar);
 		return *this;
 	}
-	template <typename aux> inline Polynomial<_ty>& operator/=(const aux scalar)
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc>& operator/=(const aux scalar)
 	{
 		for (_ty& x : this->coef)
 			x /= _ty(scalar);
 		return *this;
 	}
 
-	inline Polynomial<_ty>& operator*=(const Polynomial<_ty>& other)
+	inline Polynomial<_ty, _alloc>& operator*=(const Polynomial<_ty, _alloc>& other)
 	{
-		Polynomial<_ty> res = 0;
-		Polynomial<_ty> h;
-		for (unsigned int i = 0; i < other.coef.size(); ++i)
-		{
-			h = 0;
-			for (unsigned int j = 0; j < this->coef.size(); ++j)
-				h[j + i] = this->get_coefficient(j);
-			res += (h *= other.get_coefficient(i));
-		}
-		this->operator=(res);
+		if (coef.size() == 0 || other.coef.size() == 0)
+			return this->operator=(0);
+		storage_type res(coef.size() + other.coef.size() - 1, _ty(0), coef.get_allocator());
+		convolution::multiply(coef.data(), coef.size(), other.coef.data(), other.coef.size(), res.data());
+		coef = std::move(res);
 		return *this;
 	}
 
-	inline Polynomial<_ty> operator+(const Polynomial<_ty>& other) const
+	/// p + q, p - q, -p, p*a and p/a evaluate at once, in one loop into one allocation; lazy(p) makes them build expressions instead (util/tpolyexpr.hpp)
+	inline Polynomial<_ty, _alloc> operator+(const Polynomial<_ty, _alloc>& other) const
 	{
-		Polynomial<_ty> res = *this;
-		for (unsigned int i = 0; i < other.coef.size(); ++i)
-			this->operator[](i) += other.get_coefficient(i);
-		return res;
+		return Polynomial<_ty, _alloc>(polyexpr::wrap(*this) + polyexpr::wrap(other), coef.get_allocator());
 	}
-	template <typename aux> inline Polynomial<_ty> operator+(const aux scalar) const
+	inline Polynomial<_ty, _alloc> operator-(const Polynomial<_ty, _alloc>& other) const
 	{
-		Polynomial<_ty> res = *this;
-		res[0] += _ty(scalar);
-		return res;
+		return Polynomial<_ty, _alloc>(polyexpr::wrap(*this) - polyexpr::wrap(other), coef.get_allocator());
 	}
-
-	inline Polynomial<_ty> operator-(const Polynomial<_ty>& other) const
+	inline Polynomial<_ty, _alloc> operator-() const
 	{
-		Polynomial<_ty> res = *this;
-		for (unsigned int i = 0; i < other.coef.size(); ++i)
-			this->operator[](i) += other.get_coefficient(i);
-		return res;
+		return Polynomial<_ty, _alloc>(-polyexpr::wrap(*this), coef.get_allocator());
 	}
-	template <typename aux> inline Polynomial<_ty> operator-(const aux scalar) const
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc> operator*(const aux scalar) const
 	{
-		Polynomial<_ty> res = *this;
-		res[0] -= _ty(scalar);
-		return res;
+		return Polynomial<_ty, _alloc>(polyexpr::wrap(*this) * _ty(scalar), coef.get_allocator());
 	}
-
-	template <typename aux> inline Polynomial<_ty> operator*(const aux scalar) const
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc> operator/(const aux scalar) const
 	{
-		Polynomial<_ty> res = *this;
-		for (_ty& x : res.coef)
-			x *= _ty(scalar);
+		return Polynomial<_ty, _alloc>(polyexpr::wrap(*this) / _ty(scalar), coef.get_allocator());
+	}
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc> operator+(const aux scalar) const
+	{
+		Polynomial<_ty, _alloc> res = *this;
+		res[0] += _ty(scalar);
 		return res;
 	}
-	template <typename aux> inline Polynomial<_ty> operator/(const aux scalar) const
+	template <typename aux, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value>::type> inline Polynomial<_ty, _alloc> operator-(const aux scalar) const
 	{
-		Polynomial<_ty> res = *this;
-		for (_ty& x : res.coef)
-			x *= _ty(scalar);
+		Polynomial<_ty, _alloc> res = *this;
+		res[0] -= _ty(scalar);
 		return res;
 	}
 
-	inline Polynomial<_ty> operator*(const Polynomial<_ty>& other) const
+	inline Polynomial<_ty, _alloc> operator*(const Polynomial<_ty, _alloc>& other) const
 	{
-		Polynomial<_ty> res = 0;
-		Polynomial<_ty> h;
-		for (unsigned int i = 0; i < other.coef.size(); ++i)
-		{
-			h = 0;
-			for (unsigned int j = 0; j < this->coef.size(); ++j)
-				h[j + i] = this->get_coefficient(j);
-			res += (h *= other.get_coefficient(i));
-		}
+		Polynomial<_ty, _alloc> res(coef.get_allocator());
+		if (coef.size() == 0 || other.coef.size() == 0)
+			return res;
+		res.coef.resize(coef.size() + other.coef.size() - 1);
+		convolution::multiply(coef.data(), coef.size(), other.coef.data(), other.coef.size(), res.coef.data());
 		return res;
 	}
 
 
 	template <typename aux> inline _ty operator()(const aux x) const
 	{
+		const _ty xv = _ty(x);
+		const _ty* c = coef.data();
 		_ty res = _ty(0);
 		for(unsigned int i = coef.size()-1; i > 0; --i)
 		{
 			
-			res += coef[i];
-			res *= _ty(x);
+			res += c[i];
+			res *= xv;
 		}
-		res += coef[0];
+		res += c[0];
 		return res;
 	}
+	/** evaluates the polynomial with the given scheme (Horner, second-order Horner, Estrin, or chosen by degree) */
+	template <typename aux> inline _ty operator()(const aux x, const polyeval::scheme s) const
+	{
+		if (coef.size() == 0)
+			return _ty(0);
+		return polyeval::evaluate_at(polyeval::coefficients<_ty>{ coef.data() }, coef.size(), _ty(x), s);
+	}
+	/** evaluates the polynomial at n points, ys[k] = p(xs[k]); the range is split over the given number of threads (0: one per hardware thread) */
+	inline void evaluate(const _ty* xs, _ty* ys, const std::size_t n, const unsigned int threads = 1) const
+	{
+		const _ty* c = coef.data();
+		const std::size_t nc = coef.size();
+		parallel::for_ranges(n, threads, [=](const std::size_t begin, const std::size_t end)
+		{
+			polyeval::evaluate(c, nc, xs + begin, ys + begin, end - begin);
+		}, 1024);
+	}
+	inline std::vector<_ty> evaluate(const std::vector<_ty>& xs, const unsigned int threads = 1) const
+	{
+		std::vector<_ty> ys(xs.size());
+		evaluate(xs.data(), ys.data(), xs.size(), threads);
+		return ys;
+	}
+	/**
+	 * evaluates the polynomial by compensated Horner, about as accurate as Horner in twice the precision of double;
+	 * *bound, if given, gets an a-posteriori bound on the error of the result. For double and complex double
+	 * coefficients (std::complex or Complex).
+	 */
+	inline _ty compensatedAt(const _ty x, double* bound = nullptr) const
+	{
+		return polyeval::compensated_horner(coef.data(), coef.size(), x, bound);
+	}
+	/** compensated evaluation at n points, ys[k] = p(xs[k]) with the error bounds[k] (bounds may be null); double coefficients only */
+	inline void evaluate_compensated(const _ty* xs, _ty* ys, const std::size_t n, double* bounds = nullptr, const unsigned int threads = 1) const
+	{
+		const _ty* c = coef.data();
+		const std::size_t nc = coef.size();
+		parallel::for_ranges(n, threads, [=](const std::size_t begin, const std::size_t end)
+		{
+			polyeval::evaluate_compensated(c, nc, xs + begin, ys + begin, end - begin, (bounds) ? (bounds + begin) : (bounds));
+		}, 1024);
+	}
 	inline _ty& operator[](const unsigned int i)
 	{
 		if (i >= coef.size())
@@ -258,59 +343,98 @@ public:
 	}
 	inline int degree() const { return coef.size() - 1; }
 
-	inline Polynomial<_ty> derivative(const int n = 1) const
+	inline Polynomial<_ty, _alloc> derivative(const int n = 1) const
 	{
 		if (n == 0)
-			return Polynomial<_ty>(*this);
+			return Polynomial<_ty, _alloc>(*this);
 		else if (n < 0)
 			return integral(-n);
 		else if (n > degree())
-			return Polynomial<_ty>(_ty(0));
-		else if (n == 1)
+			return Polynomial<_ty, _alloc>(_ty(0), coef.get_allocator());
+		// c'[i] = c[i+n] * (i+n)!/i!, with the falling factorial updated in place
+		const unsigned int m = static_cast<unsigned int>(n);
+		Polynomial<_ty, _alloc> res(coef.get_allocator());
+		res.coef.resize(coef.size() - m);
+		_ty f = _ty(1);
+		for (unsigned int j = 2; j <= m; ++j)
+			f *= _ty(j);
+		for (unsigned int i = 0; i < res.coef.size(); ++i)
 		{
-			Polynomial<_ty> res(0u);
-			for (unsigned int i = 1; i < coef.size(); ++i)
-			{
-				res.set_coefficient(i - 1, coef[i] * _ty(i));
-			}
-			return res;
+			res.coef[i] = coef[i + m] * f;
+			f = f * _ty(i + m + 1) / _ty(i + 1);
 		}
-		else
-			return derivative().derivative(n - 1);
-		// TODO: get rid of recursion
+		return res;
 	}
 	template <typename aux>	inline _ty derivativeAt(const aux x) const
 	{
+		if (coef.size() < 2)
+			return _ty(0);
+		const _ty xv = _ty(x);
 		_ty res = _ty(0);
 		for (unsigned int i = coef.size() - 1; i > 1; --i)
 		{
 
-			res += i*coef[i];
-			res *= _ty(x);
+			res += _ty(i)*coef[i];
+			res *= xv;
 		}
 		res += coef[1];
 		return res; 
 	}
-	inline Polynomial<_ty> integral(const int n = 1) const
+	/** evaluates p, p', ..., p^(k) at x in one pass of repeated synthetic division; res must hold k+1 values */
+	template <typename aux> inline void derivativesAt(const aux x, _ty* res, const unsigned int k) const
+	{
+		polyeval::derivatives_at(coef.data(), coef.size(), _ty(x), res, k);
+	}
+	/** evaluates the first derivative with the given scheme, without forming the derivative's coefficients */
+	template <typename aux> inline _ty derivativeAt(const aux x, const polyeval::scheme s) const
+	{
+		if (coef.size() < 2)
+			return _ty(0);
+		return polyeval::evaluate_at(polyeval::derivative_coefficients<_ty>{ coef.data() }, coef.size() - 1, _ty(x), s);
+	}
+	/** evaluates the first derivative by compensated Horner, with an error bound in *bound if given; double coefficients only */
+	inline _ty compensatedDerivativeAt(const _ty x, double* bound = nullptr) const
+	{
+		return polyeval::compensated_horner_derivative(coef.data(), coef.size(), x, bound);
+	}
+	/** evaluates the first derivative at n points, dys[k] = p'(xs[k]) */
+	inline void evaluate_derivative(const _ty* xs, _ty* dys, const std::size_t n, const unsigned int threads = 1) const
+	{
+		evaluate_with_derivative(xs, nullptr, dys, n, threads);
+	}
+	/** evaluates the polynomial and its first derivative at n points in one pass, ys[k] = p(xs[k]), dys[k] = p'(xs[k]) */
+	inline void evaluate_with_derivative(const _ty* xs, _ty* ys, _ty* dys, const std::size_t n, const unsigned int threads = 1) const
+	{
+		const _ty* c = coef.data();
+		const std::size_t nc = coef.size();
+		parallel::for_ranges(n, threads, [=](const std::size_t begin, const std::size_t end)
+		{
+			polyeval::evaluate_derivative(c, nc, xs + begin, (ys) ? (ys + begin) : (ys), (dys) ? (dys + begin) : (dys), end - begin);
+		}, 1024);
+	}
+	inline Polynomial<_ty, _alloc> integral(const int n = 1) const
 	{
 		if (n == 0)
-			return Polynomial<_ty>(*this);
+			return Polynomial<_ty, _alloc>(*this);
 		else if (n < 0)
 			return derivative(-n);
-		else if (n == 1)
+		// C[i+n] = c[i] * i!/(i+n)!, lower coefficients are zero
+		const unsigned int m = static_cast<unsigned int>(n);
+		Polynomial<_ty, _alloc> res(coef.get_allocator());
+		res.coef.assign(coef.size() + m, _ty(0));
+		_ty f = _ty(1);
+		for (unsigned int j = 2; j <= m; ++j)
+			f *= _ty(j);
+		for (unsigned int i = 0; i < coef.size(); ++i)
 		{
-			Polynomial<_ty> res(0);
-			for (unsigned int i = 0; i < coef.size(); ++i)
-				res.set_coefficient(i + 1, coef[i] / _ty(i + 1));
-			return res;
+			res.coef[i + m] = coef[i] / f;
+			f = f * _ty(i + m + 1) / _ty(i + 1);
 		}
-		else
-			return integral().integral(n - 1);
-		// TODO: get rid of recursion
+		return res;
 	}
 	template <typename aux> inline _ty integrate(const aux a, const aux b) const
 	{
-		Polynomial<_ty> F = integral();
+		Polynomial<_ty, _alloc> F = integral();
 		return (F(b) - F(a));
 	}
 
@@ -321,14 +445,14 @@ public:
 		else
 			return _ty(0);
 	}
-	inline Polynomial<_ty> get_monomial(const unsigned int i) const
+	inline Polynomial<_ty, _alloc> get_monomial(const unsigned int i) const
 	{
-		Polynomial<_ty> res = 0;
+		Polynomial<_ty, _alloc> res = 0;
 		if (i < coef.size())
 			res[i] = coef[i];
 		return res;
 	}
-	template <typename aux> inline Polynomial<_ty>& set_coefficient(const unsigned int i, const aux arg)
+	template <typename aux> inline Polynomial<_ty, _alloc>& set_coefficient(const unsigned int i, const aux arg)
 	{
 		if (i < coef.size())
 			coef[i] = _ty(arg);
@@ -339,7 +463,17 @@ public:
 		}
 		return *this;
 	}
-	inline std::vector<_ty>& coefficients() { return coef; }
+	inline storage_type& coefficients() { return coef; }
+	inline const storage_type& coefficients() const { return coef; }
+	/** makes room for n coefficients (degree n-1) without further allocations */
+	inline Polynomial<_ty, _alloc>& reserve(const std::size_t n)
+	{
+		coef.reserve(n);
+		return *this;
+	}
+	/** number of coefficients that fit without allocating */
+	inline std::size_t capacity() const { return coef.capacity(); }
+	inline _alloc get_allocator() const { return coef.get_allocator(); }
 
 #ifdef _STD_STRING_INCLUDED_
 	inline std::string to_string(const char* argn = "x") const
@@ -369,7 +503,7 @@ public:
 	}
 #endif
 
-	inline Polynomial<_ty>& shrink()
+	inline Polynomial<_ty, _alloc>& shrink()
 	{
 		while (coef[coef.size() - 1] == _ty(0))
 			coef.pop_back();
@@ -385,9 +519,15 @@ public:
 	}
 };
 
+template <typename aux, typename _ty, typename _alloc, typename = typename std::enable_if<!polyexpr::is_operand<aux>::value && std::is_convertible<aux, _ty>::value>::type>
+inline Polynomial<_ty, _alloc> operator*(const aux scalar, const Polynomial<_ty, _alloc>& pol)
+{
+	return pol * scalar;
+}
+
 #ifdef _STD_OSTREAM_INCLUDED_
-template <typename _ty>
-inline std::ostream& operator<<(std::ostream& ostr, const Polynomial<_ty>& pol)
+template <typename _ty, typename _alloc>
+inline std::ostream& operator<<(std::ostream& ostr, const Polynomial<_ty, _alloc>& pol)
 {
 	if (pol.degree() == -1)
 		return ostr << "0";
@@ -411,9 +551,11 @@ inline std::ostream& operator<<(std::ostream& ostr, const Polynomial<_ty>& pol)
 #endif
 
 
+/** Taylor polynomial of sin at 0 up to the given order; make_sin(pol, a, b, tolerance) in interpolation/tchebyshev.hpp needs fewer terms on an interval */
 void make_sin(Polynomial<double>* pol, unsigned int order)
 {
 	pol->operator=(0);
+	pol->reserve(order + 1);
 	double f = 1;
 	for (unsigned int i = 0; i <= order; ++i)
 	{
@@ -423,9 +565,11 @@ void make_sin(Polynomial<double>* pol, unsigned int order)
 	}
 }
 
+/** Taylor polynomial of cos at 0 up to the given order; make_cos(pol, a, b, tolerance) in interpolation/tchebyshev.hpp needs fewer terms on an interval */
 void make_cos(Polynomial<double>* pol, unsigned int order)
 {
 	pol->operator=(0);
+	pol->reserve(order + 1);
 	double f = 1;
 	for (unsigned int i = 0; i <= order; ++i)
 	{
@@ -435,9 +579,11 @@ void make_cos(Polynomial<double>* pol, unsigned int order)
 	}
 }
 
+/** Taylor polynomial of exp at 0 up to the given order; make_exp(pol, a, b, tolerance) in interpolation/tchebyshev.hpp needs fewer terms on an interval */
 void make_exp(Polynomial<double>* pol, unsigned int order)
 {
 	pol->operator=(0);
+	pol->reserve(order + 1);
 	double f = 1;
 	for (unsigned int i = 0; i <= order; ++i)
 	{
@@ -447,21 +593,129 @@ void make_exp(Polynomial<double>* pol, unsigned int order)
 	}
 }
 
-template <typename _ty> void interpolate_lagrange(std::vector<_ty>& x, std::vector<_ty>& y, Polynomial<_ty>* pol)
+/**
+ * scale of the differences between the nodes x[0..n-1] for barycentric weights: the capacity (max - min)/4 of their
+ * interval, or 1 if they all coincide. prod_{k!=j} (x[j]-x[k])/scale then stays near 1 for well spread nodes instead
+ * of over- or underflowing with n (the raw products of Chebyshev points in [-1,1] are about 2^-n).
+ */
+template <typename _ty> inline _ty interpolation_scale(const _ty* x, const std::size_t n)
+{
+	if (n == 0)
+		return _ty(1);
+	_ty lo = x[0], hi = x[0];
+	for (std::size_t j = 1; j < n; ++j)
+	{
+		lo = (x[j] < lo) ? (x[j]) : (lo);
+		hi = (hi < x[j]) ? (x[j]) : (hi);
+	}
+	return (hi - lo > _ty(0)) ? ((hi - lo) / _ty(4)) : (_ty(1));
+}
+
+/**
+ * builds the interpolating polynomial through (x[j], y[j]) from the barycentric weights
+ * w[j] = 1/prod_{k!=j}((x[j]-x[k])/scale), in O(n^2). The polynomial is built in s = t/scale, where the nodes are
+ * x[j]/scale and these are the plain weights, and coefficient k is divided by scale^k only at the end, so nothing
+ * leaves the range of _ty unless the result does. Real coefficient types.
+ */
+template <typename _ty, typename _alloc> void interpolate_barycentric(const _ty* x, const _ty* y, const _ty* w, const std::size_t n, Polynomial<_ty, _alloc>* pol, const _ty scale = _ty(1))
 {
 	pol->operator=(0);
-	Polynomial<_ty> l;
-	for (unsigned int i = 0; i < x.size(); ++i)
+	if (n == 0)
+		return;
+	// l(s) = prod (s - x[j]/scale), then p = sum w[j]*y[j] * l(s)/(s - x[j]/scale); scratch space comes from pol's allocator
+	std::vector<_ty, _alloc> l(n + 1, _ty(0), pol->get_allocator()), q(n, _ty(0), pol->get_allocator());
+	l[0] = _ty(1);
+	for (std::size_t j = 0; j < n; ++j)
+	{
+		const _ty sj = x[j] / scale;
+		for (std::size_t i = j + 1; i > 0; --i)
+			l[i] = l[i - 1] - sj * l[i];
+		l[0] = -(sj * l[0]);
+	}
+	typename Polynomial<_ty, _alloc>::storage_type& res = pol->coefficients();
+	res.assign(n, _ty(0));
+	for (std::size_t j = 0; j < n; ++j)
+	{
+		const _ty sj = x[j] / scale;
+		q[n - 1] = l[n];
+		for (std::size_t i = n - 1; i > 0; --i)
+			q[i - 1] = l[i] + sj * q[i];
+		const _ty f = w[j] * y[j];
+		for (std::size_t i = 0; i < n; ++i)
+			res[i] += f * q[i];
+	}
+	if (scale == _ty(1))
+		return;
+	// res[i] / scale^i, the power kept as m*2^e
+	_ty m = _ty(1);
+	int e = 0;
+	for (std::size_t i = 0; i < n; ++i)
+	{
+		res[i] = std::ldexp(res[i] * m, e);
+		int k;
+		m = std::frexp(m / scale, &k);
+		e += k;
+	}
+}
+
+/** the interpolating polynomial through (x[j], y[j]), j < n, in O(n^2); the weights are scaled by interpolation_scale() */
+template <typename _ty, typename _alloc> void interpolate_lagrange(const _ty* x, const _ty* y, const std::size_t n, Polynomial<_ty, _alloc>* pol)
+{
+	const _ty scale = interpolation_scale(x, n);
+	std::vector<_ty, _alloc> w(n, _ty(1), pol->get_allocator());
+	for (std::size_t i = 0; i < n; ++i)
 	{
-		l = 1;
-		for (unsigned int j = 0; j < x.size(); ++j)
+		for (std::size_t j = 0; j < n; ++j)
 		{
 			if (j != i)
-				l *= Polynomial<_ty>({ -(x[j]), 1.0 }) / (x[i] - x[j]);
+				w[i] *= (x[i] - x[j]) / scale;
 		}
-		l *= ((y[i]) / l(x[i]));
-		pol->operator+=(l);
+		w[i] = _ty(1) / w[i];
 	}
+	interpolate_barycentric(x, y, w.data(), n, pol, scale);
+}
+template <typename _ty, typename _alloc> void interpolate_lagrange(std::vector<_ty>& x, std::vector<_ty>& y, Polynomial<_ty, _alloc>* pol)
+{
+	interpolate_lagrange(x.data(), y.data(), x.size(), pol);
+}
+
+/**
+ * division with remainder, a = quot*b + rem with deg(rem) < deg(b); either output may be null.
+ * Long quotients go through Newton inversion of the reversed divisor, so the cost follows that of multiplication.
+ * Returns false (and leaves the outputs alone) if b is the zero polynomial.
+ */
+template <typename _ty, typename _alloc> bool divide(const Polynomial<_ty, _alloc>& a, const Polynomial<_ty, _alloc>& b, Polynomial<_ty, _alloc>* quot, Polynomial<_ty, _alloc>* rem)
+{
+	std::size_t nb = b.degree() + 1;
+	while (nb > 0 && b.get_coefficient(nb - 1) == _ty(0))
+		--nb;
+	if (nb == 0)
+		return false;
+	std::size_t na = (a.degree() < 0) ? (1) : (a.degree() + 1);
+	while (na > 1 && a.get_coefficient(na - 1) == _ty(0))
+		--na;
+	// the buffers end up in rem and quot, so they come from their allocators
+	std::vector<_ty, _alloc> ca(na, _ty(0), (rem != nullptr) ? (rem->get_allocator()) : (a.get_allocator()));
+	for (std::size_t i = 0; i < na; ++i)
+		ca[i] = a.get_coefficient(i);
+	if (na < nb)
+	{
+		if (quot != nullptr)
+			quot->operator=(0);
+		if (rem != nullptr)
+			rem->coefficients() = std::move(ca);
+		return true;
+	}
+	std::vector<_ty, _alloc> q(na - nb + 1, _ty(0), (quot != nullptr) ? (quot->get_allocator()) : (a.get_allocator()));
+	convolution::divide(ca.data(), na, &*b.begin(), nb, q.data(), ca.data());
+	ca.resize((nb > 1) ? (nb - 1) : (1));
+	if (nb == 1)
+		ca[0] = _ty(0);
+	if (quot != nullptr)
+		quot->coefficients() = std::move(q);
+	if (rem != nullptr)
+		rem->coefficients() = std::move(ca);
+	return true;
 }
 
 
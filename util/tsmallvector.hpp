@@ -0,0 +1,250 @@
+#ifndef _FHP_TSMALLVECTOR_HPP_INCLUDED_
+#define _FHP_TSMALLVECTOR_HPP_INCLUDED_
+
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <iterator>
+#include <type_traits>
+
+
+/**
+ * Contiguous sequence with room for N elements inside the object: up to N elements need no allocation, beyond that
+ * the elements move into a std::vector, which then grows geometrically. Offers the parts of the std::vector interface
+ * used on polynomial coefficients; iterators are plain pointers and are invalidated by any growth.
+ * A std::vector with the same allocator can be moved in (and stays on the heap if it does not fit inline), so buffers
+ * built elsewhere are adopted without copying. Heap storage comes from _alloc (see util/tarena.hpp for an arena).
+ * _ty has to be default constructible and cheap to copy (a number type).
+ */
+template <typename _ty, std::size_t N, typename _alloc = std::allocator<_ty>> class SmallVector
+{
+public:
+	typedef _alloc allocator_type;
+	typedef std::vector<_ty, _alloc> heap_type;
+
+protected:
+	_ty local[N];
+	heap_type heap;
+	/** number of elements while inline; on the heap heap.size() counts */
+	std::size_t n;
+	bool on_heap;
+
+	/** moves the elements to the heap with room for at least cap elements */
+	inline void spill(const std::size_t cap)
+	{
+		heap_type h(heap.get_allocator());
+		h.reserve((cap > 2 * N) ? (cap) : (2 * N));
+		h.assign(local, local + n);
+		heap.swap(h);
+		on_heap = true;
+	}
+	inline void copy_from(const _ty* first, const std::size_t count)
+	{
+		if (on_heap)
+			heap.assign(first, first + count);
+		else if (count <= N)
+		{
+			for (std::size_t i = 0; i < count; ++i)
+				local[i] = first[i];
+			n = count;
+		}
+		else
+		{
+			heap.assign(first, first + count);
+			on_heap = true;
+		}
+	}
+	inline void move_from(SmallVector& other)
+	{
+		if (other.on_heap)
+		{
+			heap = std::move(other.heap);
+			on_heap = true;
+			other.heap.clear();
+			other.on_heap = false;
+			other.n = 0;
+		}
+		else
+		{
+			if (on_heap)
+			{
+				heap.clear();
+				on_heap = false;
+			}
+			for (std::size_t i = 0; i < other.n; ++i)
+				local[i] = other.local[i];
+			n = other.n;
+		}
+	}
+
+public:
+	typedef _ty value_type;
+	typedef _ty* iterator;
+	typedef const _ty* const_iterator;
+
+	inline explicit SmallVector(const _alloc& a = _alloc()) : local(), heap(a), n(0), on_heap(false) {}
+	inline explicit SmallVector(const std::size_t count, const _ty& value = _ty(), const _alloc& a = _alloc()) : local(), heap(a), n(0), on_heap(false)
+	{
+		assign(count, value);
+	}
+	inline SmallVector(const SmallVector& other) : local(), heap(std::allocator_traits<_alloc>::select_on_container_copy_construction(other.heap.get_allocator())), n(0), on_heap(false)
+	{
+		copy_from(other.data(), other.size());
+	}
+	inline SmallVector(SmallVector&& other) noexcept : local(), heap(other.heap.get_allocator()), n(0), on_heap(false)
+	{
+		move_from(other);
+	}
+	inline ~SmallVector() {}
+
+	inline SmallVector& operator=(const SmallVector& other)
+	{
+		if (this != &other)
+			copy_from(other.data(), other.size());
+		return *this;
+	}
+	inline SmallVector& operator=(SmallVector&& other) noexcept
+	{
+		if (this != &other)
+			move_from(other);
+		return *this;
+	}
+	/** adopts the buffer of v if it does not fit inline, copies it otherwise */
+	inline SmallVector& operator=(heap_type&& v)
+	{
+		if (v.size() <= N)
+		{
+			heap.clear();
+			on_heap = false;
+			copy_from(v.data(), v.size());
+		}
+		else
+		{
+			heap = std::move(v);
+			on_heap = true;
+		}
+		v.clear();
+		return *this;
+	}
+	/** copies a vector with a different allocator */
+	template <typename aux> inline SmallVector& operator=(std::vector<_ty, aux>&& v)
+	{
+		assign(v.begin(), v.end());
+		v.clear();
+		return *this;
+	}
+
+	/// size and capacity
+	inline std::size_t size() const { return (on_heap) ? (heap.size()) : (n); }
+	inline bool empty() const { return size() == 0; }
+	inline std::size_t capacity() const { return (on_heap) ? (heap.capacity()) : (N); }
+	/** whether the elements live inside the object */
+	inline bool is_inline() const { return !on_heap; }
+	inline void reserve(const std::size_t count)
+	{
+		if (count <= capacity())
+			return;
+		if (on_heap)
+			heap.reserve(count);
+		else
+			spill(count);
+	}
+	/** new elements are set to value; growth beyond the capacity at least doubles it */
+	inline void resize(const std::size_t count, const _ty& value = _ty())
+	{
+		if (!on_heap)
+		{
+			if (count <= N)
+			{
+				for (std::size_t i = n; i < count; ++i)
+					local[i] = value;
+				n = count;
+				return;
+			}
+			spill(count);
+		}
+		if (count > heap.capacity())
+			heap.reserve((count > 2 * heap.capacity()) ? (count) : (2 * heap.capacity()));
+		if (count == heap.size() + 1)
+			heap.push_back(value);
+		else
+			heap.resize(count, value);
+	}
+	inline void clear() { resize(0); }
+
+	/// modifiers
+	inline void assign(const std::size_t count, const _ty& value)
+	{
+		// the inline loop is only reachable for count <= N, which the compiler can see (no out-of-bounds warnings)
+		if (on_heap || count > N)
+		{
+			if (!on_heap)
+				spill(count);
+			heap.assign(count, value);
+			return;
+		}
+		for (std::size_t i = 0; i < count; ++i)
+			local[i] = value;
+		n = count;
+	}
+	template <typename _it, typename = typename std::enable_if<!std::is_integral<_it>::value>::type> inline void assign(_it first, _it last)
+	{
+		const std::size_t count = std::size_t(std::distance(first, last));
+		if (on_heap || count > N)
+		{
+			if (!on_heap)
+				spill(count);
+			heap.assign(first, last);
+			return;
+		}
+		for (std::size_t i = 0; i < count; ++i, ++first)
+			local[i] = *first;
+		n = count;
+	}
+	inline void push_back(const _ty& value)
+	{
+		if (!on_heap && n == N)
+			spill(2 * N);
+		if (on_heap)
+			heap.push_back(value);
+		else
+			local[n++] = value;
+	}
+	inline void pop_back()
+	{
+		if (on_heap)
+			heap.pop_back();
+		else
+			--n;
+	}
+	inline void swap(SmallVector& other)
+	{
+		SmallVector t(std::move(other));
+		other = std::move(*this);
+		*this = std::move(t);
+	}
+	/** exchanges the contents with a std::vector */
+	inline void swap(heap_type& v)
+	{
+		heap_type t(begin(), end(), heap.get_allocator());
+		*this = std::move(v);
+		v.swap(t);
+	}
+
+	inline _alloc get_allocator() const { return heap.get_allocator(); }
+
+	/// access
+	inline _ty* data() { return (on_heap) ? (heap.data()) : (local); }
+	inline const _ty* data() const { return (on_heap) ? (heap.data()) : (local); }
+	inline _ty& operator[](const std::size_t i) { return data()[i]; }
+	inline const _ty& operator[](const std::size_t i) const { return data()[i]; }
+	inline _ty& back() { return data()[size() - 1]; }
+	inline const _ty& back() const { return data()[size() - 1]; }
+	inline iterator begin() { return data(); }
+	inline iterator end() { return data() + size(); }
+	inline const_iterator begin() const { return data(); }
+	inline const_iterator end() const { return data() + size(); }
+};
+
+#endif
@@ -0,0 +1,394 @@
+#ifndef _FHP_TSPARSEPOLYNOMIAL_HPP_INCLUDED_
+#define _FHP_TSPARSEPOLYNOMIAL_HPP_INCLUDED_
+
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include <initializer_list>
+#include <cstddef>
+#include <type_traits>
+#include "tpolynomial.hpp"
+#include "tconvolution.hpp"
+#include "tparallel.hpp"
+
+
+namespace sparse
+{
+
+	/** share of nonzero coefficients (terms / (degree+1)) from which on both factors of a product are multiplied densely */
+	inline double& density_threshold() { static double t = 0.25; return t; }
+
+	/** x^e by repeated squaring, O(log e) multiplications */
+	template <typename _ty> inline _ty power(_ty x, unsigned int e)
+	{
+		_ty res = _ty(1);
+		while (e != 0)
+		{
+			if (e & 1)
+				res *= x;
+			e >>= 1;
+			if (e != 0)
+				x *= x;
+		}
+		return res;
+	}
+
+}
+
+
+/**
+ * Polynomial stored as its nonzero terms (exponent, coefficient), sorted by increasing exponent, so memory and the
+ * cost of evaluation and arithmetic follow the number of terms rather than the degree: x^100000 - 3x^517 + 1 holds
+ * three terms. Evaluation runs Horner's scheme over the exponent gaps, each power by repeated squaring.
+ * Products go through a heap merge of the partial products (Johnson's algorithm), or through the dense convolution
+ * once both factors are dense enough (sparse::density_threshold()).
+ */
+template <typename _ty> class SparsePolynomial
+{
+public:
+	typedef _ty value_type;
+	struct term
+	{
+		unsigned int exponent;
+		_ty coefficient;
+	};
+	typedef typename std::vector<term>::const_iterator const_iterator;
+
+protected:
+	std::vector<term> terms;
+
+	/** sorts by exponent, merges equal exponents and removes zero coefficients */
+	inline void normalize()
+	{
+		std::stable_sort(terms.begin(), terms.end(), [](const term& a, const term& b) { return a.exponent < b.exponent; });
+		std::size_t out = 0;
+		for (std::size_t i = 0; i < terms.size();)
+		{
+			term t = terms[i];
+			for (++i; i < terms.size() && terms[i].exponent == t.exponent; ++i)
+				t.coefficient += terms[i].coefficient;
+			if (t.coefficient != _ty(0))
+				terms[out++] = t;
+		}
+		terms.resize(out);
+	}
+	inline typename std::vector<term>::iterator find(const unsigned int e)
+	{
+		return std::lower_bound(terms.begin(), terms.end(), e, [](const term& t, const unsigned int x) { return t.exponent < x; });
+	}
+	inline const_iterator find(const unsigned int e) const
+	{
+		return std::lower_bound(terms.begin(), terms.end(), e, [](const term& t, const unsigned int x) { return t.exponent < x; });
+	}
+
+	/** res = a + s*b for sorted term lists */
+	static inline void merge(const std::vector<term>& a, const std::vector<term>& b, const _ty s, std::vector<term>& res)
+	{
+		res.clear();
+		res.reserve(a.size() + b.size());
+		std::size_t i = 0, j = 0;
+		while (i < a.size() || j < b.size())
+		{
+			if (j == b.size() || (i < a.size() && a[i].exponent < b[j].exponent))
+				res.push_back(a[i++]);
+			else if (i == a.size() || b[j].exponent < a[i].exponent)
+			{
+				res.push_back(term{ b[j].exponent, s * b[j].coefficient });
+				++j;
+			}
+			else
+			{
+				const _ty c = a[i].coefficient + s * b[j].coefficient;
+				if (c != _ty(0))
+					res.push_back(term{ a[i].exponent, c });
+				++i;
+				++j;
+			}
+		}
+	}
+
+public:
+	/** creates the zero polynomial */
+	inline SparsePolynomial() {}
+	/** creates a polynomial from (exponent, coefficient) pairs in any order; equal exponents are added up */
+	inline SparsePolynomial(std::initializer_list<term> list) : terms(list)
+	{
+		normalize();
+	}
+	/** creates a constant polynomial */
+	template <typename aux, typename = typename std::enable_if<std::is_convertible<aux, _ty>::value>::type> inline explicit SparsePolynomial(const aux scalar)
+	{
+		if (_ty(scalar) != _ty(0))
+			terms.push_back(term{ 0, _ty(scalar) });
+	}
+	/** takes the nonzero coefficients of a dense polynomial */
+	inline explicit SparsePolynomial(const Polynomial<_ty>& pol)
+	{
+		for (int i = 0; i <= pol.degree(); ++i)
+		{
+			const _ty c = pol.get_coefficient(i);
+			if (c != _ty(0))
+				terms.push_back(term{ unsigned(i), c });
+		}
+	}
+	inline ~SparsePolynomial() {}
+
+	/** converts to the dense representation, with degree()+1 coefficients */
+	inline Polynomial<_ty> to_polynomial() const
+	{
+		Polynomial<_ty> res;
+		if (terms.empty())
+			return res;
+		typename Polynomial<_ty>::storage_type& c = res.coefficients();
+		c.assign(std::size_t(terms.back().exponent) + 1, _ty(0));
+		for (const term& t : terms)
+			c[t.exponent] = t.coefficient;
+		return res;
+	}
+	/** terms / (degree+1), 1 for a dense polynomial without zero coefficients */
+	inline double density() const
+	{
+		return (terms.empty()) ? (1.0) : (double(terms.size()) / (double(terms.back().exponent) + 1.0));
+	}
+	/** whether the dense representation would be the better one, by sparse::density_threshold() */
+	inline bool prefers_dense() const { return density() >= sparse::density_threshold(); }
+
+	/// access
+	/** the highest exponent; 0 for the zero polynomial */
+	inline unsigned int degree() const { return (terms.empty()) ? (0) : (terms.back().exponent); }
+	/** number of nonzero terms */
+	inline std::size_t size() const { return terms.size(); }
+	/** coefficient of x^e, O(log size()) */
+	inline _ty get_coefficient(const unsigned int e) const
+	{
+		const const_iterator it = find(e);
+		return (it != terms.end() && it->exponent == e) ? (it->coefficient) : (_ty(0));
+	}
+	/** sets the coefficient of x^e; a zero removes the term */
+	template <typename aux> inline SparsePolynomial<_ty>& set_coefficient(const unsigned int e, const aux arg)
+	{
+		const _ty c = _ty(arg);
+		typename std::vector<term>::iterator it = find(e);
+		if (it != terms.end() && it->exponent == e)
+		{
+			if (c == _ty(0))
+				terms.erase(it);
+			else
+				it->coefficient = c;
+		}
+		else if (c != _ty(0))
+			terms.insert(it, term{ e, c });
+		return *this;
+	}
+	inline const_iterator begin() const { return terms.begin(); }
+	inline const_iterator end() const { return terms.end(); }
+
+	/// evaluation
+	/** Horner's scheme over the exponent gaps, O(sum log(gap)) multiplications */
+	template <typename aux> inline _ty operator()(const aux x) const
+	{
+		if (terms.empty())
+			return _ty(0);
+		const _ty xv = _ty(x);
+		_ty res = terms.back().coefficient;
+		for (std::size_t i = terms.size() - 1; i > 0; --i)
+			res = res * sparse::power(xv, terms[i].exponent - terms[i - 1].exponent) + terms[i - 1].coefficient;
+		return res * sparse::power(xv, terms[0].exponent);
+	}
+	/** ys[k] = p(xs[k]) for k < n; the range is split over the given number of threads (0: one per hardware thread) */
+	inline void evaluate(const _ty* xs, _ty* ys, const std::size_t n, const unsigned int threads = 1) const
+	{
+		parallel::for_ranges(n, threads, [&](const std::size_t begin, const std::size_t end)
+		{
+			for (std::size_t k = begin; k < end; ++k)
+				ys[k] = this->operator()(xs[k]);
+		}, 256);
+	}
+	inline std::vector<_ty> evaluate(const std::vector<_ty>& xs, const unsigned int threads = 1) const
+	{
+		std::vector<_ty> ys(xs.size());
+		evaluate(xs.data(), ys.data(), xs.size(), threads);
+		return ys;
+	}
+
+	/// arithmetic
+	inline SparsePolynomial<_ty> operator-() const
+	{
+		SparsePolynomial<_ty> res = *this;
+		for (term& t : res.terms)
+			t.coefficient = -t.coefficient;
+		return res;
+	}
+	inline SparsePolynomial<_ty>& operator+=(const SparsePolynomial<_ty>& other)
+	{
+		std::vector<term> res;
+		merge(terms, other.terms, _ty(1), res);
+		terms.swap(res);
+		return *this;
+	}
+	inline SparsePolynomial<_ty>& operator-=(const SparsePolynomial<_ty>& other)
+	{
+		std::vector<term> res;
+		merge(terms, other.terms, _ty(-1), res);
+		terms.swap(res);
+		return *this;
+	}
+	inline SparsePolynomial<_ty> operator+(const SparsePolynomial<_ty>& other) const
+	{
+		SparsePolynomial<_ty> res;
+		merge(terms, other.terms, _ty(1), res.terms);
+		return res;
+	}
+	inline SparsePolynomial<_ty> operator-(const SparsePolynomial<_ty>& other) const
+	{
+		SparsePolynomial<_ty> res;
+		merge(terms, other.terms, _ty(-1), res.terms);
+		return res;
+	}
+	template <typename aux, typename = typename std::enable_if<std::is_convertible<aux, _ty>::value>::type> inline SparsePolynomial<_ty>& operator*=(const aux scalar)
+	{
+		if (_ty(scalar) == _ty(0))
+			terms.clear();
+		for (term& t : terms)
+			t.coefficient *= _ty(scalar);
+		return *this;
+	}
+	template <typename aux, typename = typename std::enable_if<std::is_convertible<aux, _ty>::value>::type> inline SparsePolynomial<_ty>& operator/=(const aux scalar)
+	{
+		for (term& t : terms)
+			t.coefficient /= _ty(scalar);
+		return *this;
+	}
+	template <typename aux, typename = typename std::enable_if<std::is_convertible<aux, _ty>::value>::type> inline SparsePolynomial<_ty> operator*(const aux scalar) const
+	{
+		SparsePolynomial<_ty> res = *this;
+		return res *= scalar;
+	}
+	template <typename aux, typename = typename std::enable_if<std::is_convertible<aux, _ty>::value>::type> inline SparsePolynomial<_ty> operator/(const aux scalar) const
+	{
+		SparsePolynomial<_ty> res = *this;
+		return res /= scalar;
+	}
+
+	/**
+	 * product by a heap merge: one heap entry per term of the shorter factor, each walking the longer one, so the
+	 * partial products come out in increasing exponent order and like terms are combined on the fly,
+	 * O(n*m*log(min(n,m))) time and O(min(n,m)) extra space. Dense enough factors go through convolution::multiply().
+	 */
+	inline SparsePolynomial<_ty> operator*(const SparsePolynomial<_ty>& other) const
+	{
+		SparsePolynomial<_ty> res;
+		if (terms.empty() || other.terms.empty())
+			return res;
+		if (prefers_dense() && other.prefers_dense())
+		{
+			const Polynomial<_ty> a = to_polynomial(), b = other.to_polynomial();
+			std::vector<_ty> c(std::size_t(a.degree()) + b.degree() + 1);
+			convolution::multiply(&*a.begin(), a.degree() + 1, &*b.begin(), b.degree() + 1, c.data());
+			for (std::size_t i = 0; i < c.size(); ++i)
+				if (c[i] != _ty(0))
+					res.terms.push_back(term{ unsigned(i), c[i] });
+			return res;
+		}
+		const std::vector<term>& s = (terms.size() <= other.terms.size()) ? (terms) : (other.terms);
+		const std::vector<term>& l = (terms.size() <= other.terms.size()) ? (other.terms) : (terms);
+		// (exponent of s[i]*l[j], i), with j = pos[i]
+		typedef std::pair<unsigned int, std::size_t> entry;
+		std::vector<entry> heap;
+		std::vector<std::size_t> pos(s.size(), 0);
+		heap.reserve(s.size());
+		for (std::size_t i = 0; i < s.size(); ++i)
+			heap.push_back(entry(s[i].exponent + l[0].exponent, i));
+		std::make_heap(heap.begin(), heap.end(), std::greater<entry>());
+		while (!heap.empty())
+		{
+			const unsigned int e = heap.front().first;
+			_ty acc = _ty(0);
+			while (!heap.empty() && heap.front().first == e)
+			{
+				std::pop_heap(heap.begin(), heap.end(), std::greater<entry>());
+				const std::size_t i = heap.back().second;
+				acc += s[i].coefficient * l[pos[i]].coefficient;
+				if (++pos[i] < l.size())
+				{
+					heap.back().first = s[i].exponent + l[pos[i]].exponent;
+					std::push_heap(heap.begin(), heap.end(), std::greater<entry>());
+				}
+				else
+					heap.pop_back();
+			}
+			if (acc != _ty(0))
+				res.terms.push_back(term{ e, acc });
+		}
+		return res;
+	}
+	inline SparsePolynomial<_ty>& operator*=(const SparsePolynomial<_ty>& other)
+	{
+		return this->operator=(this->operator*(other));
+	}
+
+	/// calculus
+	/** n-th derivative, x^e -> e!/(e-n)! x^(e-n) per term */
+	inline SparsePolynomial<_ty> derivative(const unsigned int n = 1) const
+	{
+		SparsePolynomial<_ty> res;
+		for (const term& t : terms)
+		{
+			if (t.exponent < n)
+				continue;
+			_ty f = t.coefficient;
+			for (unsigned int j = 0; j < n; ++j)
+				f *= _ty(t.exponent - j);
+			res.terms.push_back(term{ t.exponent - n, f });
+		}
+		return res;
+	}
+	/** n-th antiderivative with vanishing integration constants, x^e -> e!/(e+n)! x^(e+n) per term */
+	inline SparsePolynomial<_ty> integral(const unsigned int n = 1) const
+	{
+		SparsePolynomial<_ty> res = *this;
+		for (term& t : res.terms)
+		{
+			for (unsigned int j = 1; j <= n; ++j)
+				t.coefficient /= _ty(t.exponent + j);
+			t.exponent += n;
+		}
+		return res;
+	}
+	template <typename aux> inline _ty integrate(const aux a, const aux b) const
+	{
+		const SparsePolynomial<_ty> F = integral();
+		return (F(b) - F(a));
+	}
+};
+
+template <typename _ty, typename aux, typename = typename std::enable_if<std::is_convertible<aux, _ty>::value>::type> inline SparsePolynomial<_ty> operator*(const aux scalar, const SparsePolynomial<_ty>& pol)
+{
+	return pol * scalar;
+}
+
+#ifdef _STD_OSTREAM_INCLUDED_
+template <typename _ty>
+inline std::ostream& operator<<(std::ostream& ostr, const SparsePolynomial<_ty>& pol)
+{
+	if (pol.size() == 0)
+		return ostr << "0";
+	unsigned int x = 0;
+	for (typename SparsePolynomial<_ty>::const_iterator it = pol.end(); it != pol.begin();)
+	{
+		--it;
+		ostream_lshift(ostr, it->coefficient, x, is_ineq_supported(_ty));
+		if (it->exponent != 0)
+			ostr << "x";
+		if (it->exponent >= 2)
+			ostr << "^" << it->exponent;
+		++x;
+	}
+	return ostr;
+}
+#endif
+
+typedef SparsePolynomial<float> sparse_polynomialf;
+typedef SparsePolynomial<double> sparse_polynomiald;
+
+#endif
@@ -0,0 +1,219 @@
+#ifndef _FHP_TSTATICPOLYNOMIAL_HPP_INCLUDED_
+#define _FHP_TSTATICPOLYNOMIAL_HPP_INCLUDED_
+
+#include <array>
+#include <utility>
+#include <type_traits>
+#include "tpolynomial.hpp"
+
+
+namespace static_polynomial_detail
+{
+	template <typename... _b> struct all_true : std::true_type {};
+	template <typename _b, typename... _rest> struct all_true<_b, _rest...> : std::integral_constant<bool, _b::value && all_true<_rest...>::value> {};
+
+	/** 1/k!, evaluated at compile time */
+	template <typename _ty> constexpr _ty inverse_factorial(const unsigned int k)
+	{
+		return (k == 0) ? (_ty(1)) : (inverse_factorial<_ty>(k - 1) / _ty(k));
+	}
+}
+
+
+/**
+ * Polynomial of fixed degree N with its N+1 coefficients in a std::array.
+ * Construction, arithmetic, derivative/integral and evaluation are constexpr; every loop over the
+ * coefficients is a pack expansion or a template recursion, so evaluation is a straight chain of multiply-adds.
+ */
+template <unsigned int N, typename _ty> class StaticPolynomial
+{
+public:
+	typedef _ty value_type;
+	typedef std::array<_ty, N + 1> array_type;
+
+protected:
+	array_type coef;
+
+public:
+	/** creates the zero polynomial */
+	constexpr StaticPolynomial() : coef() {}
+	/** creates a polynomial from its coefficients, lowest first; missing ones are zero */
+	template <typename... aux, typename = typename std::enable_if<(sizeof...(aux) >= 1) && (sizeof...(aux) <= N + 1) && static_polynomial_detail::all_true<std::is_convertible<aux, _ty>...>::value>::type>
+	constexpr StaticPolynomial(const aux... c) : coef{ { _ty(c)... } } {}
+	/** creates a polynomial from a coefficient array */
+	constexpr explicit StaticPolynomial(const array_type& c) : coef(c) {}
+	/** takes the coefficients of a Polynomial up to degree N */
+	inline explicit StaticPolynomial(const Polynomial<_ty>& pol) : coef()
+	{
+		for (unsigned int i = 0; i <= N; ++i)
+			coef[i] = pol.get_coefficient(i);
+	}
+
+	/** converts to a (heap-allocated) Polynomial */
+	inline Polynomial<_ty> to_polynomial() const
+	{
+		Polynomial<_ty> res(N, coef[N]);
+		for (unsigned int i = 0; i < N; ++i)
+			res.set_coefficient(i, coef[i]);
+		return res;
+	}
+	inline operator Polynomial<_ty>() const { return to_polynomial(); }
+
+	/// access
+	static constexpr unsigned int degree() { return N; }
+	constexpr _ty operator[](const unsigned int i) const { return coef[i]; }
+	constexpr _ty get_coefficient(const unsigned int i) const { return (i <= N) ? (coef[i]) : (_ty(0)); }
+	constexpr const array_type& coefficients() const { return coef; }
+	inline StaticPolynomial<N, _ty>& set_coefficient(const unsigned int i, const _ty x)
+	{
+		coef[i] = x;
+		return *this;
+	}
+
+	/// evaluation
+	/** Horner's scheme, unrolled at compile time */
+	template <typename aux> constexpr _ty operator()(const aux x) const
+	{
+		return horner(_ty(x), coef[N], std::integral_constant<unsigned int, N>());
+	}
+	/** value of the first derivative */
+	template <typename aux> constexpr _ty derivativeAt(const aux x) const
+	{
+		return derivative()(x);
+	}
+	template <typename aux> constexpr _ty integrate(const aux a, const aux b) const
+	{
+		return integral()(b) - integral()(a);
+	}
+
+	/// arithmetic
+	constexpr StaticPolynomial<N, _ty> operator-() const
+	{
+		return negate(std::make_index_sequence<N + 1>());
+	}
+	template <unsigned int M> constexpr StaticPolynomial<(M > N ? M : N), _ty> operator+(const StaticPolynomial<M, _ty>& other) const
+	{
+		return add(other, _ty(1), std::make_index_sequence<(M > N ? M : N) + 1>());
+	}
+	template <unsigned int M> constexpr StaticPolynomial<(M > N ? M : N), _ty> operator-(const StaticPolynomial<M, _ty>& other) const
+	{
+		return add(other, _ty(-1), std::make_index_sequence<(M > N ? M : N) + 1>());
+	}
+	template <unsigned int M> constexpr StaticPolynomial<N + M, _ty> operator*(const StaticPolynomial<M, _ty>& other) const
+	{
+		return multiply(other, std::make_index_sequence<N + M + 1>());
+	}
+	constexpr StaticPolynomial<N, _ty> operator*(const _ty scalar) const
+	{
+		return scale(scalar, std::make_index_sequence<N + 1>());
+	}
+	/** divides every coefficient by scalar, like Polynomial::operator/ (so integer types divide as they do) */
+	constexpr StaticPolynomial<N, _ty> operator/(const _ty scalar) const
+	{
+		return divide(scalar, std::make_index_sequence<N + 1>());
+	}
+
+	/// calculus
+	constexpr StaticPolynomial<(N > 0 ? N - 1 : 0), _ty> derivative() const
+	{
+		return derive(std::make_index_sequence<(N > 0 ? N - 1 : 0) + 1>());
+	}
+	/** antiderivative with zero constant term */
+	constexpr StaticPolynomial<N + 1, _ty> integral() const
+	{
+		return integrate_coefficients(std::make_index_sequence<N + 2>());
+	}
+
+protected:
+	template <unsigned int I> constexpr _ty horner(const _ty x, const _ty acc, std::integral_constant<unsigned int, I>) const
+	{
+		return horner(x, acc * x + coef[I - 1], std::integral_constant<unsigned int, I - 1>());
+	}
+	constexpr _ty horner(const _ty, const _ty acc, std::integral_constant<unsigned int, 0>) const
+	{
+		return acc;
+	}
+	template <std::size_t... I> constexpr StaticPolynomial<N, _ty> negate(std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<N, _ty>(array_type{ { -coef[I]... } });
+	}
+	template <std::size_t... I> constexpr StaticPolynomial<N, _ty> scale(const _ty s, std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<N, _ty>(array_type{ { (coef[I] * s)... } });
+	}
+	template <std::size_t... I> constexpr StaticPolynomial<N, _ty> divide(const _ty s, std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<N, _ty>(array_type{ { (coef[I] / s)... } });
+	}
+	template <unsigned int M, std::size_t... I> constexpr StaticPolynomial<(M > N ? M : N), _ty> add(const StaticPolynomial<M, _ty>& other, const _ty sign, std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<(M > N ? M : N), _ty>(typename StaticPolynomial<(M > N ? M : N), _ty>::array_type{ { (get_coefficient(I) + sign * other.get_coefficient(I))... } });
+	}
+	template <unsigned int M> constexpr _ty product_coefficient(const StaticPolynomial<M, _ty>& other, const unsigned int k, const unsigned int i) const
+	{
+		return (i > k || i > N) ? (_ty(0)) : (coef[i] * other.get_coefficient(k - i) + product_coefficient(other, k, i + 1));
+	}
+	template <unsigned int M, std::size_t... I> constexpr StaticPolynomial<N + M, _ty> multiply(const StaticPolynomial<M, _ty>& other, std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<N + M, _ty>(typename StaticPolynomial<N + M, _ty>::array_type{ { product_coefficient(other, I, 0)... } });
+	}
+	template <std::size_t... I> constexpr StaticPolynomial<(N > 0 ? N - 1 : 0), _ty> derive(std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<(N > 0 ? N - 1 : 0), _ty>(typename StaticPolynomial<(N > 0 ? N - 1 : 0), _ty>::array_type{ { (get_coefficient(I + 1) * _ty(I + 1))... } });
+	}
+	template <std::size_t... I> constexpr StaticPolynomial<N + 1, _ty> integrate_coefficients(std::index_sequence<I...>) const
+	{
+		return StaticPolynomial<N + 1, _ty>(typename StaticPolynomial<N + 1, _ty>::array_type{ { ((I == 0) ? (_ty(0)) : (get_coefficient(I - 1) / _ty(I)))... } });
+	}
+
+	template <unsigned int, typename> friend class StaticPolynomial;
+};
+
+template <unsigned int N, typename _ty> constexpr StaticPolynomial<N, _ty> operator*(const _ty scalar, const StaticPolynomial<N, _ty>& pol)
+{
+	return pol * scalar;
+}
+
+#ifdef _STD_OSTREAM_INCLUDED_
+template <unsigned int N, typename _ty>
+inline std::ostream& operator<<(std::ostream& ostr, const StaticPolynomial<N, _ty>& pol)
+{
+	return ostr << pol.to_polynomial();
+}
+#endif
+
+
+/// truncated Taylor series of order N, built at compile time
+namespace static_polynomial_detail
+{
+	template <typename _ty, std::size_t... I> constexpr StaticPolynomial<sizeof...(I) - 1, _ty> exp_series(std::index_sequence<I...>)
+	{
+		return StaticPolynomial<sizeof...(I) - 1, _ty>(typename StaticPolynomial<sizeof...(I) - 1, _ty>::array_type{ { inverse_factorial<_ty>(I)... } });
+	}
+	template <typename _ty, std::size_t... I> constexpr StaticPolynomial<sizeof...(I) - 1, _ty> sin_series(std::index_sequence<I...>)
+	{
+		return StaticPolynomial<sizeof...(I) - 1, _ty>(typename StaticPolynomial<sizeof...(I) - 1, _ty>::array_type{ { ((I % 2 == 0) ? (_ty(0)) : ((((I - 1) / 2) % 2 == 0) ? (_ty(1)) : (_ty(-1))) * inverse_factorial<_ty>(I))... } });
+	}
+	template <typename _ty, std::size_t... I> constexpr StaticPolynomial<sizeof...(I) - 1, _ty> cos_series(std::index_sequence<I...>)
+	{
+		return StaticPolynomial<sizeof...(I) - 1, _ty>(typename StaticPolynomial<sizeof...(I) - 1, _ty>::array_type{ { ((I % 2 != 0) ? (_ty(0)) : (((I / 2) % 2 == 0) ? (_ty(1)) : (_ty(-1))) * inverse_factorial<_ty>(I))... } });
+	}
+}
+template <unsigned int N, typename _ty = double> constexpr StaticPolynomial<N, _ty> make_static_exp()
+{
+	return static_polynomial_detail::exp_series<_ty>(std::make_index_sequence<N + 1>());
+}
+template <unsigned int N, typename _ty = double> constexpr StaticPolynomial<N, _ty> make_static_sin()
+{
+	return static_polynomial_detail::sin_series<_ty>(std::make_index_sequence<N + 1>());
+}
+template <unsigned int N, typename _ty = double> constexpr StaticPolynomial<N, _ty> make_static_cos()
+{
+	return static_polynomial_detail::cos_series<_ty>(std::make_index_sequence<N + 1>());
+}
+
+
+template <unsigned int N> using static_polynomiald = StaticPolynomial<N, double>;
+template <unsigned int N> using static_polynomialf = StaticPolynomial<N, float>;
+
+#endif
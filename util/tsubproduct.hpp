@@ -0,0 +1,367 @@
+#ifndef _FHP_TSUBPRODUCT_HPP_INCLUDED_
+#define _FHP_TSUBPRODUCT_HPP_INCLUDED_
+
+#include <vector>
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <type_traits>
+#include "tpolynomial.hpp"
+#include "tconvolution.hpp"
+#include "tpolyeval.hpp"
+#include "tparallel.hpp"
+
+
+namespace subproduct
+{
+
+	/** nodes with at most this many points are evaluated directly by Horner's scheme instead of being divided further */
+	inline std::size_t& leaf_size() { static std::size_t t = 64; return t; }
+
+	/** sort keys for spreading the points over the nodes: the value for real types, the argument for complex ones */
+	template <typename _ty> inline double spread_key(const _ty& x, const std::integral_constant<int, 1>&) { return static_cast<double>(x); }
+	template <typename _ty> inline double spread_key(const _ty& x, const std::integral_constant<int, 2>&) { using std::atan2; return atan2(static_cast<double>(x.imag()), static_cast<double>(x.real())); }
+
+	/**
+	 * order[i] = index of the point placed at leaf i: the points sorted by key, dealt out in bit-reversed order, so that
+	 * every node gets an evenly spread subset (for the n-th roots of unity each node becomes t^m - c). Keeps the given
+	 * order for types without a key.
+	 */
+	template <typename _ty> inline void spread_order(const _ty* x, const std::size_t n, std::size_t* order, const std::integral_constant<int, 0>&)
+	{
+		for (std::size_t i = 0; i < n; ++i)
+			order[i] = i;
+	}
+	template <typename _ty, int kind> inline void spread_order(const _ty* x, const std::size_t n, std::size_t* order, const std::integral_constant<int, kind>& tag)
+	{
+		std::vector<std::size_t> byval(n), byrev(n), rev(n);
+		unsigned int bits = 0;
+		while ((std::size_t(1) << bits) < n)
+			++bits;
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			byval[i] = byrev[i] = i;
+			std::size_t r = 0;
+			for (unsigned int b = 0; b < bits; ++b)
+				r |= ((i >> b) & 1) << (bits - 1 - b);
+			rev[i] = r;
+		}
+		std::vector<double> key(n);
+		for (std::size_t i = 0; i < n; ++i)
+			key[i] = spread_key(x[i], tag);
+		std::sort(byval.begin(), byval.end(), [&](const std::size_t a, const std::size_t b) { return key[a] < key[b]; });
+		std::sort(byrev.begin(), byrev.end(), [&](const std::size_t a, const std::size_t b) { return rev[a] < rev[b]; });
+		// the leaf with the j-th smallest reversed index gets the j-th smallest point
+		for (std::size_t j = 0; j < n; ++j)
+			order[byrev[j]] = byval[j];
+	}
+
+	/** number of points at which interpolate() checks its result */
+	inline std::size_t& check_points() { static std::size_t t = 16; return t; }
+
+	/** |p(x) - y| / (|y| + sum |c[i]| |x|^i) for p with coefficients c[0..n-1]: the residual relative to the rounding scale of Horner's scheme */
+	template <typename _ty> inline double backward_error(const _ty* c, const std::size_t n, const _ty& x, const _ty& y)
+	{
+		using std::abs;
+		const double ax = static_cast<double>(abs(x));
+		_ty v = _ty(0);
+		double bound = 0.0;
+		for (std::size_t i = n; i-- > 0;)
+		{
+			v = v * x + c[i];
+			bound = bound * ax + static_cast<double>(abs(c[i]));
+		}
+		const double r = static_cast<double>(abs(v - y)), scale = static_cast<double>(abs(y)) + bound;
+		return (scale > 0.0) ? (r / scale) : (r);
+	}
+
+}
+
+
+/**
+ * Subproduct tree over the points x[0..n-1]: level 0 holds the linear factors (t - x[i]), every node above the product
+ * of its two children, the root m(t) = prod (t - x[i]). Built once in O(M(n) log n) (M being the cost of multiplying,
+ * see util/tconvolution.hpp), it serves any number of
+ *  - multipoint evaluations: f mod m is reduced down the tree (remainder tree) to the points, and
+ *  - interpolations: p = sum y[i]/m'(x[i]) * m(t)/(t - x[i]) is combined up the tree,
+ * both in O(M(n) log n). The nodes of a level are independent and are computed in parallel.
+ * The points are dealt out to the leaves so that every node holds an evenly spread subset (see subproduct::spread_order()).
+ * In floating point this is only safe for points spaced like the roots of unity, evenly around a circle centred at 0:
+ * then every node is close to t^m - c. For other point sets (random points on the circle, more than a few dozen real
+ * points) the node products and the weights 1/m'(x[i]) lose all accuracy as n grows, down to overflow; interpolate()
+ * therefore reports how well its result reproduces the data.
+ */
+template <typename _ty> class SubproductTree
+{
+protected:
+	/** the points in leaf order, x[i] = the point with index order[i] as given to assign() */
+	std::vector<_ty> x;
+	std::vector<std::size_t> order;
+	/** level l, node k covers the points [k*2^l, min((k+1)*2^l, n)); its monic polynomial is stored at offset k*(2^l+1) */
+	std::vector<std::vector<_ty>> tree;
+	/** 1/rev(m) mod t^(2^l) of the nodes a division reaches, at offset k*2^l of their level; empty for lower levels */
+	std::vector<std::vector<_ty>> inv;
+	/** 1/m'(x[i]), the weights of interpolate() */
+	std::vector<_ty> w;
+	unsigned int nthreads;
+
+	inline std::size_t count(const std::size_t l, const std::size_t k) const
+	{
+		const std::size_t begin = k << l;
+		return (x.size() - begin < (std::size_t(1) << l)) ? (x.size() - begin) : (std::size_t(1) << l);
+	}
+	inline std::size_t nodes(const std::size_t l) const { return (x.size() + (std::size_t(1) << l) - 1) >> l; }
+	inline const _ty* node(const std::size_t l, const std::size_t k) const { return tree[l].data() + k * ((std::size_t(1) << l) + 1); }
+
+	inline void build()
+	{
+		const std::size_t n = x.size();
+		tree.clear();
+		inv.clear();
+		w.clear();
+		if (n == 0)
+			return;
+		tree.push_back(std::vector<_ty>(2 * n));
+		for (std::size_t i = 0; i < n; ++i)
+		{
+			tree[0][2 * i] = -x[i];
+			tree[0][2 * i + 1] = _ty(1);
+		}
+		for (std::size_t l = 0; nodes(l) > 1; ++l)
+		{
+			const std::size_t half = std::size_t(1) << l;
+			tree.push_back(std::vector<_ty>(nodes(l + 1) * (2 * half + 1)));
+			_ty* dst = tree[l + 1].data();
+			parallel::for_each_index(nodes(l + 1), nthreads, [&](const std::size_t k)
+			{
+				_ty* res = dst + k * (2 * half + 1);
+				if (2 * k + 1 < nodes(l))
+					convolution::multiply(node(l, 2 * k), count(l, 2 * k) + 1, node(l, 2 * k + 1), count(l, 2 * k + 1) + 1, res);
+				else
+					std::copy(node(l, 2 * k), node(l, 2 * k) + count(l, 2 * k) + 1, res);
+			}, (half < 64) ? (64 / half) : (1));
+		}
+		// the inverses for the divisions of remainder_tree(); a node is divided into only if its parent exceeds the leaf size
+		inv.resize(tree.size());
+		for (std::size_t l = 0; l + 1 < tree.size(); ++l)
+		{
+			const std::size_t len = std::size_t(1) << l;
+			if (2 * len <= subproduct::leaf_size())
+				continue;
+			inv[l].resize(nodes(l) * len);
+			parallel::for_each_index(nodes(l), nthreads, [&](const std::size_t k)
+			{
+				const std::size_t c = count(l, k);
+				std::vector<_ty> rev(node(l, k), node(l, k) + c + 1);
+				std::reverse(rev.begin(), rev.end());
+				convolution::inverse_series(rev.data(), c + 1, len, inv[l].data() + k * len);
+			});
+		}
+		// the weights are built here rather than on demand, so that interpolate() is const and can be called concurrently
+		w.resize(n);
+		Polynomial<_ty> m;
+		m.coefficients().assign(node(tree.size() - 1, 0), node(tree.size() - 1, 0) + n + 1);
+		const Polynomial<_ty> dm = m.derivative();
+		remainder_tree(&*dm.begin(), n, w.data());
+		for (_ty& v : w)
+			v = _ty(1) / v;
+	}
+
+	/** ys[i] = f(x[i]) for the polynomial f with coefficients c[0..nc-1], in leaf order */
+	inline void remainder_tree(const _ty* c, const std::size_t nc, _ty* ys) const
+	{
+		const std::size_t n = x.size();
+		if (n == 0)
+			return;
+		std::size_t l = tree.size() - 1;
+		// remainders of the current level, node k at offset k*2^l with count(l, k) coefficients
+		std::vector<_ty> cur(n, _ty(0)), next(n);
+		if (nc > n)
+		{
+			std::vector<_ty> q(nc - n), r(c, c + nc);
+			convolution::divide(r.data(), nc, node(l, 0), n + 1, q.data(), r.data());
+			std::copy(r.begin(), r.begin() + n, cur.begin());
+		}
+		else
+			std::copy(c, c + nc, cur.begin());
+		const std::size_t leaf = subproduct::leaf_size();
+		for (;; --l)
+		{
+			const std::size_t len = std::size_t(1) << l;
+			// nodes at or below the leaf size are finished by direct evaluation of their remainder
+			if (l == 0 || len <= leaf)
+			{
+				parallel::for_each_index(nodes(l), nthreads, [&](const std::size_t k)
+				{
+					polyeval::evaluate(cur.data() + k * len, count(l, k), x.data() + k * len, ys + k * len, count(l, k));
+				}, (len < 256) ? (256 / len) : (1));
+				return;
+			}
+			const std::size_t half = len >> 1;
+			parallel::for_each_index(nodes(l), nthreads, [&](const std::size_t k)
+			{
+				const _ty* r = cur.data() + k * len;
+				const std::size_t nr = count(l, k);
+				std::vector<_ty> q(nr);
+				for (std::size_t j = 2 * k; j < 2 * k + 2 && j < nodes(l - 1); ++j)
+				{
+					const std::size_t cj = count(l - 1, j);
+					_ty* dst = next.data() + j * half;
+					if (nr <= cj)
+						std::copy(r, r + nr, dst);
+					else
+					{
+						std::vector<_ty> t(r, r + nr);
+						convolution::divide(t.data(), nr, node(l - 1, j), cj + 1, q.data(), t.data(), inv[l - 1].empty() ? (nullptr) : (inv[l - 1].data() + j * half));
+						std::copy(t.begin(), t.begin() + cj, dst);
+					}
+				}
+			}, (len < 256) ? (256 / len) : (1));
+			cur.swap(next);
+		}
+	}
+
+public:
+	typedef _ty value_type;
+	/** creates an empty tree */
+	inline SubproductTree() : nthreads(1) {}
+	/** builds the tree over xs[0..n-1], the nodes of each level split over the given number of threads (0: one per hardware thread) */
+	inline SubproductTree(const _ty* xs, const std::size_t n, const unsigned int threads = 1) : nthreads(threads)
+	{
+		assign(xs, n);
+	}
+	inline SubproductTree(const std::vector<_ty>& xs, const unsigned int threads = 1) : nthreads(threads)
+	{
+		assign(xs.data(), xs.size());
+	}
+	inline ~SubproductTree() {}
+
+	/** replaces the points and rebuilds the tree */
+	inline SubproductTree<_ty>& assign(const _ty* xs, const std::size_t n)
+	{
+		order.resize(n);
+		subproduct::spread_order(xs, n, order.data(), std::integral_constant<int, convolution::fft_traits<_ty>::kind>());
+		x.resize(n);
+		for (std::size_t i = 0; i < n; ++i)
+			x[i] = xs[order[i]];
+		build();
+		return *this;
+	}
+	/** number of threads used by later operations (0: one per hardware thread) */
+	inline SubproductTree<_ty>& set_threads(const unsigned int threads)
+	{
+		nthreads = threads;
+		return *this;
+	}
+
+	/** ys[i] = f(x[i]) for all points */
+	inline void evaluate(const Polynomial<_ty>& f, _ty* ys) const
+	{
+		if (f.degree() < 0)
+		{
+			std::fill(ys, ys + x.size(), _ty(0));
+			return;
+		}
+		std::vector<_ty> v(x.size());
+		remainder_tree(&*f.begin(), f.degree() + 1, v.data());
+		for (std::size_t i = 0; i < x.size(); ++i)
+			ys[order[i]] = v[i];
+	}
+	inline std::vector<_ty> evaluate(const Polynomial<_ty>& f) const
+	{
+		std::vector<_ty> ys(x.size());
+		evaluate(f, ys.data());
+		return ys;
+	}
+
+	/**
+	 * the polynomial of degree < n through (x[i], ys[i]). Returns the largest backward error of the result at
+	 * subproduct::check_points() of the points, spread over the set: |pol(x) - y| relative to |y| plus the rounding
+	 * scale of Horner's scheme (see subproduct::backward_error()). It stays at a small multiple of the machine epsilon
+	 * for points spaced like the roots of unity; anything far above it means the tree has lost the interpolant (NaN if
+	 * it overflowed), and an O(n^2) method or wider arithmetic is needed.
+	 */
+	inline double interpolate(const _ty* ys, Polynomial<_ty>* pol) const
+	{
+		const std::size_t n = x.size();
+		pol->operator=(0);
+		if (n == 0)
+			return 0.0;
+		// level l holds sum_{i in node} c[i] * m_node(t)/(t - x[i]) at offset k*2^l, with count(l, k) coefficients
+		std::vector<_ty> cur(n), next(n);
+		for (std::size_t i = 0; i < n; ++i)
+			cur[i] = ys[order[i]] * w[i];
+		for (std::size_t l = 0; l + 1 < tree.size(); ++l)
+		{
+			const std::size_t len = std::size_t(1) << l;
+			parallel::for_each_index(nodes(l + 1), nthreads, [&](const std::size_t k)
+			{
+				const std::size_t a = 2 * k, b = 2 * k + 1;
+				_ty* dst = next.data() + a * len;
+				if (b >= nodes(l))
+				{
+					std::copy(cur.data() + a * len, cur.data() + a * len + count(l, a), dst);
+					return;
+				}
+				// r_a * m_b + r_b * m_a, both of length count(l, a) + count(l, b)
+				const std::size_t ca = count(l, a), cb = count(l, b);
+				std::vector<_ty> t(ca + cb);
+				convolution::multiply(cur.data() + a * len, ca, node(l, b), cb + 1, dst);
+				convolution::multiply(cur.data() + b * len, cb, node(l, a), ca + 1, t.data());
+				for (std::size_t i = 0; i < ca + cb; ++i)
+					dst[i] += t[i];
+			}, (len < 64) ? (64 / len) : (1));
+			cur.swap(next);
+		}
+		const std::size_t checks = (subproduct::check_points() < n) ? (subproduct::check_points()) : (n);
+		double error = 0.0;
+		for (std::size_t k = 0; k < checks; ++k)
+		{
+			// leaf order spreads the points, so every (n/checks)-th leaf samples the whole set
+			const std::size_t i = k * n / checks;
+			const double e = subproduct::backward_error(cur.data(), n, x[i], ys[order[i]]);
+			error = (e > error || e != e) ? (e) : (error);
+		}
+		pol->coefficients() = std::move(cur);
+		return error;
+	}
+	/** as above; the backward error is stored in *error if given */
+	inline Polynomial<_ty> interpolate(const std::vector<_ty>& ys, double* error = nullptr) const
+	{
+		Polynomial<_ty> res;
+		const double e = interpolate(ys.data(), &res);
+		if (error != nullptr)
+			*error = e;
+		return res;
+	}
+
+	/** m(t) = prod (t - x[i]) */
+	inline Polynomial<_ty> root() const
+	{
+		Polynomial<_ty> res = 1;
+		if (!x.empty())
+			res.coefficients().assign(node(tree.size() - 1, 0), node(tree.size() - 1, 0) + x.size() + 1);
+		return res;
+	}
+	inline std::size_t size() const { return x.size(); }
+};
+
+
+/** ys[i] = pol(xs[i]) for i < n through a subproduct tree, O(M(n) log n); worthwhile for large n with one-off point sets */
+template <typename _ty> void evaluate_multipoint(const Polynomial<_ty>& pol, const _ty* xs, _ty* ys, const std::size_t n, const unsigned int threads = 1)
+{
+	SubproductTree<_ty>(xs, n, threads).evaluate(pol, ys);
+}
+
+/**
+ * builds the interpolating polynomial through (x[j], y[j]) with a subproduct tree, O(M(n) log n); only accurate for
+ * points spaced like the roots of unity. Returns the backward error of the result, see SubproductTree::interpolate().
+ */
+template <typename _ty> double interpolate_subproduct(const _ty* x, const _ty* y, const std::size_t n, Polynomial<_ty>* pol, const unsigned int threads = 1)
+{
+	return SubproductTree<_ty>(x, n, threads).interpolate(y, pol);
+}
+
+typedef SubproductTree<double> subproduct_treed;
+
+#endif
@@ -34,7 +34,7 @@ public:
 	Vector();
 	Vector(int);
 	template <typename auxtype> Vector(std::initializer_list<auxtype>);
-	Vector(GENERIC_VECTOR&);
+	Vector(const GENERIC_VECTOR&);
 	/// destructor
 	virtual ~Vector();
 
@@ -121,7 +121,7 @@ inline Vector<dim, base_t>::Vector(std::initializer_list<auxtype> list)
 }
 /** Copy Contructor */
 template<unsigned int dim, typename base_t>
-inline Vector<dim, base_t>::Vector(GENERIC_VECTOR& v)
+inline Vector<dim, base_t>::Vector(const GENERIC_VECTOR& v)
 {
 	iterate comp[i] = v.get(i);
 }
@@ -365,7 +365,8 @@ inline base_t Vector<dim, base_t>::abs() const
 {
 	base_t res = 0.0;
 	iterate res += this->get(i)*this->get(i);
-	return std::sqrt(res);
+	using std::sqrt;
+	return sqrt(res);
 }
 /** Normalized vector */
 template<unsigned int dim, typename base_t>